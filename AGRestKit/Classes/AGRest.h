@@ -19,6 +19,9 @@ NS_ASSUME_NONNULL_BEGIN
 @protocol AGRestServerProtocol;
 @protocol AGRestResponseSerializerProtocol;
 @protocol AGRestLogging;
+@protocol AGRestMetricsCollecting;
+@class AGRestTrafficRecorder;
+@class AGRestCircuitBreaker;
 
 /*!
  @class AGRest
@@ -46,6 +49,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (void)initializeRestWithBaseUrl:(nonnull NSString *)baseUrl;
 
+/*!
+    @abstract Task of the module loading started by `+initializeRestWithBaseUrl:`.
+    @discussion Modules load in background and AGRest can be used right away: a module needed before the task completes
+    is created on the spot. Wait for the task to know when the whole stack, eventually queue included, is ready.
+    @return A BFTask completing once every module is loaded.
+ */
++ (BFTask *)initializationTask;
+
 ///-----------------------
 #pragma mark - Setter
 /// @name Setter
@@ -68,6 +79,17 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (void)setServerInstance:(nonnull id<AGRestServerProtocol>)server;
 
+/*!
+    @abstract Send the requests whose base url has the host of `baseUrl` through `server`, e.g. a CDN or another API host,
+    so that they don't queue behind the requests to the base url.
+    @discussion Requests to other hosts keep going through the server instance. Headers, like the session token,
+    are only set on the server instance.
+    @param server   The server instance for the host, see `[AGRestServer serverWithName:baseUrl:sessionConfiguration:maxConcurrentOperationCount:]`
+                    or `[AGRestSessionServer serverWithName:baseUrl:sessionConfiguration:]`.
+    @param baseUrl  A url of the host.
+ */
++ (void)addServerInstance:(nonnull id<AGRestServerProtocol>)server forBaseUrl:(nonnull NSString *)baseUrl;
+
 /*!
     @abstract Set a custom response serializer which conforms to `AGRestResponseSerializerProtocol` protocol.
     @param responseSerializer   The new response serializer.
@@ -80,6 +102,19 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (void)setLogger:(id<AGRestLogging>)logger;
 
+/*!
+ @abstract Set a custom metrics collector which conforms to `AGRestMetricsCollecting` protocol.
+ @param metrics  The new metrics collector.
+ */
++ (void)setMetrics:(nonnull id<AGRestMetricsCollecting>)metrics;
+
+/*!
+ @abstract Record every completed request and its response to a capture file, to replay them with AGRestTrafficReplayer.
+ @discussion Pass nil to stop recording, then close the recorder with `closeAsync`.
+ @param trafficRecorder The recorder, see `[AGRestTrafficRecorder recorderWithFilePath:error:]`.
+ */
++ (void)setTrafficRecorder:(nullable AGRestTrafficRecorder *)trafficRecorder;
+
 /*!
  @abstract Enable caching let AGRest's controllers cache requests, responses, files locally.
  Caching is enabled by default.
@@ -103,6 +138,34 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (void)setObjectMappingEnabled:(BOOL)enabled;
 
+/*!
+ @abstract Enable connection warm-up, so that initialization opens connections to the base url host and the given hosts
+ in background, and the first requests don't pay for DNS, TCP and TLS.
+ Connection warm-up is disabled by default.
+ @discussion Call it before `+initializeRestWithBaseUrl:`. Once initialized, enabling it warms up the connections right away.
+ The cost of each connection is logged, and recorded by the metrics collector as a HEAD request to its host.
+ @param enabled Bool flag.
+ @param hosts   Urls of additional hosts to connect to, e.g. a CDN. Their path is ignored.
+ */
++ (void)setConnectionWarmUpEnabled:(BOOL)enabled
+                   additionalHosts:(nullable NSArray<NSString *> *)hosts;
+
+/*!
+ @abstract Enable the circuit breaker, so that requests to an endpoint which keeps failing fail right away, without
+ taking an operation slot, until the endpoint recovers. Circuits are per host and endpoint.
+ The circuit breaker is disabled by default.
+ @discussion Timeouts, connection failures and 5xx responses count as failures. While the circuit of an endpoint is open,
+ its requests fail with `kAGErrorCircuitOpen` without being sent. Once `openInterval` elapsed, a trial request is sent,
+ and closes the circuit if it succeeds.
+ See `+circuitBreaker` for the other settings.
+ @param enabled             Bool flag.
+ @param failureThreshold    Consecutive failures opening the circuit of an endpoint.
+ @param openInterval        Time the circuit stays open before a trial request is sent, in seconds.
+ */
++ (void)setCircuitBreakerEnabled:(BOOL)enabled
+                failureThreshold:(NSUInteger)failureThreshold
+                    openInterval:(NSTimeInterval)openInterval;
+
 ///-----------------------
 #pragma mark - Getter
 /// @name Getter
@@ -122,6 +185,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (id<AGRestServerProtocol>)serverInstance;
 
+/*!
+    @return The server instance the requests to the host of `baseUrl` are sent through.
+ */
++ (id<AGRestServerProtocol>)serverInstanceForBaseUrl:(nullable NSString *)baseUrl;
+
 /*!
     @return The response serializer in use.
  */
@@ -132,6 +200,23 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (id<AGRestLogging>)logger;
 
+/*!
+    @return The metrics collector in use.
+ */
++ (id<AGRestMetricsCollecting>)metrics;
+
+/*!
+    @abstract Point-in-time copy of the request counters and latency histograms.
+    @discussion Cheap enough to be polled, see the `AGRestMetrics...Key` constants for its content.
+    @return The snapshot of the metrics collector in use.
+ */
++ (NSDictionary<NSString *, id> *)metricsSnapshot;
+
+/*!
+    @return The traffic recorder in use, nil if none.
+ */
++ (nullable AGRestTrafficRecorder *)trafficRecorder;
+
 /*!
     @return Whether caching is enabled.
  */
@@ -147,6 +232,29 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (BOOL)isObjectMappingEnabled;
 
+/*!
+    @return Whether connection warm-up is enabled.
+ */
++ (BOOL)isConnectionWarmUpEnabled;
+
+/*!
+    @return Whether the circuit breaker is enabled.
+ */
++ (BOOL)isCircuitBreakerEnabled;
+
+/*!
+    @abstract The circuit breaker of the request runner, to tune it or inspect the state of the circuits.
+    @return The circuit breaker in use.
+ */
++ (AGRestCircuitBreaker *)circuitBreaker;
+
+/*!
+    @abstract Task of the last connection warm-up, to wait for it or inspect its cost.
+    @return A BFTask resolving to an NSArray of AGRestResponse, one per host, whose trace holds the time spent in DNS lookup,
+    connection and TLS handshake. nil if no warm-up was started.
+ */
++ (nullable BFTask *)connectionWarmUpTask;
+
 ///-----------------------
 #pragma mark - Register Subclass
 /// @name Register Subclass
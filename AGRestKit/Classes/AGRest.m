@@ -15,6 +15,9 @@
 #import "AGRestSessionProtocol.h"
 #import "AGRestLogging.h"
 #import "AGRestLogger.h"
+#import "AGRestMetricsCollecting.h"
+#import "AGRestTrafficRecorder.h"
+#import "AGRestCircuitBreaker.h"
 
 @interface AGRest()
 
@@ -22,6 +25,8 @@
 
 + (id)performInternalSelector:(SEL)selector withObject:(id)object;
 
++ (void)_configureCircuitBreaker:(AGRestCircuitBreaker *)circuitBreaker;
+
 @end
 
 @implementation AGRest
@@ -30,6 +35,11 @@ static AGRestManager * _restManager = nil;
 static BOOL            _cachingEnabled;
 static BOOL            _loggingEnabled;
 static BOOL            _objectMappingEnabled;
+static BOOL            _connectionWarmUpEnabled;
+static NSArray         *_connectionWarmUpHosts;
+static BOOL            _circuitBreakerEnabled;
+static NSUInteger      _circuitBreakerFailureThreshold;
+static NSTimeInterval  _circuitBreakerOpenInterval;
 
 + (void)initialize {
     if (self == [AGRest class]) {
@@ -61,6 +71,9 @@ static BOOL            _objectMappingEnabled;
         // Configure global settings for AGRest here
         //-----------------------
         [_restManager.core setCachingEnabled:_cachingEnabled];
+        _restManager.connectionWarmUpEnabled = _connectionWarmUpEnabled;
+        _restManager.warmUpHosts = _connectionWarmUpHosts;
+        [self _configureCircuitBreaker:_restManager.circuitBreaker];
         
         //-----------------------
         // Load primary controllers
@@ -71,6 +84,10 @@ static BOOL            _objectMappingEnabled;
     }
 }
 
++ (BFTask *)initializationTask {
+    return [AGRest performInternalSelector:@selector(_initializationTask) withObject:nil];
+}
+
 + (nonnull NSString *)getRestBaseUrl {
     return [AGRest performInternalSelector:@selector(_getRestBaseUrl) withObject:nil];
 }
@@ -90,6 +107,15 @@ static BOOL            _objectMappingEnabled;
     [AGRest performInternalSelector:@selector(_setServerInstance:) withObject:server];
 }
 
++ (void)addServerInstance:(nonnull id<AGRestServerProtocol>)server forBaseUrl:(nonnull NSString *)baseUrl {
+    if (![[self class] didAGRestInitialized]) {
+        [NSException raise:NSInternalInconsistencyException format:@"'AGRest' should be initialized first calling +initializeRestWithBaseUrl"];
+    }
+    if (![_restManager addServer:server forBaseUrl:baseUrl]) {
+        AGRestLogWarn(@"<AGRest> Can't add server %@ for base url %@.", server, baseUrl);
+    }
+}
+
 + (void)setResponseSerializer:(nonnull id<AGRestResponseSerializerProtocol>)responseSerializer {
     [AGRest performInternalSelector:@selector(_setResponseSerializer:) withObject:responseSerializer];
 }
@@ -98,6 +124,18 @@ static BOOL            _objectMappingEnabled;
     [AGRest performInternalSelector:@selector(_setLogger:) withObject:logger];
 }
 
++ (void)setMetrics:(nonnull id<AGRestMetricsCollecting>)metrics {
+    [AGRest performInternalSelector:@selector(_setMetrics:) withObject:metrics];
+}
+
++ (void)setTrafficRecorder:(nullable AGRestTrafficRecorder *)trafficRecorder {
+    if (![[self class] didAGRestInitialized]) {
+        [NSException raise:NSInternalInconsistencyException format:@"'AGRest' should be initialized first calling +initializeRestWithBaseUrl"];
+    }
+    // Not through performInternalSelector, nil stops the capture
+    [_restManager setTrafficRecorder:trafficRecorder];
+}
+
 + (id<AGRestSessionProtocol>)sessionController {
     return [AGRest performInternalSelector:@selector(_sessionController) withObject:nil];
 }
@@ -106,6 +144,10 @@ static BOOL            _objectMappingEnabled;
     return [AGRest performInternalSelector:@selector(_serverInstance) withObject:nil];
 }
 
++ (id<AGRestServerProtocol>)serverInstanceForBaseUrl:(nullable NSString *)baseUrl {
+    return [AGRest performInternalSelector:@selector(_serverInstanceForBaseUrl:) withObject:baseUrl];
+}
+
 + (id<AGRestResponseSerializerProtocol>)responseSerializer {
     return [AGRest performInternalSelector:@selector(_responseSerializer) withObject:nil];
 }
@@ -114,6 +156,18 @@ static BOOL            _objectMappingEnabled;
     return [AGRest performInternalSelector:@selector(logger) withObject:nil];
 }
 
++ (id<AGRestMetricsCollecting>)metrics {
+    return [AGRest performInternalSelector:@selector(_metrics) withObject:nil];
+}
+
++ (NSDictionary<NSString *, id> *)metricsSnapshot {
+    return [[self metrics] snapshot];
+}
+
++ (AGRestTrafficRecorder *)trafficRecorder {
+    return [AGRest performInternalSelector:@selector(_trafficRecorder) withObject:nil];
+}
+
 #pragma mark - Configure
 #pragma mark -
 
@@ -147,6 +201,46 @@ static BOOL            _objectMappingEnabled;
     return _objectMappingEnabled;
 }
 
++ (void)setConnectionWarmUpEnabled:(BOOL)enabled additionalHosts:(nullable NSArray<NSString *> *)hosts {
+    _connectionWarmUpEnabled = enabled;
+    _connectionWarmUpHosts = [hosts copy];
+    if ([self didAGRestInitialized]) {
+        _restManager.connectionWarmUpEnabled = enabled;
+        _restManager.warmUpHosts = _connectionWarmUpHosts;
+        if (enabled) {
+            [_restManager warmUpConnections];
+        }
+    }
+}
+
++ (BOOL)isConnectionWarmUpEnabled {
+    return _connectionWarmUpEnabled;
+}
+
++ (void)setCircuitBreakerEnabled:(BOOL)enabled
+                failureThreshold:(NSUInteger)failureThreshold
+                    openInterval:(NSTimeInterval)openInterval
+{
+    _circuitBreakerEnabled = enabled;
+    _circuitBreakerFailureThreshold = failureThreshold;
+    _circuitBreakerOpenInterval = openInterval;
+    if ([self didAGRestInitialized]) {
+        [self _configureCircuitBreaker:_restManager.circuitBreaker];
+    }
+}
+
++ (BOOL)isCircuitBreakerEnabled {
+    return _circuitBreakerEnabled;
+}
+
++ (AGRestCircuitBreaker *)circuitBreaker {
+    return [AGRest performInternalSelector:@selector(_circuitBreaker) withObject:nil];
+}
+
++ (nullable BFTask *)connectionWarmUpTask {
+    return [AGRest performInternalSelector:@selector(_connectionWarmUpTask) withObject:nil];
+}
+
 #pragma mark - Register Subclass
 #pragma mark -
 
@@ -186,6 +280,10 @@ static BOOL            _objectMappingEnabled;
     return nil;
 }
 
++ (BFTask *)_initializationTask {
+    return [_restManager preloadTask];
+}
+
 + (NSString *)_getRestBaseUrl {
     return _restManager.baseUrl;
 }
@@ -210,6 +308,10 @@ static BOOL            _objectMappingEnabled;
     [_restManager setLogger:logger];
 }
 
++ (void)_setMetrics:(id<AGRestMetricsCollecting>)metrics {
+    [_restManager setMetrics:metrics];
+}
+
 + (id<AGRestSessionProtocol>)_sessionController {
     return [_restManager sessionController];
 }
@@ -218,6 +320,10 @@ static BOOL            _objectMappingEnabled;
     return [_restManager requestServer];
 }
 
++ (id<AGRestServerProtocol>)_serverInstanceForBaseUrl:(NSString *)baseUrl {
+    return [_restManager requestServerForBaseUrl:baseUrl];
+}
+
 + (id<AGRestResponseSerializerProtocol>)_responseSerializer {
     return [_restManager responseSerializer];
 }
@@ -226,6 +332,33 @@ static BOOL            _objectMappingEnabled;
     return [_restManager logger];
 }
 
++ (id<AGRestMetricsCollecting>)_metrics {
+    return [_restManager metrics];
+}
+
++ (AGRestTrafficRecorder *)_trafficRecorder {
+    return [_restManager trafficRecorder];
+}
+
++ (AGRestCircuitBreaker *)_circuitBreaker {
+    return [_restManager circuitBreaker];
+}
+
+// Thresholds left to 0 keep the defaults of the circuit breaker.
++ (void)_configureCircuitBreaker:(AGRestCircuitBreaker *)circuitBreaker {
+    if (_circuitBreakerFailureThreshold) {
+        circuitBreaker.failureThreshold = _circuitBreakerFailureThreshold;
+    }
+    if (_circuitBreakerOpenInterval > 0) {
+        circuitBreaker.openInterval = _circuitBreakerOpenInterval;
+    }
+    circuitBreaker.enabled = _circuitBreakerEnabled;
+}
+
++ (BFTask *)_connectionWarmUpTask {
+    return [_restManager connectionWarmUpTask];
+}
+
 + (NSNumber *)_registerSubclass:(nonnull Class)newModelClass {
     BOOL isClassRegistered = [[_restManager objectMapper] registerSubclass:newModelClass];
     return @(isClassRegistered);
@@ -54,6 +54,56 @@ extern NSString *const _Nonnull AGRestSessionStoreSessionTokenKey;
  */
 extern NSString *const _Nonnull AGRestSessionStoreCurrentUserKey;
 
+///-----------------------
+#pragma mark - Metrics Snapshot Keys
+/// @name Metrics snapshot keys
+///-----------------------
+/*!
+ *  Number of requests completed, as a NSNumber.
+ */
+extern NSString *const _Nonnull AGRestMetricsRequestCountKey;
+/*!
+ *  Number of attempts retried by the request runner, as a NSNumber.
+ */
+extern NSString *const _Nonnull AGRestMetricsRetryCountKey;
+/*!
+ *  Number of requests served from the cache, as a NSNumber.
+ */
+extern NSString *const _Nonnull AGRestMetricsCacheHitCountKey;
+/*!
+ *  Number of cache lookups that fell back to the network, as a NSNumber.
+ */
+extern NSString *const _Nonnull AGRestMetricsCacheMissCountKey;
+/*!
+ *  Cache hits over cache lookups, between 0 and 1, as a NSNumber. Absent until a cache lookup was recorded.
+ */
+extern NSString *const _Nonnull AGRestMetricsCacheHitRatioKey;
+/*!
+ *  Number of requests waiting in the eventually queue, as a NSNumber.
+ */
+extern NSString *const _Nonnull AGRestMetricsEventuallyQueueDepthKey;
+/*!
+ *  Number of operations queued or running on the file manager I/O executor, as a NSNumber.
+ */
+extern NSString *const _Nonnull AGRestMetricsIOQueueDepthKey;
+/*!
+ *  Number of requests failed without being sent because the circuit of their endpoint was open, as a NSNumber.
+ */
+extern NSString *const _Nonnull AGRestMetricsCircuitBreakerRejectionCountKey;
+/*!
+ *  Latency histograms, as a NSDictionary keyed by "<METHOD> <endpoint> <status class>" (e.g. "GET users/:id 2xx",
+ *  or "GET users/:id error" when no response was received). Endpoints are normalized with
+ *  `+[AGRestRequest normalizedEndPoint:]`.
+ *  Each value is a NSDictionary using the `AGRestMetricsLatency...Key` keys, durations in milliseconds.
+ */
+extern NSString *const _Nonnull AGRestMetricsLatencyKey;
+extern NSString *const _Nonnull AGRestMetricsLatencyCountKey;
+extern NSString *const _Nonnull AGRestMetricsLatencyMeanKey;
+extern NSString *const _Nonnull AGRestMetricsLatencyMaxKey;
+extern NSString *const _Nonnull AGRestMetricsLatencyP50Key;
+extern NSString *const _Nonnull AGRestMetricsLatencyP90Key;
+extern NSString *const _Nonnull AGRestMetricsLatencyP99Key;
+
 ///-----------------------
 #pragma mark - Notification Definitions
 /// @name Notifications
@@ -126,6 +176,10 @@ typedef NS_ENUM(NSInteger, AGRestErrorCode) {
      @abstract The Apple server response is not valid.
      */
     kAGErrorInvalidServerResponse = 109,
+    /*!
+     @abstract The circuit breaker of the endpoint is open, the request wasn't sent.
+     */
+    kAGErrorCircuitOpen = 110,
     /*!
      @abstract Username is missing or empty.
      */
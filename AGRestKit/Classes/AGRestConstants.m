@@ -14,3 +14,19 @@ NSString *const _Nonnull AGRestSessionTokenExtractionKey    = @"Authorization";
 NSString *const _Nonnull AGRestSessionStoreSessionTokenKey  = @"x_auth_token_key";
 NSString *const _Nonnull AGRestSessionStoreCurrentUserKey   = @"x_auth_user_key";
 NSString *const _Nonnull AGRestReachabilityStatusChanged    = @"com.agrest.reachabilityStatusNotification";
+
+NSString *const _Nonnull AGRestMetricsRequestCountKey           = @"requests";
+NSString *const _Nonnull AGRestMetricsRetryCountKey             = @"retries";
+NSString *const _Nonnull AGRestMetricsCacheHitCountKey          = @"cacheHits";
+NSString *const _Nonnull AGRestMetricsCacheMissCountKey         = @"cacheMisses";
+NSString *const _Nonnull AGRestMetricsCacheHitRatioKey          = @"cacheHitRatio";
+NSString *const _Nonnull AGRestMetricsEventuallyQueueDepthKey   = @"eventuallyQueueDepth";
+NSString *const _Nonnull AGRestMetricsIOQueueDepthKey           = @"ioQueueDepth";
+NSString *const _Nonnull AGRestMetricsCircuitBreakerRejectionCountKey = @"circuitBreakerRejections";
+NSString *const _Nonnull AGRestMetricsLatencyKey                = @"latency";
+NSString *const _Nonnull AGRestMetricsLatencyCountKey           = @"count";
+NSString *const _Nonnull AGRestMetricsLatencyMeanKey            = @"mean";
+NSString *const _Nonnull AGRestMetricsLatencyMaxKey             = @"max";
+NSString *const _Nonnull AGRestMetricsLatencyP50Key             = @"p50";
+NSString *const _Nonnull AGRestMetricsLatencyP90Key             = @"p90";
+NSString *const _Nonnull AGRestMetricsLatencyP99Key             = @"p99";
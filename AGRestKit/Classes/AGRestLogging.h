@@ -10,6 +10,8 @@
 
 #import "AGRestConstants.h"
 
+@class AGRestRequestTrace;
+
 /*!
  @protocol AGRestLogging
  @discussion The AGRestLoggin protocol defines base methods for logging any warnings, errors, crash that could occurs
@@ -31,4 +33,21 @@
  */
 - (void)log:(AGRestLoggingLevel)logLevel message:(NSString *)message, ... NS_FORMAT_FUNCTION(2, 3);
 
+@optional
+
+/*!
+ @abstract Whether messages with the given level would be logged.
+ @discussion The AGRestLog macros check it before evaluating the message arguments, so that
+ messages below the active level cost nothing to build.
+ @param logLevel    AGRestLoggingLevel to check.
+ @return YES if messages with this level are logged.
+ */
+- (BOOL)isLoggingLevelEnabled:(AGRestLoggingLevel)logLevel;
+
+/*!
+ @abstract Called once a request completed, with the time it spent in each phase of its lifecycle.
+ @param trace   The AGRestRequestTrace of the completed request.
+ */
+- (void)logTrace:(AGRestRequestTrace *)trace;
+
 @end
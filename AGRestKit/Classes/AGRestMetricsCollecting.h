@@ -0,0 +1,88 @@
+//
+//  AGRestMetricsCollecting.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 02/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "AGRestConstants.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @protocol AGRestMetricsCollecting
+ @discussion The AGRestMetricsCollecting protocol defines the counters and latency histograms the framework feeds
+ while running requests. Recording methods are called on the request hot path and must not block.
+ */
+@protocol AGRestMetricsCollecting <NSObject>
+
+///--------------------------------------
+/// @name Recording
+///--------------------------------------
+
+/*!
+ @abstract Record a completed request into the latency histogram of its endpoint and status class.
+ @param method      The HTTP method of the request, e.g. "GET".
+ @param endpoint    The endpoint of the request.
+ @param statusCode  The HTTP status code of the response, or 0 if no response was received.
+ @param duration    Time between the submission of the request and its completion.
+ */
+- (void)recordRequestWithMethod:(nullable NSString *)method
+                       endpoint:(nullable NSString *)endpoint
+                     statusCode:(NSInteger)statusCode
+                       duration:(NSTimeInterval)duration;
+
+/*!
+ @abstract Record a request attempt retried by the request runner.
+ */
+- (void)recordRetry;
+
+/*!
+ @abstract Record a request served from the cache.
+ */
+- (void)recordCacheHit;
+
+/*!
+ @abstract Record a cache lookup that fell back to the network.
+ */
+- (void)recordCacheMiss;
+
+/*!
+ @abstract Record a request failed by the request runner without being sent, because the circuit of its endpoint was open.
+ */
+- (void)recordCircuitBreakerRejection;
+
+/*!
+ @abstract Record the number of requests currently waiting in the eventually queue.
+ @param depth   The number of pending requests.
+ */
+- (void)recordEventuallyQueueDepth:(NSUInteger)depth;
+
+/*!
+ @abstract Record the number of operations queued or running on the file manager I/O executor.
+ @param depth   The number of operations.
+ */
+- (void)recordIOQueueDepth:(NSUInteger)depth;
+
+///--------------------------------------
+/// @name Reading
+///--------------------------------------
+
+/*!
+ @abstract Point-in-time copy of all the counters and histograms.
+ @discussion See the `AGRestMetrics...Key` constants for the content of the dictionary.
+ @return A NSDictionary safe to keep and to serialize as JSON.
+ */
+- (NSDictionary<NSString *, id> *)snapshot;
+
+/*!
+ @abstract Clear all the counters and histograms.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
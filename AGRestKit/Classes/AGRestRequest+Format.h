@@ -30,4 +30,13 @@
  */
 - (NSMutableURLRequest *)mutableUrlRequest;
 
+/*!
+ @abstract Endpoint template shared by all the requests to the same resource, e.g. "users/:id/posts" for "users/42/posts?page=2".
+ @discussion The query string and fragment are dropped, and numeric, UUID and long hexadecimal path segments are
+ replaced with ":id". Used to aggregate requests per endpoint without a key per resource.
+ @param endPoint    The endpoint of a request.
+ @return The normalized endpoint.
+ */
++ (NSString *)normalizedEndPoint:(NSString *)endPoint;
+
 @end
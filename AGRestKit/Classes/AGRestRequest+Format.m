@@ -77,4 +77,62 @@
     return request;
 }
 
++ (NSString *)normalizedEndPoint:(NSString *)endPoint {
+    if (!endPoint.length) {
+        return @"";
+    }
+    // Called for each recorded request, the sets are built once.
+    static NSCharacterSet *queryStart = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queryStart = [NSCharacterSet characterSetWithCharactersInString:@"?#"];
+    });
+    NSRange range = [endPoint rangeOfCharacterFromSet:queryStart];
+    NSString *path = (range.location != NSNotFound) ? [endPoint substringToIndex:range.location] : endPoint;
+    
+    // Segments are checked in place, the path is only copied if one of them is an identifier.
+    NSMutableString *normalizedPath = nil;
+    NSUInteger length = path.length;
+    NSUInteger segmentStart = 0;
+    NSUInteger copiedLength = 0;
+    while (segmentStart <= length) {
+        NSRange separator = [path rangeOfString:@"/" options:NSLiteralSearch range:NSMakeRange(segmentStart, length - segmentStart)];
+        NSUInteger segmentEnd = (separator.location != NSNotFound) ? separator.location : length;
+        NSRange segmentRange = NSMakeRange(segmentStart, segmentEnd - segmentStart);
+        if ([self _isIdentifierInPath:path range:segmentRange]) {
+            normalizedPath = normalizedPath ?: [NSMutableString stringWithCapacity:length];
+            [normalizedPath appendString:[path substringWithRange:NSMakeRange(copiedLength, segmentStart - copiedLength)]];
+            [normalizedPath appendString:@":id"];
+            copiedLength = segmentEnd;
+        }
+        segmentStart = segmentEnd + 1;
+    }
+    if (!normalizedPath) {
+        return path;
+    }
+    [normalizedPath appendString:[path substringFromIndex:copiedLength]];
+    return normalizedPath;
+}
+
++ (BOOL)_isIdentifierInPath:(NSString *)path range:(NSRange)range {
+    if (!range.length) {
+        return NO;
+    }
+    static NSCharacterSet *nonDigits = nil;
+    static NSCharacterSet *nonHexDigits = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        nonDigits = [[NSCharacterSet decimalDigitCharacterSet] invertedSet];
+        nonHexDigits = [[NSCharacterSet characterSetWithCharactersInString:@"0123456789abcdefABCDEF"] invertedSet];
+    });
+    if ([path rangeOfCharacterFromSet:nonDigits options:0 range:range].location == NSNotFound) {
+        return YES;
+    }
+    if (range.length == 36 && [[NSUUID alloc] initWithUUIDString:[path substringWithRange:range]]) {
+        return YES;
+    }
+    // Object ids and hashes.
+    return (range.length >= 16 && [path rangeOfCharacterFromSet:nonHexDigits options:0 range:range].location == NSNotFound);
+}
+
 @end
@@ -65,6 +65,11 @@ typedef NS_ENUM(NSInteger, AGRestRequestTimeoutPolicy) {
 
 @class BFTask;
 
+/*!
+ @abstract Default time the synchronous send methods wait for a response before failing with kAGErrorTimeout.
+ */
+extern NSTimeInterval const AGRestRequestDefaultSynchronousTimeout;
+
 /*!
  @class AGRestRequest
  @discussion The AGRestRequest class represents a REST API Request and provide all informations for executing complex HTTP request on the server.
@@ -280,23 +285,33 @@ typedef NS_ENUM(NSInteger, AGRestRequestTimeoutPolicy) {
 // Sync
 
 /*!
- @abstract Send the request synchronously.
- @return On-going BFTask. BFTask _result_ is set with AGRestResponse instance.
+ @abstract Send the request synchronously, waiting at most `AGRestRequestDefaultSynchronousTimeout`.
+ @discussion This never blocks the main thread: called from it, the returned task fails with kAGErrorOperationForbidden.
+ Use `sendRequestInBackground` there instead, it returns the same results without blocking.
+ @return Completed BFTask. BFTask _result_ is set with AGRestResponse instance, or _error_ is set.
  */
 - (nullable BFTask *)sendRequest;
 
 /*!
- @abstract Send the request synchronously.
- @param completionBlock     The block to execute when the synchronous request is complete.
+ @abstract Send the request synchronously, waiting at most `timeout` seconds.
+ @discussion Fails with kAGErrorOperationForbidden when called from the main thread, and with kAGErrorTimeout
+ (cancelling the request) when no response arrived in time. The task is cancelled if the request was.
+ @param timeout     Maximum time to wait for the response.
+ @return Completed BFTask. BFTask _result_ is set with AGRestResponse instance, or _error_ is set.
+ */
+- (nullable BFTask *)sendRequestWithTimeout:(NSTimeInterval)timeout;
+
+/*!
+ @abstract Send the request without blocking the calling thread.
+ @param completionBlock     The block to execute on the main thread when the request is complete.
                             It should have this signature : ^(AGRestResponse * _Nonnull response).
  */
 - (void)sendRequestWithBlock:(nullable AGRestRequestResultBlock)completionBlock;
 
 /*!
- @abstract Send the request synchronously.
+ @abstract Send the request without blocking the calling thread.
  @param target      The target object for the selector.
- @param aSelector   The selector to call on the target when the synchronous request is complete.
- @return
+ @param aSelector   The selector to call on the target, on the main thread, when the request is complete.
  */
 - (void)sendRequestWithTarget:(nonnull id)target selector:(nonnull SEL)aSelector;
 
@@ -328,25 +343,34 @@ typedef NS_ENUM(NSInteger, AGRestRequestTimeoutPolicy) {
 ///-----------------------
 
 /*!
- @abstract Send a batch of AGRestRequest synchronously.
+ @abstract Send a batch of AGRestRequest synchronously, waiting at most `AGRestRequestDefaultSynchronousTimeout`.
+ @discussion Like `sendRequest`, this never blocks the main thread. Use `sendBatchedRequestsInBackground:` there instead.
  @param requests    NSArray of AGRestRequest.
- @return On-going BFTask. BFTask _result_ is set with NSArray of AGRestResponse instances.
+ @return Completed BFTask. BFTask _result_ is set with NSArray of AGRestResponse instances, or _error_ is set.
  */
 + (nullable BFTask *)sendBatchedRequests:(nonnull NSArray *)requests;
 
 /*!
- @abstract Send a batch of AGRestRequest synchronously.
+ @abstract Send a batch of AGRestRequest synchronously, waiting at most `timeout` seconds.
+ @param requests    NSArray of AGRestRequest.
+ @param timeout     Maximum time to wait for all the responses.
+ @return Completed BFTask. BFTask _result_ is set with NSArray of AGRestResponse instances, or _error_ is set.
+ */
++ (nullable BFTask *)sendBatchedRequests:(nonnull NSArray *)requests withTimeout:(NSTimeInterval)timeout;
+
+/*!
+ @abstract Send a batch of AGRestRequest without blocking the calling thread.
  @param requests        NSArray of AGRestRequest.
- @param completionBlock The block to execute when all the synchronous requests are complete.
+ @param completionBlock The block to execute on the main thread when all the requests are complete.
                         It should have this signature : ^(AGRestResponse * _Nonnull response).
  */
 + (void)sendBatchedRequests:(nonnull NSArray *)requests withCompletionBlock:(nullable AGRestBatchResponseCompletionBlock)completionBlock;
 
 /*!
- @abstract Send a batch of AGRestRequest synchronously.
+ @abstract Send a batch of AGRestRequest without blocking the calling thread.
  @param requests    NSArray of AGRestRequest.
  @param target      The target object for the selector.
- @param aSelector   The selector to call on the target when the all the synchronous requests are complete.
+ @param aSelector   The selector to call on the target, on the main thread, when the all the requests are complete.
  */
 + (void)sendBatchedRequests:(nonnull NSArray *)requests withTarget:(nonnull id)target selector:(nonnull SEL)aSelector;
 
@@ -17,6 +17,7 @@
 #import "AGRestCore.h"
 #import "AGRestRequestController.h"
 #import "AGRestLogger.h"
+#import "AGRestErrorUtilities.h"
 
 static NSString * const kAGRequestBaseUrlKey        = @"baseu-rl";
 static NSString * const kAGRequestEndpointKey       = @"endpoint";
@@ -31,6 +32,8 @@ static NSString * const kAGRequestBodyKey           = @"body";
 static NSString * const kAGRequestDataKey           = @"data";
 static NSString * const kAGRequestTargetClass       = @"targetClass";
 
+NSTimeInterval const AGRestRequestDefaultSynchronousTimeout = 60.0;
+
 @interface AGRestRequest()
 
 @property (strong) NSMutableDictionary          *headers_;
@@ -74,7 +77,7 @@ static NSString * const kAGRequestTargetClass       = @"targetClass";
         self.body_              = [dictionary objectForKey:kAGRequestBodyKey];
         self.data_              = [dictionary objectForKey:kAGRequestDataKey];
         self.requestIdentifier  = [dictionary objectForKey:kAGRequestIdentifierKey];
-        self.cachePolicy        = [[dictionary objectForKey:kAGRequestIdentifierKey] integerValue];
+        self.cachePolicy        = [[dictionary objectForKey:kAGRequestCachePolicyKey] integerValue];
         self.timeoutPolicy      = [[dictionary objectForKey:kAGRequestTimeoutPolicyKey] integerValue];
         self.httpMethod         = [[dictionary objectForKey:kAGRequestHTTPMethodKey] integerValue];
         self.retryCount         = [[dictionary objectForKey:kAGRequestRetryCountKey] integerValue];
@@ -93,7 +96,7 @@ static NSString * const kAGRequestTargetClass       = @"targetClass";
     selfRepresentation[kAGRequestBodyKey]          = self.body_;
     selfRepresentation[kAGRequestDataKey]          = self.data_;
     selfRepresentation[kAGRequestIdentifierKey]    = self.requestIdentifier;
-    selfRepresentation[kAGRequestIdentifierKey]    = @(self.cachePolicy);
+    selfRepresentation[kAGRequestCachePolicyKey]   = @(self.cachePolicy);
     selfRepresentation[kAGRequestTimeoutPolicyKey] = @(self.timeoutPolicy);
     selfRepresentation[kAGRequestHTTPMethodKey]    = @(self.httpMethod);
     selfRepresentation[kAGRequestRetryCountKey]    = @(self.retryCount);
@@ -328,6 +331,8 @@ static NSString * const kAGRequestTargetClass       = @"targetClass";
 
 - (void)setValue:(nonnull NSString *)value forHTTPHeaderField:(nonnull NSString *)key {
     [self.headers_ setObject:value forKey:key];
+    // The prepared request of the template doesn't have this header.
+    self.requestTemplate = nil;
 }
 
 #pragma mark - send Data
@@ -336,45 +341,23 @@ static NSString * const kAGRequestTargetClass       = @"targetClass";
 #pragma mark Single Request
 
 - (nullable BFTask *)sendRequest {
-    if (!_cancellationSource) {
-        BFTaskCompletionSource *taskCompletion = [BFTaskCompletionSource taskCompletionSource];
-        [[self sendRequestInBackground] continueWithBlock:^id(BFTask *task) {
-            if (!task.result) {
-                [taskCompletion setError:task.error];
-            } else {
-                [taskCompletion setResult:task.result];
-            }
-            return nil;
-        } cancellationToken:_cancellationSource.token];
-        [taskCompletion.task waitUntilFinished];
-        return taskCompletion.task;
-    }
-    return nil;
+    return [self sendRequestWithTimeout:AGRestRequestDefaultSynchronousTimeout];
+}
+
+- (nullable BFTask *)sendRequestWithTimeout:(NSTimeInterval)timeout {
+    return [[self class] _sendSynchronouslyWithTimeout:timeout taskBlock:^BFTask *{
+        return [self sendRequestInBackground];
+    } cancellationBlock:^{
+        [self cancel];
+    }];
 }
 
 - (void)sendRequestWithBlock:(nullable AGRestRequestResultBlock)completionBlock {
-    [[self sendRequest] continueWithBlock:^id(BFTask *task)
-     {
-         if (!task.isCancelled) {
-             dispatch_async(dispatch_get_main_queue(), ^{
-                 completionBlock(task.result);
-             });
-         }
-         return nil;
-     }];
+    [self sendRequestInBackgroundWithBlock:completionBlock];
 }
 
 - (void)sendRequestWithTarget:(nonnull id)target selector:(nonnull SEL)aSelector {
-    if (target && [target respondsToSelector:aSelector]) {
-        weakify(target);
-        [[self sendRequest] continueWithBlock:^id(BFTask *task) {
-            strongify(target);
-            if (strongSelf && !task.isCancelled && target) {
-                [strongSelf performSelectorOnMainThread:aSelector withObject:task.result waitUntilDone:YES];
-            }
-            return nil;
-        }];
-    }
+    [self sendRequestInBackrgoundWithTarget:target selector:aSelector];
 }
 
 - (BFTask *)sendRequestInBackground {
@@ -452,41 +435,27 @@ static NSString * const kAGRequestTargetClass       = @"targetClass";
 #pragma mark - Batched Requests
 
 + (nullable BFTask *)sendBatchedRequests:(nonnull NSArray *)requests {
-    if (requests && requests.count) {
-        BFTaskCompletionSource *taskCompletion = [BFTaskCompletionSource taskCompletionSource];
-        [[AGRestRequest sendBatchedRequestsInBackground:requests] continueWithBlock:^id(BFTask *task) {
-            [taskCompletion setResult:task.result];
-            return nil;
-        }];
-        [taskCompletion.task waitUntilFinished];
-        return taskCompletion.task;
-    }
-    return nil;
+    return [[self class] sendBatchedRequests:requests withTimeout:AGRestRequestDefaultSynchronousTimeout];
+}
+
++ (nullable BFTask *)sendBatchedRequests:(nonnull NSArray *)requests withTimeout:(NSTimeInterval)timeout {
+    return [[self class] _sendSynchronouslyWithTimeout:timeout taskBlock:^BFTask *{
+        return [AGRestRequest sendBatchedRequestsInBackground:requests];
+    } cancellationBlock:^{
+        for (id request in requests) {
+            if ([request isKindOfClass:[AGRestRequest class]]) {
+                [(AGRestRequest *)request cancel];
+            }
+        }
+    }];
 }
 
 + (void)sendBatchedRequests:(nonnull NSArray *)requests withCompletionBlock:(nullable AGRestBatchResponseCompletionBlock)completionBlock {
-    [[[self class] sendBatchedRequests:requests] continueWithBlock:^id(BFTask *task)
-     {
-         if (!task.isCancelled && completionBlock) {
-             dispatch_async(dispatch_get_main_queue(), ^{
-                 completionBlock(task.result);
-             });
-         }
-         return nil;
-     }];
+    [[self class] sendBatchedRequestsInBackground:requests withCompletionBlock:completionBlock];
 }
 
 + (void)sendBatchedRequests:(nonnull NSArray *)requests withTarget:(nonnull id)target selector:(nonnull SEL)aSelector {
-    if (target && [target respondsToSelector:aSelector]) {
-        weakify(target);
-        [[[self class] sendBatchedRequests:requests] continueWithBlock:^id(BFTask *task) {
-            strongify(weakSelf);
-            if (strongSelf && !task.cancelled) {
-                [strongSelf performSelectorOnMainThread:aSelector withObject:task.result waitUntilDone:YES];
-            }
-            return nil;
-        }];
-    }
+    [[self class] sendBatchedRequestsInBackground:requests withTarget:target selector:aSelector];
 }
 
 + (nullable BFTask *)sendBatchedRequestsInBackground:(nonnull NSArray *)requests {
@@ -558,6 +527,31 @@ static NSString * const kAGRequestTargetClass       = @"targetClass";
     }
 }
 
++ (nullable BFTask *)_sendSynchronouslyWithTimeout:(NSTimeInterval)timeout
+                                         taskBlock:(BFTask * _Nullable (^)(void))taskBlock
+                                 cancellationBlock:(dispatch_block_t)cancellationBlock
+{
+    if ([NSThread isMainThread]) {
+        // Refuse before sending anything, the response would never be seen.
+        return [BFTask taskWithError:[AGRestErrorUtilities errorWithCode:kAGErrorOperationForbidden
+                                                                 message:@"Synchronous requests can't be sent from the main thread. Use the asynchronous API instead."]];
+    }
+    BFTask *task = taskBlock();
+    if (!task) {
+        return nil;
+    }
+    
+    NSError *error = nil;
+    [task waitForResult:&error timeout:timeout];
+    if (task.completed) {
+        // Result, error or cancellation, as is.
+        return task;
+    }
+    // Nobody is waiting on it anymore.
+    cancellationBlock();
+    return [BFTask taskWithError:error];
+}
+
 + (AGRestRequestController *)_requestController {
     return [AGRest _currentManager].core.requestController;
 }
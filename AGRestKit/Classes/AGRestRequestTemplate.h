@@ -0,0 +1,78 @@
+//
+//  AGRestRequestTemplate.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 04/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "AGRestRequest.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class AGRestRequestTemplate
+
+ @discussion The AGRestRequestTemplate class describes the fixed part of the requests sent to a frequently called endpoint.
+
+ The first time one of its requests is sent, the server resolves the url against its base url, merges its own headers with
+ the template headers, and encodes the template body, once. Each request then only encodes its own parameters and appends
+ them to the prepared url or body.
+
+ The prepared request is built again whenever the server headers change, e.g. when the session token is set.
+ Requests of a template behave like any other AGRestRequest otherwise: they can be cached, retried or sent eventually.
+
+    AGRestRequestTemplate *template = [AGRestRequestTemplate templateWithMethod:AGRestRequestMethodHttpPOST
+                                                                       endPoint:@"events"
+                                                                        headers:nil
+                                                                           body:@{@"platform": @"ios"}];
+    [[template requestWithParameters:@{@"name": @"open"}] sendRequestInBackground];
+ */
+@interface AGRestRequestTemplate : NSObject
+
+/*!
+ @abstract The HTTP method of the requests.
+ */
+@property (nonatomic, assign, readonly) AGRestRequestHTTPMethod httpMethod;
+/*!
+ @abstract The endpoint of the requests, relative to the server base url.
+ */
+@property (nonatomic, copy, readonly) NSString                  *endPoint;
+/*!
+ @abstract HTTP header fields sent with every request, in addition to the server ones.
+ */
+@property (nonatomic, copy, readonly, nullable) NSDictionary    *headers;
+/*!
+ @abstract Parameters sent with every request, in the query string or in the JSON body depending on the HTTP method.
+ */
+@property (nonatomic, copy, readonly, nullable) NSDictionary    *body;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Returns a new template.
+ @param method      The HTTP method.
+ @param endPoint    The endpoint.
+ @param headers     The headers common to all the requests.
+ @param body        The parameters common to all the requests.
+ @return An initialized instance of AGRestRequestTemplate.
+ */
++ (instancetype)templateWithMethod:(AGRestRequestHTTPMethod)method
+                          endPoint:(NSString *)endPoint
+                           headers:(nullable NSDictionary *)headers
+                              body:(nullable NSDictionary *)body;
+
+/*!
+ @abstract Returns a new request of the template.
+ @discussion Parameters with the same key as a template body parameter override it, but cost a full encoding of the body.
+ Changing the endpoint, method or headers of the returned request makes it a regular request.
+ @param parameters  The parameters specific to the request.
+ @return An initialized instance of AGRestRequest.
+ */
+- (AGRestRequest *)requestWithParameters:(nullable NSDictionary *)parameters;
+
+@end
+
+NS_ASSUME_NONNULL_END
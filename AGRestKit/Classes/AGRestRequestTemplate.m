@@ -0,0 +1,220 @@
+//
+//  AGRestRequestTemplate.m
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 04/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestRequestTemplate.h"
+#import "AGRestRequestTemplate_Private.h"
+
+#import <pthread.h>
+#import <AFNetworking/AFURLRequestSerialization.h>
+
+#import "AGRest.h"
+#import "AGRestRequest_Private.h"
+#import "AGRestRequest+Format.h"
+
+// The serializer never sees the body of a template request: set the header AFJSONRequestSerializer would, unless already set.
+static void _AGRestRequestTemplateSetJSONContentType(NSMutableURLRequest *request) {
+    if (![request valueForHTTPHeaderField:@"Content-Type"]) {
+        [request setValue:@"application/json" forHTTPHeaderField:@"Content-Type"];
+    }
+}
+
+@interface AGRestRequestTemplate () {
+    pthread_mutex_t _preparationMutex;
+
+    // Request prepared for `_preparedBaseURL` and `_preparedHeadersVersion`, nil until the first request is sent.
+    NSURLRequest    *_preparedRequest;
+    NSURL           *_preparedBaseURL;
+    NSUInteger      _preparedHeadersVersion;
+    // Template body, encoded in the url of `_preparedRequest` or here as JSON depending on the HTTP method.
+    NSData          *_preparedBody;
+    BOOL            _encodesParametersInURI;
+}
+
+@property (nonatomic, assign, readwrite) AGRestRequestHTTPMethod httpMethod;
+@property (nonatomic, copy, readwrite) NSString                 *endPoint;
+@property (nonatomic, copy, readwrite) NSDictionary             *headers;
+@property (nonatomic, copy, readwrite) NSDictionary             *body;
+@property (nonatomic, copy) NSString                            *httpMethodString;
+
+@end
+
+@implementation AGRestRequestTemplate
+
+#pragma mark - Init
+#pragma mark -
+
++ (instancetype)templateWithMethod:(AGRestRequestHTTPMethod)method
+                          endPoint:(NSString *)endPoint
+                           headers:(nullable NSDictionary *)headers
+                              body:(nullable NSDictionary *)body
+{
+    AGRestRequestTemplate *template = [[AGRestRequestTemplate alloc] _init];
+    template.httpMethod = method;
+    template.endPoint = endPoint;
+    template.headers = headers;
+    template.body = body;
+    template.httpMethodString = [[AGRestRequest requestWithMethod:method url:@"" endPoint:endPoint headers:nil body:nil] httpMethodString];
+    return template;
+}
+
+- (instancetype)_init {
+    self = [super init];
+    if (!self) return nil;
+
+    pthread_mutex_init(&_preparationMutex, NULL);
+
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_preparationMutex);
+}
+
+#pragma mark - Requests
+#pragma mark -
+
+- (AGRestRequest *)requestWithParameters:(nullable NSDictionary *)parameters {
+    // The full body is kept on the request, for the cache and the eventually queue.
+    NSDictionary *body = self.body;
+    if (parameters.count) {
+        NSMutableDictionary *mergedBody = [NSMutableDictionary dictionaryWithCapacity:body.count + parameters.count];
+        [mergedBody addEntriesFromDictionary:body];
+        [mergedBody addEntriesFromDictionary:parameters];
+        body = mergedBody;
+    }
+
+    AGRestRequest *request = [AGRestRequest requestWithMethod:self.httpMethod
+                                                          url:[AGRest getRestBaseUrl]
+                                                     endPoint:self.endPoint
+                                                      headers:self.headers
+                                                         body:body];
+    request.requestTemplate = self;
+    request.templateParameters = parameters;
+    return request;
+}
+
+- (nullable NSMutableURLRequest *)_URLRequestWithParameters:(nullable NSDictionary *)parameters
+                                                    baseURL:(nullable NSURL *)baseURL
+                                          requestSerializer:(AFHTTPRequestSerializer *)requestSerializer
+                                             headersVersion:(NSUInteger)headersVersion
+                                                      error:(NSError * __autoreleasing *)error
+{
+    NSURLRequest    *preparedRequest = nil;
+    NSData          *preparedBody = nil;
+    BOOL            encodesParametersInURI = NO;
+
+    pthread_mutex_lock(&_preparationMutex);
+    if (!_preparedRequest || _preparedHeadersVersion != headersVersion ||
+        (_preparedBaseURL != baseURL && ![_preparedBaseURL isEqual:baseURL])) {
+        if (![self _prepareWithBaseURL:baseURL requestSerializer:requestSerializer headersVersion:headersVersion error:error]) {
+            pthread_mutex_unlock(&_preparationMutex);
+            return nil;
+        }
+    }
+    preparedRequest = _preparedRequest;
+    preparedBody = _preparedBody;
+    encodesParametersInURI = _encodesParametersInURI;
+    pthread_mutex_unlock(&_preparationMutex);
+
+    NSMutableURLRequest *request = [preparedRequest mutableCopy];
+    if (!parameters.count) {
+        request.HTTPBody = preparedBody;
+        return request;
+    }
+
+    if (encodesParametersInURI) {
+        NSString *URLString = request.URL.absoluteString;
+        NSString *format = request.URL.query ? @"%@&%@" : @"%@?%@";
+        request.URL = [NSURL URLWithString:[NSString stringWithFormat:format, URLString, AFQueryStringFromParameters(parameters)]];
+        return request;
+    }
+
+    NSData *body = nil;
+    if ([self _parametersOverrideBody:parameters]) {
+        NSMutableDictionary *mergedBody = [NSMutableDictionary dictionaryWithDictionary:self.body];
+        [mergedBody addEntriesFromDictionary:parameters];
+        body = [NSJSONSerialization dataWithJSONObject:mergedBody options:0 error:error];
+    } else {
+        NSData *parametersBody = [NSJSONSerialization dataWithJSONObject:parameters options:0 error:error];
+        if (parametersBody && preparedBody.length) {
+            // Splice the two objects : "{<template>}" + "{<parameters>}" => "{<template>,<parameters>}".
+            NSMutableData *mergedBody = [NSMutableData dataWithCapacity:preparedBody.length + parametersBody.length];
+            [mergedBody appendBytes:preparedBody.bytes length:preparedBody.length - 1];
+            [mergedBody appendBytes:"," length:1];
+            [mergedBody appendBytes:(const uint8_t *)parametersBody.bytes + 1 length:parametersBody.length - 1];
+            body = mergedBody;
+        } else {
+            body = parametersBody;
+        }
+    }
+    if (!body) {
+        return nil;
+    }
+    request.HTTPBody = body;
+    _AGRestRequestTemplateSetJSONContentType(request);
+    return request;
+}
+
+#pragma mark - Private
+#pragma mark -
+
+- (BOOL)_prepareWithBaseURL:(nullable NSURL *)baseURL
+          requestSerializer:(AFHTTPRequestSerializer *)requestSerializer
+             headersVersion:(NSUInteger)headersVersion
+                      error:(NSError * __autoreleasing *)error
+{
+    NSString *URLString = [[NSURL URLWithString:self.endPoint relativeToURL:baseURL] absoluteString];
+    NSMutableURLRequest *request = [requestSerializer requestWithMethod:self.httpMethodString
+                                                              URLString:URLString
+                                                             parameters:nil
+                                                                  error:error];
+    if (!request) {
+        return NO;
+    }
+
+    BOOL encodesParametersInURI = [requestSerializer.HTTPMethodsEncodingParametersInURI containsObject:self.httpMethodString];
+    NSData *body = nil;
+    if (self.body.count) {
+        if (encodesParametersInURI) {
+            NSString *format = request.URL.query ? @"%@&%@" : @"%@?%@";
+            request.URL = [NSURL URLWithString:[NSString stringWithFormat:format, request.URL.absoluteString, AFQueryStringFromParameters(self.body)]];
+        } else {
+            body = [NSJSONSerialization dataWithJSONObject:self.body options:0 error:error];
+            if (!body) {
+                return NO;
+            }
+            // Set before the template headers, in the order of the regular path.
+            _AGRestRequestTemplateSetJSONContentType(request);
+        }
+    }
+    for (NSString *httpHeaderKey in self.headers) {
+        [request addValue:self.headers[httpHeaderKey] forHTTPHeaderField:httpHeaderKey];
+    }
+
+    _preparedRequest = [request copy];
+    _preparedBaseURL = baseURL;
+    _preparedHeadersVersion = headersVersion;
+    _preparedBody = body;
+    _encodesParametersInURI = encodesParametersInURI;
+    return YES;
+}
+
+- (BOOL)_parametersOverrideBody:(NSDictionary *)parameters {
+    NSDictionary *body = self.body;
+    if (!body.count) {
+        return NO;
+    }
+    for (id key in parameters) {
+        if (body[key]) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+@end
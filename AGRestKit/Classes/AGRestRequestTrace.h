@@ -0,0 +1,116 @@
+//
+//  AGRestRequestTrace.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 30/10/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  @typedef AGRestRequestTraceStage
+ *  `AGRestRequestTraceStage` enums contains all the phases timed during a request lifecycle.
+ */
+typedef NS_ENUM(NSUInteger, AGRestRequestTraceStage) {
+    /*!
+     From the submission to the request controller until the runner picks the request up.
+     */
+    AGRestRequestTraceStageEnqueue = 0,
+    /*!
+     From the runner until the request is handed to the server.
+     */
+    AGRestRequestTraceStageRunnerDispatch,
+    /*!
+     Time spent waiting in the server operation queue.
+     */
+    AGRestRequestTraceStageServerQueueWait,
+    /*!
+     DNS lookup. Only available on iOS 10 and later.
+     */
+    AGRestRequestTraceStageDomainLookup,
+    /*!
+     Connection establishment, including TLS. Only available on iOS 10 and later.
+     */
+    AGRestRequestTraceStageConnect,
+    /*!
+     TLS handshake. Only available on iOS 10 and later.
+     */
+    AGRestRequestTraceStageSecureConnection,
+    /*!
+     From the request being sent until the first byte of the response. Only available on iOS 10 and later.
+     */
+    AGRestRequestTraceStageTimeToFirstByte,
+    /*!
+     From the first until the last byte of the response. Only available on iOS 10 and later.
+     */
+    AGRestRequestTraceStageDownload,
+    /*!
+     Decoding of the response body into JSON objects.
+     */
+    AGRestRequestTraceStageDecode,
+    /*!
+     Mapping of the JSON objects into model objects by the response serializer.
+     Mapping runs when the response data is first read, so this stage is recorded after the trace was logged.
+     */
+    AGRestRequestTraceStageMapping,
+    /*!
+     From the response being received until it's delivered to the caller, mapping excluded.
+     */
+    AGRestRequestTraceStageCompletion,
+    AGRestRequestTraceStageCount
+};
+
+/*!
+ @class AGRestRequestTrace
+ 
+ @discussion The AGRestRequestTrace class holds the time spent by a request in each phase of its lifecycle.
+ A trace is attached to every AGRestResponse, and handed to the logger when it implements `logTrace:`.
+ */
+@interface AGRestRequestTrace : NSObject
+
+/*!
+ @abstract Identifier of the traced request.
+ */
+@property (nonatomic, copy, readonly) NSString *requestIdentifier;
+/*!
+ @abstract Date at which the request was submitted.
+ @discussion Informative only, the stages are timed with a monotonic clock which the system clock changes don't affect.
+ */
+@property (nonatomic, strong, readonly) NSDate *startDate;
+
+/*!
+ @abstract Protocol of the connection which carried the request, e.g. "h2" or "http/1.1". Only available on iOS 10 and later.
+ */
+@property (nonatomic, copy, readonly, nullable) NSString *networkProtocolName;
+
+/*!
+ @abstract YES if the request was sent on a connection already open. Only available on iOS 10 and later.
+ */
+@property (nonatomic, assign, readonly, getter=isReusedConnection) BOOL reusedConnection;
+
+/*!
+ @param stage The AGRestRequestTraceStage.
+ @return Duration of the stage in seconds, or a negative value if the stage wasn't recorded.
+ */
+- (NSTimeInterval)durationForStage:(AGRestRequestTraceStage)stage;
+/*!
+ @return Time in seconds from the submission of the request until its last recorded stage ended.
+ */
+- (NSTimeInterval)totalDuration;
+/*!
+ @return NSDictionary of recorded stage names to their duration in milliseconds.
+ */
+- (NSDictionary<NSString *, NSNumber *> *)dictionaryRepresentation;
+
+/*!
+ @param stage The AGRestRequestTraceStage.
+ @return A readable name for the stage.
+ */
++ (NSString *)nameForStage:(AGRestRequestTraceStage)stage;
+
+@end
+
+NS_ASSUME_NONNULL_END
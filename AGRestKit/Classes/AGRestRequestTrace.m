@@ -0,0 +1,228 @@
+//
+//  AGRestRequestTrace.m
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 30/10/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestRequestTrace.h"
+#import "AGRestRequestTrace_Private.h"
+
+#import <objc/runtime.h>
+
+#import "AGRestPipelineInstrumentation.h"
+
+static const void *_AGRestRequestTraceTaskKey = &_AGRestRequestTraceTaskKey;
+
+@interface AGRestRequestTrace () {
+    // Offsets from `_startTime`, in seconds. A negative offset means not recorded.
+    NSTimeInterval _stageStarts[AGRestRequestTraceStageCount];
+    NSTimeInterval _stageEnds[AGRestRequestTraceStageCount];
+    NSTimeInterval _startTime;
+}
+
+@property (nonatomic, copy, readwrite) NSString *requestIdentifier;
+@property (nonatomic, strong, readwrite) NSDate *startDate;
+@property (nonatomic, copy, readwrite) NSString *networkProtocolName;
+@property (nonatomic, assign, readwrite, getter=isReusedConnection) BOOL reusedConnection;
+
+- (void)_recordStage:(AGRestRequestTraceStage)stage
+           startDate:(NSDate *)startDate
+             endDate:(NSDate *)endDate
+          anchorDate:(NSDate *)anchorDate
+          anchorTime:(NSTimeInterval)anchorTime;
+
+@end
+
+@implementation AGRestRequestTrace
+
+#pragma mark - Init
+#pragma mark -
+
+- (instancetype)initWithRequestIdentifier:(NSString *)requestIdentifier {
+    self = [super init];
+    if (!self) return nil;
+    
+    _requestIdentifier = [requestIdentifier copy];
+    _startDate = [NSDate date];
+    _startTime = AGRestPipelineCurrentTime();
+    for (NSUInteger stage = 0; stage < AGRestRequestTraceStageCount; stage++) {
+        _stageStarts[stage] = -1;
+        _stageEnds[stage] = -1;
+    }
+    
+    return self;
+}
+
++ (instancetype)traceWithRequestIdentifier:(NSString *)requestIdentifier {
+    return [[AGRestRequestTrace alloc] initWithRequestIdentifier:requestIdentifier];
+}
+
+#pragma mark - Recording
+#pragma mark -
+
+- (void)beginStage:(AGRestRequestTraceStage)stage {
+    if (stage >= AGRestRequestTraceStageCount) return;
+    NSTimeInterval offset = AGRestPipelineCurrentTime() - _startTime;
+    @synchronized (self) {
+        _stageStarts[stage] = offset;
+        _stageEnds[stage] = -1;
+    }
+}
+
+- (void)endStage:(AGRestRequestTraceStage)stage {
+    if (stage >= AGRestRequestTraceStageCount) return;
+    NSTimeInterval offset = AGRestPipelineCurrentTime() - _startTime;
+    @synchronized (self) {
+        if (_stageStarts[stage] >= 0) {
+            _stageEnds[stage] = offset;
+        }
+    }
+}
+
+- (void)recordStage:(AGRestRequestTraceStage)stage startDate:(NSDate *)startDate endDate:(NSDate *)endDate {
+    [self _recordStage:stage startDate:startDate endDate:endDate anchorDate:[NSDate date] anchorTime:AGRestPipelineCurrentTime()];
+}
+
+// Wall clock dates are converted to the monotonic clock against an anchor taken right now: only the short interval
+// between the dates and the anchor is measured with the wall clock, never the whole request.
+- (void)_recordStage:(AGRestRequestTraceStage)stage
+           startDate:(NSDate *)startDate
+             endDate:(NSDate *)endDate
+          anchorDate:(NSDate *)anchorDate
+          anchorTime:(NSTimeInterval)anchorTime
+{
+    if (!startDate || !endDate) return;
+    [self recordStage:stage
+            startTime:anchorTime + [startDate timeIntervalSinceDate:anchorDate]
+              endTime:anchorTime + [endDate timeIntervalSinceDate:anchorDate]];
+}
+
+- (void)recordStage:(AGRestRequestTraceStage)stage startTime:(NSTimeInterval)startTime endTime:(NSTimeInterval)endTime {
+    if (stage >= AGRestRequestTraceStageCount || endTime < startTime) return;
+    @synchronized (self) {
+        _stageStarts[stage] = MAX(startTime - _startTime, 0);
+        _stageEnds[stage] = MAX(endTime - _startTime, _stageStarts[stage]);
+    }
+}
+
+#pragma mark - Session Task
+#pragma mark -
+
+- (void)attachToTask:(NSURLSessionTask *)task {
+    objc_setAssociatedObject(task, _AGRestRequestTraceTaskKey, self, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+}
+
++ (nullable instancetype)traceForTask:(NSURLSessionTask *)task {
+    return task ? objc_getAssociatedObject(task, _AGRestRequestTraceTaskKey) : nil;
+}
+
+#if defined(__IPHONE_10_0) && __IPHONE_OS_VERSION_MAX_ALLOWED >= __IPHONE_10_0
+- (void)recordTaskMetrics:(NSURLSessionTaskMetrics *)metrics {
+    // Redirects add transactions, the last one delivered the response.
+    NSURLSessionTaskTransactionMetrics *transaction = metrics.transactionMetrics.lastObject;
+    if (!transaction) {
+        return;
+    }
+    // One anchor for all the stages, so that they stay consistent with each other.
+    NSDate *anchorDate = [NSDate date];
+    NSTimeInterval anchorTime = AGRestPipelineCurrentTime();
+    [self _recordStage:AGRestRequestTraceStageDomainLookup
+             startDate:transaction.domainLookupStartDate
+               endDate:transaction.domainLookupEndDate
+            anchorDate:anchorDate
+            anchorTime:anchorTime];
+    [self _recordStage:AGRestRequestTraceStageConnect
+             startDate:transaction.connectStartDate
+               endDate:transaction.connectEndDate
+            anchorDate:anchorDate
+            anchorTime:anchorTime];
+    [self _recordStage:AGRestRequestTraceStageSecureConnection
+             startDate:transaction.secureConnectionStartDate
+               endDate:transaction.secureConnectionEndDate
+            anchorDate:anchorDate
+            anchorTime:anchorTime];
+    [self _recordStage:AGRestRequestTraceStageTimeToFirstByte
+             startDate:transaction.requestStartDate
+               endDate:transaction.responseStartDate
+            anchorDate:anchorDate
+            anchorTime:anchorTime];
+    [self _recordStage:AGRestRequestTraceStageDownload
+             startDate:transaction.responseStartDate
+               endDate:transaction.responseEndDate
+            anchorDate:anchorDate
+            anchorTime:anchorTime];
+    self.networkProtocolName = transaction.networkProtocolName;
+    self.reusedConnection = transaction.isReusedConnection;
+}
+#endif
+
+#pragma mark - Accessors
+#pragma mark -
+
+- (NSTimeInterval)durationForStage:(AGRestRequestTraceStage)stage {
+    if (stage >= AGRestRequestTraceStageCount) return -1;
+    @synchronized (self) {
+        if (_stageStarts[stage] < 0 || _stageEnds[stage] < 0) {
+            return -1;
+        }
+        return _stageEnds[stage] - _stageStarts[stage];
+    }
+}
+
+- (NSTimeInterval)totalDuration {
+    NSTimeInterval total = 0;
+    @synchronized (self) {
+        for (NSUInteger stage = 0; stage < AGRestRequestTraceStageCount; stage++) {
+            total = MAX(total, _stageEnds[stage]);
+        }
+    }
+    return total;
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)dictionaryRepresentation {
+    NSMutableDictionary *dictionary = [NSMutableDictionary dictionaryWithCapacity:AGRestRequestTraceStageCount];
+    for (NSUInteger stage = 0; stage < AGRestRequestTraceStageCount; stage++) {
+        NSTimeInterval duration = [self durationForStage:stage];
+        if (duration >= 0) {
+            dictionary[[[self class] nameForStage:stage]] = @(duration * 1000.0);
+        }
+    }
+    return dictionary;
+}
+
++ (NSString *)nameForStage:(AGRestRequestTraceStage)stage {
+    switch (stage) {
+        case AGRestRequestTraceStageEnqueue:            return @"enqueue";
+        case AGRestRequestTraceStageRunnerDispatch:     return @"runner-dispatch";
+        case AGRestRequestTraceStageServerQueueWait:    return @"server-queue-wait";
+        case AGRestRequestTraceStageDomainLookup:       return @"dns";
+        case AGRestRequestTraceStageConnect:            return @"connect";
+        case AGRestRequestTraceStageSecureConnection:   return @"tls";
+        case AGRestRequestTraceStageTimeToFirstByte:    return @"ttfb";
+        case AGRestRequestTraceStageDownload:           return @"download";
+        case AGRestRequestTraceStageDecode:             return @"decode";
+        case AGRestRequestTraceStageMapping:            return @"mapping";
+        case AGRestRequestTraceStageCompletion:         return @"completion";
+        default: break;
+    }
+    return @"unknown";
+}
+
+- (NSString *)description {
+    NSMutableString *description = [NSMutableString stringWithFormat:@"<%@: %p> request <%@> total %.2fms",
+                                    NSStringFromClass([self class]), self, self.requestIdentifier, [self totalDuration] * 1000.0];
+    if (self.networkProtocolName) {
+        [description appendFormat:@" over %@%@", self.networkProtocolName, (self.isReusedConnection) ? @" (reused)" : @""];
+    }
+    for (NSUInteger stage = 0; stage < AGRestRequestTraceStageCount; stage++) {
+        NSTimeInterval duration = [self durationForStage:stage];
+        if (duration >= 0) {
+            [description appendFormat:@"\n  %@: %.2fms", [[self class] nameForStage:stage], duration * 1000.0];
+        }
+    }
+    return description;
+}
+
+@end
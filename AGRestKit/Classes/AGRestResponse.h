@@ -9,6 +9,7 @@
 #import <Foundation/Foundation.h>
 
 @class AGRestRequest;
+@class AGRestRequestTrace;
 
 /*!
  @class AGRestResponse
@@ -38,6 +39,10 @@
  @abstract The target class to map with the response data.
  */
 @property (nonatomic, copy, nullable) Class            targetClass;
+/*!
+ @abstract Time spent by the request in each phase of its lifecycle.
+ */
+@property (nonatomic, strong, nullable) AGRestRequestTrace *trace;
 
 ///---------------
 /// @name HTTP Response
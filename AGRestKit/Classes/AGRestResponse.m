@@ -7,31 +7,57 @@
 //
 
 #import "AGRestResponse.h"
+#import "AGRestResponse_Private.h"
+
+#import <pthread.h>
 
 #import "AGRestConstants.h"
 #import "AGRest.h"
 #import "AGRestResponseSerializerProtocol.h"
 
-#define kHTTPResponseContentType        @"Content-Type"
-#define kHTTPResponseContentEncoding    @"Content-Encoding"
-#define kHTTPResponseLastModified       @"Last-Modified"
+// Keys of the header index, header field names are case-insensitive.
+#define kHTTPResponseContentType        @"content-type"
+#define kHTTPResponseContentEncoding    @"content-encoding"
+#define kHTTPResponseLastModified       @"last-modified"
 
 @interface AGRestResponse() {
-    NSString *_contentType;
-    NSString *_contentEncoding;
     NSString *_contentString;
     NSDate   *_lastModified;
     NSDate   *_date;
+    
+    // Guards the lazy decoding of the response data. The decoder itself runs unlocked, on `_responseDataDecodingThread`,
+    // while the other readers wait on `_responseDataCondition`.
+    pthread_mutex_t             _responseDataMutex;
+    pthread_cond_t              _responseDataCondition;
+    id                          _responseData;
+    AGRestResponseDataDecoder   _responseDataDecoder;
+    BOOL                        _responseDataDecoding;
+    pthread_t                   _responseDataDecodingThread;
+    // Set when `responseData` is set while decoding, the decoded result is then dropped.
+    BOOL                        _responseDataDecodingDiscarded;
 }
 
 @property (strong) NSDictionary     *header_;
+@property (strong) NSDictionary     *headerIndex_; // header_ keyed by lowercase field name.
 @property (assign) NSInteger        statusCode_;
 
 @end
 
 @implementation AGRestResponse
 
+- (instancetype)init {
+    self = [super init];
+    if (!self) return nil;
+    
+    pthread_mutex_init(&_responseDataMutex, NULL);
+    pthread_cond_init(&_responseDataCondition, NULL);
+    
+    return self;
+}
+
 - (void)dealloc {
+    pthread_cond_destroy(&_responseDataCondition);
+    pthread_mutex_destroy(&_responseDataMutex);
 }
 
 #pragma mark - Initialize
@@ -61,14 +87,104 @@
 {
     AGRestResponse *response = [[AGRestResponse alloc] init];
     response.responseData = data;
-    response.header_ = [NSDictionary dictionaryWithDictionary:header];
+    response.header_ = [header copy];
+    response.headerIndex_ = [self _indexForHeader:response.header_];
     response.statusCode_ = statusCode;
     return response;
 }
 
++ (NSDictionary *)_indexForHeader:(NSDictionary *)header {
+    if (!header.count) {
+        return nil;
+    }
+    NSMutableDictionary *index = [NSMutableDictionary dictionaryWithCapacity:header.count];
+    [header enumerateKeysAndObjectsUsingBlock:^(id  _Nonnull key, id  _Nonnull obj, BOOL * _Nonnull stop) {
+        if ([key isKindOfClass:[NSString class]]) {
+            index[[key lowercaseString]] = obj;
+        }
+    }];
+    return index;
+}
+
++ (NSDateFormatter *)_HTTPDateFormatter {
+    // NSDateFormatter is thread-safe since iOS 7, a single instance is shared by all the responses.
+    static NSDateFormatter *dateFormatter = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        dateFormatter = [[NSDateFormatter alloc] init];
+        [dateFormatter setLocale:[NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"]];
+        [dateFormatter setDateFormat:kHTTPTimestampFormat];
+        [dateFormatter setLenient:YES];
+    });
+    return dateFormatter;
+}
+
+#pragma mark - Response Data
+#pragma mark -
+
+- (id)responseData {
+    pthread_mutex_lock(&_responseDataMutex);
+    // Reads from the decoder itself get the raw body, other threads wait for the decoded one.
+    while (_responseDataDecoding && !pthread_equal(_responseDataDecodingThread, pthread_self())) {
+        pthread_cond_wait(&_responseDataCondition, &_responseDataMutex);
+    }
+    AGRestResponseDataDecoder decoder = _responseDataDecoder;
+    if (!decoder) {
+        id responseData = _responseData;
+        pthread_mutex_unlock(&_responseDataMutex);
+        return responseData;
+    }
+    _responseDataDecoder = nil;
+    _responseDataDecoding = YES;
+    _responseDataDecodingThread = pthread_self();
+    _responseDataDecodingDiscarded = NO;
+    pthread_mutex_unlock(&_responseDataMutex);
+    
+    // Unlocked: the decoder runs the user's serializer blocks, which may take long or read other responses.
+    id decodedData = decoder(self);
+    
+    pthread_mutex_lock(&_responseDataMutex);
+    if (!_responseDataDecodingDiscarded) {
+        _responseData = decodedData;
+    }
+    _responseDataDecoding = NO;
+    id responseData = _responseData;
+    pthread_cond_broadcast(&_responseDataCondition);
+    pthread_mutex_unlock(&_responseDataMutex);
+    return responseData;
+}
+
+- (void)setResponseData:(id)responseData {
+    pthread_mutex_lock(&_responseDataMutex);
+    _responseDataDecoder = nil;
+    _responseDataDecodingDiscarded = _responseDataDecoding;
+    _responseData = responseData;
+    pthread_mutex_unlock(&_responseDataMutex);
+}
+
+- (void)_setResponseDataDecoder:(AGRestResponseDataDecoder)decoder {
+    pthread_mutex_lock(&_responseDataMutex);
+    _responseDataDecoder = [decoder copy];
+    pthread_mutex_unlock(&_responseDataMutex);
+}
+
+- (id)_rawResponseData {
+    pthread_mutex_lock(&_responseDataMutex);
+    id responseData = _responseData;
+    pthread_mutex_unlock(&_responseDataMutex);
+    return responseData;
+}
+
 #pragma mark - Response Status
 #pragma mark -
 
+- (NSError *)responseError {
+    // The decoder may set the error, finish it first so that the status doesn't depend on which accessor runs first.
+    // Reads from the decoder itself get the current error.
+    [self responseData];
+    return _responseError;
+}
+
 - (BOOL)succeeded
 {
     return (self.responseError)?NO:YES;
@@ -97,13 +213,15 @@
 
 - (nullable NSString *)contentString {
     NSString *contentString = nil;
-    if (self.header_ && self.responseData)
+    // Read without triggering the decoding of the response data.
+    id responseData = [self _rawResponseData];
+    if (self.header_ && responseData)
     {
-        if ([self.responseData isKindOfClass:[NSString class]]) {
-            contentString = [NSString stringWithString:self.responseData];
-        } else {
+        if ([responseData isKindOfClass:[NSString class]]) {
+            contentString = [NSString stringWithString:responseData];
+        } else if ([responseData isKindOfClass:[NSData class]]) {
             BOOL lossy = NO;
-            [NSString stringEncodingForData:self.responseData
+            [NSString stringEncodingForData:responseData
                             encodingOptions:nil
                             convertedString:&contentString
                         usedLossyConversion:&lossy];
@@ -122,45 +240,18 @@
 }
 
 - (nullable NSString *)contentType {
-    if (self.header_) {
-        if (!_contentType) {
-            [self.header_ enumerateKeysAndObjectsUsingBlock:^(id  _Nonnull key, id  _Nonnull obj, BOOL * _Nonnull stop) {
-                if ([[key lowercaseString] isEqualToString:[kHTTPResponseContentType lowercaseString]]) {
-                    _contentType = [NSString stringWithString:obj];
-                    *stop = YES;
-                }
-            }];
-        }
-    }
-    return _contentType;
+    return self.headerIndex_[kHTTPResponseContentType];
 }
 
 - (nullable NSString *)contentEncoding {
-    if (self.header_) {
-        if (!_contentEncoding) {
-            [self.header_ enumerateKeysAndObjectsUsingBlock:^(id  _Nonnull key, id  _Nonnull obj, BOOL * _Nonnull stop) {
-                if ([[key lowercaseString] isEqualToString:[kHTTPResponseContentEncoding lowercaseString]]) {
-                    _contentEncoding = [NSString stringWithString:obj];
-                    *stop = YES;
-                }
-            }];
-        }
-    }
-    return _contentEncoding;
+    return self.headerIndex_[kHTTPResponseContentEncoding];
 }
 
 - (nullable NSDate *)lastModified {
-    if (self.header_) {
-        if (!_lastModified) {
-            [self.header_ enumerateKeysAndObjectsUsingBlock:^(id  _Nonnull key, id  _Nonnull obj, BOOL * _Nonnull stop) {
-                if ([[key lowercaseString] isEqualToString:[kHTTPResponseLastModified lowercaseString]]) {
-                    NSDateFormatter *dateFormatter = [[NSDateFormatter alloc] init];
-                    [dateFormatter setDateFormat:kHTTPTimestampFormat];
-                    [dateFormatter setLenient:YES];
-                    _lastModified = [dateFormatter dateFromString:obj];
-                    *stop = YES;
-                }
-            }];
+    if (!_lastModified) {
+        NSString *lastModified = self.headerIndex_[kHTTPResponseLastModified];
+        if (lastModified) {
+            _lastModified = [[[self class] _HTTPDateFormatter] dateFromString:lastModified];
         }
     }
     return _lastModified;
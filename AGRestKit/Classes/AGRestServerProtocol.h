@@ -45,6 +45,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)setAcceptableStatusCodes:(NSIndexSet *)httpStatusCodes;
 
+/*!
+    @brief Open connections to the given urls ahead of the first request, so that it doesn't pay for DNS, TCP and TLS.
+    @param urls NSArray of NSURL to connect to. Only their scheme, host and port are relevant.
+    @return A BFTask resolving to an NSArray of AGRestResponse, one per url in the same order, whose trace holds the cost
+    of the connection. The task must not fault when a host can't be reached, the response holds the error instead.
+ */
+- (BFTask *)warmUpConnectionsToURLs:(NSArray<NSURL *> *)urls;
+
 @end
 
 NS_ASSUME_NONNULL_END
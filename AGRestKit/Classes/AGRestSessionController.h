@@ -11,6 +11,13 @@
 #import "AGRestConstants.h"
 #import "AGRestSessionProtocol.h"
 
+/*!
+ @abstract Returns the request refreshing a session rejected by the server.
+ @param expiredSessionToken The session token the server rejected.
+ @return The refresh request, nil if the session can't be refreshed.
+ */
+typedef AGRestRequest * _Nullable (^AGRestSessionRefreshRequestBlock)(NSString * _Nonnull expiredSessionToken);
+
 /*!
  @class AGRestSessionController
  */
@@ -26,6 +33,13 @@
 @property (strong, nonnull) NSString    * templateKeyEmailResetPassword;
 @property (strong, nonnull) NSString    * templateTokenExtractionKey;
 
+/*!
+ @abstract Hook building the session refresh request, the session isn't refreshed if nil.
+ @discussion When a request is rejected with a 401, the request is sent once, the new session token is extracted from
+ its response like on log in, and the rejected requests are replayed with it. Requests sent meanwhile wait for the refresh.
+ */
+@property (copy, nullable) AGRestSessionRefreshRequestBlock sessionRefreshRequestBlock;
+
 @property (unsafe_unretained, nonnull, setter=setBaseUserClass:) Class<AGRestObjectMapping> baseUserClass;
 
 - (nullable instancetype)initWithDataSource:(nonnull id<AGRestCoreManagerDataSource>)dataSource
@@ -53,4 +67,10 @@
 - (void)requestResetPasswordForEmail:(nonnull NSString *)email
                           completion:(void (^ _Nullable)(BOOL succeeded, AGRestResponse * _Nullable object))block;
 
+- (nullable NSString *)currentSessionToken;
+
+- (nullable BFTask *)sessionRefreshTask;
+
+- (nonnull BFTask *)refreshSessionAsyncWithExpiredSessionToken:(nonnull NSString *)expiredSessionToken;
+
 @end
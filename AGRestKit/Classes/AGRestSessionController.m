@@ -9,13 +9,16 @@
 #import "AGRestSessionController.h"
 
 #import <Bolts/BFTask.h>
+#import <Bolts/BFTaskCompletionSource.h>
 #import <objc/runtime.h>
 
 #import "AGRestSessionStore.h"
 #import "AGRestResponse.h"
 #import "AGRestRequest.h"
+#import "AGRestRequest_Private.h"
 #import "AGRestServer.h"
 #import "AGRestObjectMapper.h"
+#import "AGRestObjectBinaryCoder.h"
 #import "AGRestErrorUtilities.h"
 #import "AGRestObjectMapping.h"
 #import "AGUserSessionProtocol.h"
@@ -29,7 +32,10 @@
 #define kAGRestSessionControllerDefaultTemplateKeyPassword @"password"
 #define kAGRestSessionControllerDefaultTemplateKeyResetPassword @"email"
 
-@interface AGRestSessionController()
+@interface AGRestSessionController() {
+    // Refresh in progress, guarded by self.
+    BFTask *_sessionRefreshTask;
+}
 
 @property (strong) id<AGRestObjectMapping> currentUser_;
 
@@ -244,6 +250,92 @@
     }
 }
 
+#pragma mark - Session Refresh
+#pragma mark -
+
+- (nullable NSString *)currentSessionToken {
+    return [self.dataSource.sessionStore sessionTokenWithIdentifier:nil];
+}
+
+- (nullable BFTask *)sessionRefreshTask {
+    @synchronized(self) {
+        return _sessionRefreshTask;
+    }
+}
+
+- (nonnull BFTask *)refreshSessionAsyncWithExpiredSessionToken:(nonnull NSString *)expiredSessionToken {
+    BFTaskCompletionSource *refreshCompletion = nil;
+    AGRestRequest *refreshRequest = nil;
+    NSString *identifier = nil;
+    
+    @synchronized(self) {
+        // Join the refresh in progress
+        if (_sessionRefreshTask) {
+            return _sessionRefreshTask;
+        }
+        
+        // The session has been refreshed or changed since the request was sent
+        NSString *sessionToken = [self.dataSource.sessionStore sessionTokenWithIdentifier:&identifier];
+        if (!sessionToken || !identifier) {
+            return [BFTask taskWithError:[AGRestErrorUtilities errorWithCode:kAGErrorInvalidSessionToken
+                                                                     message:@"<AGRestSessionController> No session to refresh."
+                                                                   shouldLog:NO]];
+        }
+        if (![sessionToken isEqualToString:expiredSessionToken]) {
+            return [BFTask taskWithResult:sessionToken];
+        }
+        
+        refreshRequest = (self.sessionRefreshRequestBlock) ? self.sessionRefreshRequestBlock(expiredSessionToken) : nil;
+        if (!refreshRequest) {
+            return [BFTask taskWithError:[AGRestErrorUtilities errorWithCode:kAGErrorInvalidSessionToken
+                                                                     message:@"<AGRestSessionController> Session refresh not configured."
+                                                                   shouldLog:NO]];
+        }
+        refreshCompletion = [BFTaskCompletionSource taskCompletionSource];
+        _sessionRefreshTask = refreshCompletion.task;
+    }
+    
+    AGRestLogInfo(@"<AGRestSessionController> Refreshing session for %@.", identifier);
+    refreshRequest.sessionRefreshRequest = YES;
+    [refreshRequest setObjectMappingEnabled:NO];
+    
+    weakify(self);
+    [[refreshRequest sendRequestInBackground] continueWithBlock:^id(BFTask *task) {
+        strongify(weakSelf);
+        AGRestResponse *response = task.result;
+        NSString *sessionToken = (response.succeeded) ? [strongSelf _extractTokenFromResponse:response] : nil;
+        
+        NSError *error = nil;
+        if (sessionToken.length &&
+            [strongSelf.dataSource.sessionStore storeSessionToken:sessionToken forIdentifier:identifier error:&error]) {
+            // Update server's session token before releasing the parked requests
+            [strongSelf.dataSource.requestServer setValue:sessionToken forHTTPHeaderField:strongSelf.templateTokenExtractionKey];
+        } else {
+            AGRestLogWarn(@"<AGRestSessionController> Session refresh failed : %@", (error)?:response.responseError);
+            sessionToken = nil;
+            error = [AGRestErrorUtilities errorWithCode:kAGErrorInvalidSessionToken
+                                                message:@"<AGRestSessionController> Session refresh failed."
+                                        underlyingError:(error)?:response.responseError];
+        }
+        
+        if (strongSelf) {
+            @synchronized(strongSelf) {
+                strongSelf->_sessionRefreshTask = nil;
+            }
+        }
+        if (sessionToken) {
+            [refreshCompletion setResult:sessionToken];
+        } else {
+            [refreshCompletion setError:error];
+        }
+        return nil;
+    }];
+    return refreshCompletion.task;
+}
+
+#pragma mark - Current User
+#pragma mark -
+
 - (nullable id<AGRestObjectMapping>)getCurrentUser {
     if (!self.currentUser_) {
         self.currentUser_ = [self _loadCurrentUser];
@@ -277,7 +369,20 @@
     if (currentSessionToken)
     {
         NSData *currentUserData = [self.dataSource.sessionStore dataForIdentifier:AGRestSessionStoreCurrentUserKey];
-        id object = [NSKeyedUnarchiver unarchiveObjectWithData:currentUserData];
+        id object = nil;
+        
+        // NSCoding users and users stored by previous versions are keyed archives, the others are in binary form
+        if ([AGRestObjectBinaryCoder isBinaryData:currentUserData]) {
+            NSError *error = nil;
+            if (self.baseUserClass) {
+                object = [AGRestObjectBinaryCoder objectOfClass:self.baseUserClass withData:currentUserData error:&error];
+            }
+            if (error) {
+                AGRestLogError(@"<SessionStore> Load current user failed : %@", error);
+            }
+        } else if (currentUserData) {
+            object = [NSKeyedUnarchiver unarchiveObjectWithData:currentUserData];
+        }
         
         if ([object isKindOfClass:[NSDictionary class]])
         {
@@ -321,15 +426,24 @@
         // Check that user is supported Class
         if ([[user class] conformsToProtocol:@protocol(AGRestObjectMapping)] && [[user class] respondsToSelector:@selector(classURI)])
         {
-            // If user instance conforms to NSCoding then use KeyedArchiver
+            // If user instance conforms to NSCoding then use KeyedArchiver, its archive is what it chose to store
             if ([user conformsToProtocol:@protocol(NSCoding)]) {
                 userData  = [NSKeyedArchiver archivedDataWithRootObject:user];
             }
-            // Else try to use the objectMapper to create source dictionary and then use KeyedArchiver
+            // Else use the binary form, read back with a single decode pass at launch
             else {
-                NSDictionary *userDic = [self.dataSource.objectMapper sourceFromObject:user error:error];
-                if (userDic && *error == nil) {
-                    userData = [NSKeyedArchiver archivedDataWithRootObject:userDic];
+                NSError *binaryError = nil;
+                userData = [AGRestObjectBinaryCoder dataWithObject:user error:&binaryError];
+                // Else try to use the objectMapper to create source dictionary and then use KeyedArchiver
+                if (!userData) {
+                    AGRestLogWarn(@"<SessionStore> Current user can't be stored in binary form : %@", binaryError);
+                    NSError *mappingError = nil;
+                    NSDictionary *userDic = [self.dataSource.objectMapper sourceFromObject:user error:&mappingError];
+                    if (userDic && !mappingError) {
+                        userData = [NSKeyedArchiver archivedDataWithRootObject:userDic];
+                    } else if (error) {
+                        *error = mappingError;
+                    }
                 }
             }
             
@@ -385,15 +499,21 @@
         
         // If not found in the header try to find the session key in the response data
         if (tokenIndex == NSNotFound && response.responseData) {
-            NSDictionary *responseData = (NSDictionary *)[response responseData];
+            id responseData = [response responseData];
+            // Without object mapping, e.g. for a session refresh, the body is left undecoded.
+            if ([responseData isKindOfClass:[NSData class]]) {
+                responseData = [NSJSONSerialization JSONObjectWithData:responseData options:0 error:nil];
+            }
             if ([responseData isKindOfClass:[NSDictionary class]]) {
                 __block NSString *sessionToken = nil;
-                [responseData enumerateKeysAndObjectsUsingBlock:^(id  _Nonnull key, id  _Nonnull obj, BOOL * _Nonnull stop) {
-                    if ([[key lowercaseString] isEqualToString:[self.templateTokenExtractionKey lowercaseString]]) {
+                [(NSDictionary *)responseData enumerateKeysAndObjectsUsingBlock:^(id  _Nonnull key, id  _Nonnull obj, BOOL * _Nonnull stop) {
+                    if ([[key lowercaseString] isEqualToString:[self.templateTokenExtractionKey lowercaseString]] &&
+                        [obj isKindOfClass:[NSString class]]) {
                         sessionToken = [NSString stringWithString:obj];
                         *stop = YES;
                     }
                 }];
+                return sessionToken;
             }
         }
     }
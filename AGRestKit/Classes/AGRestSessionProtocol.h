@@ -8,6 +8,7 @@
 
 #import "AGRestModule.h"
 
+@class BFTask;
 @protocol AGRestObjectMapping;
 
 /*!
@@ -61,4 +62,25 @@
 - (void)requestResetPasswordForEmail:(nonnull NSString *)email
                           completion:(void (^ _Nullable)(BOOL succeeded, AGRestResponse * _Nullable object))block;
 
+/*!
+    @abstract Return the session token currently sent with the requests.
+    @return The session token, nil if no user is logged in.
+ */
+- (nullable NSString *)currentSessionToken;
+
+/*!
+    @abstract Return the session refresh in progress.
+    @return A task resolved with the new session token, nil if no refresh is in progress.
+ */
+- (nullable BFTask *)sessionRefreshTask;
+
+/*!
+    @discussion Refresh the session after a request was rejected with `expiredSessionToken`.
+    Only one refresh runs at a time, concurrent calls share it. If the session token changed since `expiredSessionToken`
+    was sent, the current token is returned without refreshing.
+    @param expiredSessionToken The session token the server rejected.
+    @return A task resolved with the new session token, or faulted if the session couldn't be refreshed.
+ */
+- (nonnull BFTask *)refreshSessionAsyncWithExpiredSessionToken:(nonnull NSString *)expiredSessionToken;
+
 @end
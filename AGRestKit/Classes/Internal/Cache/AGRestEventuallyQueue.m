@@ -20,6 +20,9 @@
 #import "AGRestErrorUtilities.h"
 #import "AGRestTaskQueue.h"
 #import "AGRestEventuallyQueue_Private.h"
+#import "AGRestMetricsCollecting.h"
+#import "AGRestManager.h"
+#import "AGRest_Private.h"
 
 NSUInteger       const AGRestEventuallyQueueDefaultMaxAttemps = 5;
 NSTimeInterval   const AGRestEventuallyQueueDefaultRetryTimeInterval = 600.0f;
@@ -119,6 +122,7 @@ NSTimeInterval   const AGRestEventuallyQueueDefaultRetryTimeInterval = 600.0f;
 {
     _taskCompletionSources[identifier] = taskCompletionSource;
     dispatch_source_merge_data(_processingQueueSource, 1);
+    [self _recordRequestsCount];
     
     if (_retryingSemaphore) {
         dispatch_semaphore_signal(_retryingSemaphore);
@@ -178,6 +182,10 @@ NSTimeInterval   const AGRestEventuallyQueueDefaultRetryTimeInterval = 600.0f;
     return [[self _pendingRequestIdentifiers] count];
 }
 
+- (void)_recordRequestsCount {
+    [[AGRest _currentManager].metrics recordEventuallyQueueDepth:self.requestsCount];
+}
+
 #pragma mark - Running Requests
 #pragma mark -
 
@@ -301,6 +309,7 @@ NSTimeInterval   const AGRestEventuallyQueueDefaultRetryTimeInterval = 600.0f;
     dispatch_sync(_synchronizationQueue, ^{
         [_taskCompletionSources removeObjectForKey:identifier];
     });
+    [self _recordRequestsCount];
     
     return resultTask;
 }
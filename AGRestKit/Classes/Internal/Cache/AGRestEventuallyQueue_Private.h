@@ -38,10 +38,19 @@
 
 - (NSString *)_newIdentifierForRequest:(id<AGRestCachable>)request;
 
+/*!
+ @abstract Runs the pending requests, oldest first. Called on the processing queue.
+ */
+- (void)_runRequests;
+
 - (BFTask *)_didFinishRunningRequest:(id<AGRestCachable>)request
                       withIdentifier:(NSString *)identifier
                           resultTask:(BFTask *)resultTask;
 
+/*!
+ @abstract Reports the current `requestsCount` to the metrics collector.
+ */
+- (void)_recordRequestsCount;
 
 
 @end
@@ -25,6 +25,14 @@ unsigned long long const AGRestRequestsCacheDefaultDiskCacheSize = 10 * 1024 * 1
 
 @interface AGRestRequestCache() {
     unsigned int _fileCounter;
+    
+    dispatch_queue_t _diskCacheIndexQueue;
+    NSMutableArray<NSString *> *_diskCacheIdentifiers; // Sorted, oldest first.
+    NSMutableDictionary<NSString *, NSNumber *> *_diskCacheFileSizes;
+    unsigned long long _diskCacheTotalSize;
+    
+    // Creation of the directory and reconciliation of the index, anything touching the directory waits for it.
+    BFTask *_diskCacheSetupTask;
 }
 
 @property (nonatomic, assign, readwrite, setter=_setDiskCacheSize:) unsigned long long diskCacheSize;
@@ -52,8 +60,16 @@ unsigned long long const AGRestRequestsCacheDefaultDiskCacheSize = 10 * 1024 * 1
                           retryInterval:AGRestEventuallyQueueDefaultRetryTimeInterval];
     if (self) {
         _cacheUrlPath = cacheDir;
+        _diskCacheIndexQueue = dispatch_queue_create("com.agrestkit.requestCache.diskIndex", DISPATCH_QUEUE_SERIAL);
+        _diskCacheIdentifiers = [NSMutableArray array];
+        _diskCacheFileSizes = [NSMutableDictionary dictionary];
         [self _setDiskCacheSize:maxCacheSize];
-        [self _createDiskCachePathIfNeeded];
+        // Disk-bound setup runs in background, it mustn't hold the initialization.
+        _diskCacheSetupTask = [self _setUpDiskCacheInBackground];
+        [_diskCacheSetupTask continueWithBlock:^id(BFTask *task) {
+            [self _recordRequestsCount];
+            return nil;
+        }];
     }
     return self;
 }
@@ -62,6 +78,8 @@ unsigned long long const AGRestRequestsCacheDefaultDiskCacheSize = 10 * 1024 * 1
     [self pause];
     
     [super removeAllRequests];
+    // The requests left by a previous launch are only known once the index is set up.
+    [_diskCacheSetupTask waitUntilFinished];
     
     NSArray *requestIdentifiers = [self _pendingRequestIdentifiers];
     NSMutableArray *tasks = [NSMutableArray arrayWithCapacity:[requestIdentifiers count]];
@@ -87,24 +105,54 @@ unsigned long long const AGRestRequestsCacheDefaultDiskCacheSize = 10 * 1024 * 1
 }
 
 - (NSArray *)_pendingRequestIdentifiers {
-    NSArray *result = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.cacheUrlPath error:nil];
-    result = [result filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"SELF BEGINSWITH %@", @"Request"]];
-    return [result sortedArrayUsingSelector:@selector(compare:)];
+    // Served from the index, which is sorted oldest first like the identifiers.
+    // Doesn't wait for the setup, the requests left by a previous launch show up once it is done.
+    __block NSArray *identifiers = nil;
+    dispatch_sync(_diskCacheIndexQueue, ^{
+        identifiers = [_diskCacheIdentifiers copy];
+    });
+    return identifiers;
+}
+
+- (NSUInteger)requestsCount {
+    // Served from the index without waiting for the setup, the count is reported again once it is done.
+    __block NSUInteger count = 0;
+    dispatch_sync(_diskCacheIndexQueue, ^{
+        count = [_diskCacheIdentifiers count];
+    });
+    return count;
+}
+
+- (void)_runRequests {
+    // On the processing queue, the requests left by a previous launch are run once the index is set up.
+    [_diskCacheSetupTask waitUntilFinished];
+    [super _runRequests];
 }
 
 - (AGRestRequest *)_requestWithIdentifier:(NSString *)identifier error:(NSError * _Nullable __autoreleasing * _Nullable)error {
-    [[AGRestFileLockController sharedController] beginLockContentOfFileAtPath:self.cacheUrlPath];
+    id lockOwner = [[AGRestFileLockController sharedController] beginLockContentOfFileAtPath:self.cacheUrlPath
+                                                                                         mode:AGRestFileLockModeShared];
     
     NSError *innerError = nil;
-    NSData *jsonData = [NSData dataWithContentsOfFile:[self _filePathForRequestWithIdentifier:identifier]
-                                              options:NSDataReadingUncached
-                                                error:&innerError];
+    NSError *readError = nil;
+    id jsonObject = nil;
+    // Parse straight from the mapped file, the JSON is never copied into a buffer of its own.
+    // The mapping is released before the lock, so no writer can truncate the file under it.
+    @autoreleasepool {
+        NSData *jsonData = [AGRestFileManager mappedContentDataOfFile:[self _filePathForRequestWithIdentifier:identifier]
+                                                                error:&readError];
+        if (jsonData) {
+            jsonObject = [NSJSONSerialization JSONObjectWithData:jsonData
+                                                         options:0
+                                                           error:&innerError];
+        }
+    }
     
-    [[AGRestFileLockController sharedController] endLockContentOfFileAtPath:self.cacheUrlPath];
+    [[AGRestFileLockController sharedController] endLockContentOfFileAtPath:self.cacheUrlPath owner:lockOwner];
     
-    if (innerError || !jsonData) {
+    if (readError) {
         NSString *message = [NSString stringWithFormat:@"Failed to read request from cache. %@",
-                             innerError ? [innerError localizedDescription] : @""];
+                             [readError localizedDescription]];
         innerError = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal
                                                  message:message];
         if (error) {
@@ -113,9 +161,6 @@ unsigned long long const AGRestRequestsCacheDefaultDiskCacheSize = 10 * 1024 * 1
         return nil;
     }
     
-    id jsonObject = [NSJSONSerialization JSONObjectWithData:jsonData
-                                                    options:0
-                                                      error:&innerError];
     if (innerError) {
         NSString *message = [NSString stringWithFormat:@"Failed to deserialiaze request from cache. %@",
                              [innerError localizedDescription]];
@@ -138,7 +183,10 @@ unsigned long long const AGRestRequestsCacheDefaultDiskCacheSize = 10 * 1024 * 1
 
 - (BFTask *)_enqueueRequestInBackground:(AGRestRequest *)request
                              identifier:(NSString *)identifier {
-    return [self _saveRequestToCacheInBackground:request identifier:identifier];
+    // Evictions rely on the index, which is complete once the setup is done.
+    return [_diskCacheSetupTask continueWithBlock:^id(BFTask *task) {
+        return [self _saveRequestToCacheInBackground:request identifier:identifier];
+    }];
 }
 
 - (BFTask *)_didFinishRunningRequest:(AGRestRequest *)request
@@ -152,41 +200,116 @@ unsigned long long const AGRestRequestsCacheDefaultDiskCacheSize = 10 * 1024 * 1
 #pragma mark - Disk Cache
 
 - (BFTask *)_cleanupDiskCacheWithRequiredFreeSize:(NSUInteger)requiredSize {
-    return [BFTask taskFromExecutor:[BFExecutor defaultExecutor] withBlock:^id{
-        NSUInteger size = requiredSize;
-        
-        NSMutableDictionary *requestSizes = [NSMutableDictionary dictionary];
-        
-        [[AGRestFileLockController sharedController] beginLockContentOfFileAtPath:self.cacheUrlPath];
-        NSDirectoryEnumerator *enumerator = [[NSFileManager defaultManager] enumeratorAtPath:self.cacheUrlPath];
-        
-        NSString *identifier = nil;
-        while ((identifier = [enumerator nextObject])) {
-            NSNumber *fileSize = [enumerator fileAttributes][NSFileSize];
-            if (fileSize) {
-                requestSizes[identifier] = fileSize;
-                size += [fileSize unsignedIntegerValue];
-            }
+    NSArray *identifiers = [self _identifiersToEvictForRequiredFreeSize:requiredSize];
+    if ([identifiers count] == 0) {
+        return [BFTask taskWithResult:nil];
+    }
+    
+    NSMutableArray *removeTasks = [NSMutableArray arrayWithCapacity:[identifiers count]];
+    for (NSString *identifier in identifiers) {
+        [removeTasks addObject:[self _removeFileForRequestWithIdentifier:identifier]];
+    }
+    return [BFTask taskForCompletionOfAllTasks:removeTasks];
+}
+
+#pragma mark - Disk Cache Index
+
+/*!
+ @abstract Rebuilds the in-memory index from the content of the cache directory.
+ @discussion This is the only place the directory is scanned, every write and removal afterwards
+ keeps the index up to date, and the pending requests are listed from it.
+ */
+- (void)_reconcileDiskCacheIndex {
+    NSMutableDictionary *fileSizes = [NSMutableDictionary dictionary];
+    unsigned long long totalSize = 0;
+    
+    id lockOwner = [[AGRestFileLockController sharedController] beginLockContentOfFileAtPath:self.cacheUrlPath
+                                                                                         mode:AGRestFileLockModeShared];
+    // Only the request files at the top level: the temporary files a crashed write leaves behind are hidden.
+    NSDirectoryEnumerator *enumerator = [[NSFileManager defaultManager] enumeratorAtURL:[NSURL fileURLWithPath:self.cacheUrlPath]
+                                                             includingPropertiesForKeys:@[ NSURLIsRegularFileKey, NSURLFileSizeKey ]
+                                                                                options:(NSDirectoryEnumerationSkipsSubdirectoryDescendants |
+                                                                                         NSDirectoryEnumerationSkipsHiddenFiles)
+                                                                           errorHandler:nil];
+    for (NSURL *fileUrl in enumerator) {
+        NSString *identifier = [fileUrl lastPathComponent];
+        NSNumber *isRegularFile = nil;
+        NSNumber *fileSize = nil;
+        if (![identifier hasPrefix:@"Request"] || [identifier hasSuffix:@".tmp"] ||
+            ![fileUrl getResourceValue:&isRegularFile forKey:NSURLIsRegularFileKey error:nil] || ![isRegularFile boolValue] ||
+            ![fileUrl getResourceValue:&fileSize forKey:NSURLFileSizeKey error:nil] || !fileSize) {
+            continue;
         }
-        
-        [[AGRestFileLockController sharedController] endLockContentOfFileAtPath:self.cacheUrlPath];
-        
-        if (size > self.diskCacheSize) {
-            // Get identifiers and sort them to remove oldest requests first
-            NSArray *identifiers = [[requestSizes allKeys] sortedArrayUsingSelector:@selector(compare:)];
-            for (NSString *identifier in identifiers) @autoreleasepool {
-                [self _removeFileForRequestWithIdentifier:identifier];
-                size -= [requestSizes[identifier] unsignedIntegerValue];
-                
-                if (size <= self.diskCacheSize) {
-                    break;
-                }
-                [requestSizes removeObjectForKey:identifier];
+        fileSizes[identifier] = fileSize;
+        totalSize += [fileSize unsignedLongLongValue];
+    }
+    [[AGRestFileLockController sharedController] endLockContentOfFileAtPath:self.cacheUrlPath owner:lockOwner];
+    
+    // Identifiers start with the creation time - so sorting them gives the oldest requests first.
+    NSArray *identifiers = [[fileSizes allKeys] sortedArrayUsingSelector:@selector(compare:)];
+    dispatch_sync(_diskCacheIndexQueue, ^{
+        [_diskCacheIdentifiers setArray:identifiers];
+        [_diskCacheFileSizes setDictionary:fileSizes];
+        _diskCacheTotalSize = totalSize;
+    });
+}
+
+- (void)_indexFileWithIdentifier:(NSString *)identifier size:(NSUInteger)size {
+    dispatch_sync(_diskCacheIndexQueue, ^{
+        NSNumber *previousSize = _diskCacheFileSizes[identifier];
+        if (previousSize) {
+            _diskCacheTotalSize -= [previousSize unsignedLongLongValue];
+        } else {
+            // New identifiers are almost always the newest, so this is an append in practice.
+            NSUInteger index = [_diskCacheIdentifiers indexOfObject:identifier
+                                                      inSortedRange:NSMakeRange(0, [_diskCacheIdentifiers count])
+                                                            options:NSBinarySearchingInsertionIndex
+                                                    usingComparator:^NSComparisonResult(NSString *obj1, NSString *obj2) {
+                                                        return [obj1 compare:obj2];
+                                                    }];
+            [_diskCacheIdentifiers insertObject:identifier atIndex:index];
+        }
+        _diskCacheFileSizes[identifier] = @(size);
+        _diskCacheTotalSize += size;
+    });
+}
+
+- (void)_unindexFileWithIdentifier:(NSString *)identifier {
+    dispatch_sync(_diskCacheIndexQueue, ^{
+        [self _unsafeUnindexFileWithIdentifier:identifier];
+    });
+}
+
+- (void)_unsafeUnindexFileWithIdentifier:(NSString *)identifier {
+    NSNumber *size = _diskCacheFileSizes[identifier];
+    if (!size) {
+        return;
+    }
+    _diskCacheTotalSize -= [size unsignedLongLongValue];
+    [_diskCacheFileSizes removeObjectForKey:identifier];
+    [_diskCacheIdentifiers removeObject:identifier];
+}
+
+/*!
+ @abstract Picks the oldest files to remove so that `requiredSize` more bytes fit in the cache.
+ @discussion Selected files are dropped from the index right away, so concurrent enqueues don't pick them twice.
+ */
+- (NSArray *)_identifiersToEvictForRequiredFreeSize:(NSUInteger)requiredSize {
+    __block NSMutableArray *identifiers = nil;
+    dispatch_sync(_diskCacheIndexQueue, ^{
+        unsigned long long size = _diskCacheTotalSize + requiredSize;
+        while (size > self.diskCacheSize && [_diskCacheIdentifiers count] > 0) {
+            NSString *identifier = [_diskCacheIdentifiers firstObject];
+            size -= [_diskCacheFileSizes[identifier] unsignedLongLongValue];
+            [self _unsafeUnindexFileWithIdentifier:identifier];
+            
+            if (!identifiers) {
+                identifiers = [NSMutableArray array];
             }
+            [identifiers addObject:identifier];
         }
-        
-        return [BFTask taskWithResult:nil];
-    }];
+    });
+    return identifiers;
 }
 
 - (void)_setDiskCacheSize:(unsigned long long)diskCacheSize {
@@ -218,24 +341,30 @@ unsigned long long const AGRestRequestsCacheDefaultDiskCacheSize = 10 * 1024 * 1
             return [BFTask taskWithError:error];
         }
         
-        [[AGRestFileLockController sharedController] beginLockContentOfFileAtPath:self.cacheUrlPath];
-        return [[[self _cleanupDiskCacheWithRequiredFreeSize:requestSize] continueWithBlock:^id(BFTask *task) {
-            NSString *filePath = [self _filePathForRequestWithIdentifier:identifier];
-            return [AGRestFileManager writeDataAsync:data toFileAtPath:filePath];
-        }] continueWithBlock:^id(BFTask *task) {
-            [[AGRestFileLockController sharedController] endLockContentOfFileAtPath:self.cacheUrlPath];
-            return task;
+        // Make room first. The write itself doesn't need the directory lock: the file is moved in place
+        // atomically, and holding the lock would serialize saves and defeat the group commit.
+        return [[strongSelf _cleanupDiskCacheWithRequiredFreeSize:requestSize] continueWithBlock:^id(BFTask *task) {
+            NSString *filePath = [strongSelf _filePathForRequestWithIdentifier:identifier];
+            return [[AGRestFileManager writeDataDurablyAsync:data toFileAtPath:filePath] continueWithBlock:^id(BFTask *task) {
+                if (!task.faulted) {
+                    [strongSelf _indexFileWithIdentifier:identifier size:requestSize];
+                }
+                return task;
+            }];
         }];
     }];
 }
 
 - (BFTask *)_removeFileForRequestWithIdentifier:(NSString *)identifier {
     NSString *filePath = [self _filePathForRequestWithIdentifier:identifier];
+    // Released by the continuation, on whatever thread completes the removal.
+    __block id lockOwner = nil;
     return [[BFTask taskFromExecutor:[BFExecutor defaultPriorityBackgroundExecutor] withBlock:^id{
-        [[AGRestFileLockController sharedController] beginLockContentOfFileAtPath:self.cacheUrlPath];
+        lockOwner = [[AGRestFileLockController sharedController] beginLockContentOfFileAtPath:self.cacheUrlPath];
         return [AGRestFileManager removeItemAsynAtPath:filePath shouldLock:NO];
     }] continueWithBlock:^id(BFTask *task) {
-        [[AGRestFileLockController sharedController] endLockContentOfFileAtPath:self.cacheUrlPath];
+        [self _unindexFileWithIdentifier:identifier];
+        [[AGRestFileLockController sharedController] endLockContentOfFileAtPath:self.cacheUrlPath owner:lockOwner];
         return task; // Roll-forward the previous task.
     }];
 }
@@ -244,12 +373,15 @@ unsigned long long const AGRestRequestsCacheDefaultDiskCacheSize = 10 * 1024 * 1
     return [self.cacheUrlPath stringByAppendingPathComponent:identifier];
 }
 
-- (void)_createDiskCachePathIfNeeded {
-    [[[AGRestFileManager createDirectoryIfNeededAsyncAtPath:_cacheUrlPath] waitForResult:nil withMainThreadWarning:NO]
-     continueWithBlock:^id(BFTask *task) {
+- (BFTask *)_setUpDiskCacheInBackground {
+    weakify(self);
+    return [[AGRestFileManager createDirectoryIfNeededAsyncAtPath:_cacheUrlPath]
+            continueWithExecutor:[BFExecutor defaultPriorityBackgroundExecutor] withBlock:^id(BFTask *task) {
+        strongify(weakSelf);
         if (task.faulted) {
             NSLog(@"Failed to create request cache directory");
         }
+        [strongSelf _reconcileDiskCacheIndex];
         return nil;
     }];
 }
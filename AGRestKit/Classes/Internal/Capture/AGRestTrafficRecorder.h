@@ -0,0 +1,127 @@
+//
+//  AGRestTrafficRecorder.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 11/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class BFTask;
+@class AGRestRequest;
+@class AGRestResponse;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class AGRestTrafficRecord
+
+ @discussion A request and its response, as read back from a capture file.
+ */
+@interface AGRestTrafficRecord : NSObject
+
+/*!
+ @abstract Time from the start of the capture until the request was submitted, in seconds.
+ */
+@property (nonatomic, assign, readonly) NSTimeInterval              startOffset;
+/*!
+ @abstract Time from the submission of the request until its completion, in seconds.
+ */
+@property (nonatomic, assign, readonly) NSTimeInterval              duration;
+/*!
+ @abstract The `dictionaryRepresentation` of the request.
+ */
+@property (nonatomic, copy, readonly) NSDictionary                  *requestDictionary;
+/*!
+ @abstract HTTP status code of the response, 0 if none was received.
+ */
+@property (nonatomic, assign, readonly) NSInteger                   statusCode;
+/*!
+ @abstract Error of the response, with its domain and code only.
+ */
+@property (nonatomic, strong, readonly, nullable) NSError           *error;
+/*!
+ @abstract Headers and data of the response, only captured with `recordsResponseData`.
+ */
+@property (nonatomic, copy, readonly, nullable) NSDictionary        *responseHeader;
+@property (nonatomic, strong, readonly, nullable) id                responseData;
+
+/*!
+ @return A new request built from `requestDictionary`.
+ */
+- (AGRestRequest *)request;
+
+@end
+
+/*!
+ @class AGRestTrafficRecorder
+
+ @discussion Appends every request completed by the framework, with its response and timing, to a capture file.
+ Install it with `[AGRest setTrafficRecorder:]`, and replay the file with AGRestTrafficReplayer.
+
+ Requests are recorded from the completion of the request, without blocking it: records are encoded and buffered on a
+ serial queue, and written to the file in chunks. The file starts with a 5 bytes header, "AGTC" and the format version,
+ followed by the records, each a 4 bytes little endian length and a JSON object. A record cut by a crash ends the file.
+ */
+@interface AGRestTrafficRecorder : NSObject
+
+/*!
+ @abstract Path of the capture file.
+ */
+@property (nonatomic, copy, readonly) NSString  *filePath;
+
+/*!
+ @abstract Whether the response headers and data are captured, NO by default.
+ @discussion The raw body of a response is recorded without decoding it. A response already decoded is recorded
+ as JSON if its data is a JSON object.
+ */
+@property (atomic, assign) BOOL                 recordsResponseData;
+
+/*!
+ @abstract Number of records written or waiting to be written.
+ */
+@property (atomic, assign, readonly) NSUInteger recordCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Creates a recorder writing to a new capture file, replacing any file at `filePath`.
+ @param filePath    The path of the capture file.
+ @param error       The error if the file can't be created.
+ @return A recorder, nil with error otherwise.
+ */
++ (nullable instancetype)recorderWithFilePath:(NSString *)filePath
+                                        error:(NSError * _Nullable __autoreleasing * _Nullable)error;
+
+/*!
+ @abstract Record a completed request. Does nothing once the recorder is closed.
+ @param request  The request.
+ @param response Its response.
+ */
+- (void)recordRequest:(AGRestRequest *)request response:(AGRestResponse *)response;
+
+/*!
+ @abstract Write the buffered records to the file.
+ @return A BFTask completing once they are written.
+ */
+- (BFTask *)flushAsync;
+
+/*!
+ @abstract Write the buffered records to the file and close it.
+ @return A BFTask completing once the file is closed.
+ */
+- (BFTask *)closeAsync;
+
+/*!
+ @abstract Read all the records of a capture file.
+ @param filePath    The path of the capture file.
+ @param error       The error if the file can't be read or isn't a capture file.
+ @return The records in the order they were written, which is the order the requests completed in.
+ */
++ (nullable NSArray<AGRestTrafficRecord *> *)recordsWithContentsOfFile:(NSString *)filePath
+                                                                 error:(NSError * _Nullable __autoreleasing * _Nullable)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,287 @@
+//
+//  AGRestTrafficRecorder.m
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 11/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestTrafficRecorder.h"
+
+#import "Bolts.h"
+#import <libkern/OSAtomic.h>
+
+#import "AGRestRequest.h"
+#import "AGRestRequest_Private.h"
+#import "AGRestResponse.h"
+#import "AGRestResponse_Private.h"
+#import "AGRestRequestTrace.h"
+#import "AGRestErrorUtilities.h"
+#import "AGRestLogger.h"
+
+#define kTrafficRecorderBufferSize  (32 * 1024)
+
+static const char       kTrafficCaptureMagic[4]     = { 'A', 'G', 'T', 'C' };
+static const uint8_t    kTrafficCaptureVersion      = 1;
+static const NSUInteger kTrafficCaptureHeaderLength = 5;
+
+static NSString * const kTrafficRecordStartOffsetKey    = @"o";
+static NSString * const kTrafficRecordDurationKey       = @"d";
+static NSString * const kTrafficRecordRequestKey        = @"q";
+static NSString * const kTrafficRecordStatusCodeKey     = @"s";
+static NSString * const kTrafficRecordErrorDomainKey    = @"ed";
+static NSString * const kTrafficRecordErrorCodeKey      = @"ec";
+static NSString * const kTrafficRecordHeaderKey         = @"h";
+static NSString * const kTrafficRecordJSONDataKey       = @"j";
+static NSString * const kTrafficRecordRawDataKey        = @"b";
+
+#pragma mark - AGRestTrafficRecord
+#pragma mark -
+
+@interface AGRestTrafficRecord ()
+
+@property (nonatomic, assign, readwrite) NSTimeInterval     startOffset;
+@property (nonatomic, assign, readwrite) NSTimeInterval     duration;
+@property (nonatomic, copy, readwrite) NSDictionary         *requestDictionary;
+@property (nonatomic, assign, readwrite) NSInteger          statusCode;
+@property (nonatomic, strong, readwrite) NSError            *error;
+@property (nonatomic, copy, readwrite) NSDictionary         *responseHeader;
+@property (nonatomic, strong, readwrite) id                 responseData;
+
++ (nullable instancetype)recordWithDictionary:(NSDictionary *)dictionary;
+
+@end
+
+@implementation AGRestTrafficRecord
+
++ (nullable instancetype)recordWithDictionary:(NSDictionary *)dictionary {
+    if (![dictionary isKindOfClass:[NSDictionary class]] ||
+        ![dictionary[kTrafficRecordRequestKey] isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+    AGRestTrafficRecord *record = [[AGRestTrafficRecord alloc] init];
+    record.startOffset = [dictionary[kTrafficRecordStartOffsetKey] doubleValue];
+    record.duration = [dictionary[kTrafficRecordDurationKey] doubleValue];
+    record.requestDictionary = dictionary[kTrafficRecordRequestKey];
+    record.statusCode = [dictionary[kTrafficRecordStatusCodeKey] integerValue];
+    if (dictionary[kTrafficRecordErrorDomainKey]) {
+        record.error = [NSError errorWithDomain:dictionary[kTrafficRecordErrorDomainKey]
+                                           code:[dictionary[kTrafficRecordErrorCodeKey] integerValue]
+                                       userInfo:nil];
+    }
+    record.responseHeader = dictionary[kTrafficRecordHeaderKey];
+    if (dictionary[kTrafficRecordJSONDataKey]) {
+        record.responseData = dictionary[kTrafficRecordJSONDataKey];
+    } else if (dictionary[kTrafficRecordRawDataKey]) {
+        record.responseData = [[NSData alloc] initWithBase64EncodedString:dictionary[kTrafficRecordRawDataKey] options:0];
+    }
+    return record;
+}
+
+- (AGRestRequest *)request {
+    return [AGRestRequest requestWithDictionary:self.requestDictionary];
+}
+
+@end
+
+#pragma mark - AGRestTrafficRecorder
+#pragma mark -
+
+@interface AGRestTrafficRecorder () {
+    dispatch_queue_t    _writeQueue;
+    NSFileHandle        *_fileHandle;
+    NSMutableData       *_buffer;
+    NSDate              *_startDate;
+    volatile int64_t    _recordCount;
+}
+
+@property (nonatomic, copy, readwrite) NSString         *filePath;
+
+- (instancetype)initWithFilePath:(NSString *)filePath fileHandle:(NSFileHandle *)fileHandle;
+
+- (nullable NSData *)_recordDataWithRequest:(AGRestRequest *)request response:(AGRestResponse *)response;
+
+// On the write queue.
+- (void)_writeBuffer;
+
+@end
+
+@implementation AGRestTrafficRecorder
+
+#pragma mark - Init
+#pragma mark -
+
++ (nullable instancetype)recorderWithFilePath:(NSString *)filePath
+                                        error:(NSError * __autoreleasing *)error
+{
+    NSMutableData *header = [NSMutableData dataWithBytes:kTrafficCaptureMagic length:sizeof(kTrafficCaptureMagic)];
+    [header appendBytes:&kTrafficCaptureVersion length:sizeof(kTrafficCaptureVersion)];
+    if (![header writeToFile:filePath options:NSDataWritingAtomic error:error]) {
+        return nil;
+    }
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingAtPath:filePath];
+    if (!fileHandle) {
+        if (error) {
+            *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal
+                                                 message:[NSString stringWithFormat:@"<AGRestTrafficRecorder> Can't open %@.", filePath]
+                                               shouldLog:NO];
+        }
+        return nil;
+    }
+    [fileHandle seekToEndOfFile];
+    return [[AGRestTrafficRecorder alloc] initWithFilePath:filePath fileHandle:fileHandle];
+}
+
+- (instancetype)initWithFilePath:(NSString *)filePath fileHandle:(NSFileHandle *)fileHandle {
+    self = [super init];
+    if (!self) return nil;
+
+    _filePath = [filePath copy];
+    _fileHandle = fileHandle;
+    _buffer = [NSMutableData dataWithCapacity:kTrafficRecorderBufferSize];
+    _startDate = [NSDate date];
+    _writeQueue = dispatch_queue_create("com.AGRest.capture.recorderQueue", DISPATCH_QUEUE_SERIAL);
+
+    return self;
+}
+
+#pragma mark - Record
+#pragma mark -
+
+- (void)recordRequest:(AGRestRequest *)request response:(AGRestResponse *)response {
+    OSAtomicIncrement64Barrier(&_recordCount);
+    dispatch_async(_writeQueue, ^{
+        if (!_fileHandle) {
+            return;
+        }
+        NSData *recordData = [self _recordDataWithRequest:request response:response];
+        if (!recordData) {
+            return;
+        }
+        uint32_t length = CFSwapInt32HostToLittle((uint32_t)recordData.length);
+        [_buffer appendBytes:&length length:sizeof(length)];
+        [_buffer appendData:recordData];
+        if (_buffer.length >= kTrafficRecorderBufferSize) {
+            [self _writeBuffer];
+        }
+    });
+}
+
+- (NSUInteger)recordCount {
+    return (NSUInteger)OSAtomicAdd64Barrier(0, &_recordCount);
+}
+
+- (BFTask *)flushAsync {
+    BFTaskCompletionSource *completionSource = [BFTaskCompletionSource taskCompletionSource];
+    dispatch_async(_writeQueue, ^{
+        [self _writeBuffer];
+        [completionSource setResult:nil];
+    });
+    return completionSource.task;
+}
+
+- (BFTask *)closeAsync {
+    BFTaskCompletionSource *completionSource = [BFTaskCompletionSource taskCompletionSource];
+    dispatch_async(_writeQueue, ^{
+        [self _writeBuffer];
+        [_fileHandle closeFile];
+        _fileHandle = nil;
+        [completionSource setResult:nil];
+    });
+    return completionSource.task;
+}
+
+#pragma mark - Private()
+#pragma mark -
+
+- (nullable NSData *)_recordDataWithRequest:(AGRestRequest *)request response:(AGRestResponse *)response {
+    AGRestRequestTrace *trace = response.trace;
+    NSDate *startDate = trace.startDate ?: [NSDate date];
+
+    NSMutableDictionary *record = [NSMutableDictionary dictionaryWithCapacity:8];
+    record[kTrafficRecordStartOffsetKey] = @(MAX([startDate timeIntervalSinceDate:_startDate], 0));
+    record[kTrafficRecordDurationKey] = @(trace.totalDuration);
+    record[kTrafficRecordRequestKey] = [request dictionaryRepresentation];
+    record[kTrafficRecordStatusCodeKey] = @([response httpStatusCode]);
+    if (response.responseError) {
+        record[kTrafficRecordErrorDomainKey] = response.responseError.domain;
+        record[kTrafficRecordErrorCodeKey] = @(response.responseError.code);
+    }
+    if (self.recordsResponseData) {
+        record[kTrafficRecordHeaderKey] = [response responseHeader];
+        // The public accessor would run the decoder, and the user's mapping, on the write queue.
+        id responseData = [response _rawResponseData];
+        if ([responseData isKindOfClass:[NSData class]]) {
+            record[kTrafficRecordRawDataKey] = [(NSData *)responseData base64EncodedStringWithOptions:0];
+        } else if (responseData && [NSJSONSerialization isValidJSONObject:responseData]) {
+            record[kTrafficRecordJSONDataKey] = responseData;
+        }
+    }
+
+    if (![NSJSONSerialization isValidJSONObject:record]) {
+        AGRestLogWarn(@"<AGRestTrafficRecorder> Request <%@> can't be recorded.", request.requestIdentifier);
+        return nil;
+    }
+    return [NSJSONSerialization dataWithJSONObject:record options:0 error:nil];
+}
+
+- (void)_writeBuffer {
+    if (!_buffer.length || !_fileHandle) {
+        return;
+    }
+    @try {
+        [_fileHandle writeData:_buffer];
+    } @catch (NSException *exception) {
+        AGRestLogError(@"<AGRestTrafficRecorder> Can't write to %@ : %@", self.filePath, exception.reason);
+        [_fileHandle closeFile];
+        _fileHandle = nil;
+    }
+    [_buffer setLength:0];
+}
+
+#pragma mark - Read
+#pragma mark -
+
++ (nullable NSArray<AGRestTrafficRecord *> *)recordsWithContentsOfFile:(NSString *)filePath
+                                                                 error:(NSError * __autoreleasing *)error
+{
+    NSData *data = [NSData dataWithContentsOfFile:filePath options:NSDataReadingMappedIfSafe error:error];
+    if (!data) {
+        return nil;
+    }
+    const uint8_t *bytes = data.bytes;
+    if (data.length < kTrafficCaptureHeaderLength ||
+        memcmp(bytes, kTrafficCaptureMagic, sizeof(kTrafficCaptureMagic)) != 0 ||
+        bytes[sizeof(kTrafficCaptureMagic)] != kTrafficCaptureVersion) {
+        if (error) {
+            *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal
+                                                 message:[NSString stringWithFormat:@"<AGRestTrafficRecorder> %@ isn't a capture file.", filePath]
+                                               shouldLog:NO];
+        }
+        return nil;
+    }
+
+    NSMutableArray *records = [NSMutableArray array];
+    NSUInteger offset = kTrafficCaptureHeaderLength;
+    while (offset + sizeof(uint32_t) <= data.length) {
+        uint32_t length = 0;
+        memcpy(&length, bytes + offset, sizeof(length));
+        length = CFSwapInt32LittleToHost(length);
+        offset += sizeof(length);
+        if (offset + length > data.length) {
+            break;
+        }
+        NSData *recordData = [data subdataWithRange:NSMakeRange(offset, length)];
+        offset += length;
+
+        id object = [NSJSONSerialization JSONObjectWithData:recordData options:0 error:nil];
+        AGRestTrafficRecord *record = [AGRestTrafficRecord recordWithDictionary:object];
+        if (!record) {
+            break;
+        }
+        [records addObject:record];
+    }
+    return records;
+}
+
+@end
@@ -0,0 +1,84 @@
+//
+//  AGRestTrafficReplayer.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 11/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class BFTask;
+@class BFCancellationToken;
+@class AGRestTrafficRecord;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class AGRestTrafficReplayer
+
+ @discussion Sends again the requests of a capture written by AGRestTrafficRecorder, through the framework, so that
+ the load of a production session can be reproduced against a local server.
+
+ Requests are sent in the order they were submitted when captured, each after the same delay from the start of the
+ replay as it had from the start of the capture, divided by `speed`. With a speed of 0 they are sent as fast as possible.
+ Replayed requests ignore the cache and aren't mapped to objects, so that each of them reaches the server.
+ */
+@interface AGRestTrafficReplayer : NSObject
+
+/*!
+ @abstract The records to replay, sorted by start offset.
+ */
+@property (nonatomic, copy, readonly) NSArray<AGRestTrafficRecord *> *records;
+
+/*!
+ @abstract Base url the requests are sent to instead of the captured one, e.g. the url of a local server. Nil by default.
+ */
+@property (nonatomic, copy, nullable) NSString      *baseUrl;
+
+/*!
+ @abstract Pace of the replay, 1 for the captured pace, N for N times faster, 0 for as fast as possible. 1 by default.
+ */
+@property (nonatomic, assign) double                speed;
+
+/*!
+ @abstract Maximum number of requests in flight, 0 for no limit. 0 by default.
+ @discussion When the limit is reached, requests are sent late rather than dropped.
+ */
+@property (nonatomic, assign) NSUInteger            maxConcurrentRequests;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Creates a replayer for the given records.
+ @param records The records, in any order.
+ */
+- (instancetype)initWithRecords:(NSArray<AGRestTrafficRecord *> *)records;
+
+/*!
+ @abstract Creates a replayer for the records of a capture file.
+ @param filePath    The path of the capture file.
+ @param error       The error if the file can't be read.
+ @return A replayer, nil with error otherwise.
+ */
++ (nullable instancetype)replayerWithContentsOfFile:(NSString *)filePath
+                                              error:(NSError * _Nullable __autoreleasing * _Nullable)error;
+
+/*!
+ @abstract Replays the requests. AGRest must be initialized.
+ @return A BFTask resolving to an NSArray of AGRestResponse, or NSNull for the requests that couldn't be sent,
+ in the order of `records`, once all the requests completed.
+ */
+- (BFTask *)replayAsync;
+
+/*!
+ @abstract Replays the requests. AGRest must be initialized.
+ @param cancellationToken Stops sending requests and cancels the ones in flight.
+ @return A BFTask resolving to an NSArray of AGRestResponse, or NSNull for the requests that couldn't be sent,
+ in the order of `records`, once all the requests completed.
+ */
+- (BFTask *)replayAsyncWithCancellationToken:(nullable BFCancellationToken *)cancellationToken;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,148 @@
+//
+//  AGRestTrafficReplayer.m
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 11/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestTrafficReplayer.h"
+
+#import "Bolts.h"
+
+#import "AGRestRequest.h"
+#import "AGRestTrafficRecorder.h"
+#import "AGRestPipelineInstrumentation.h"
+#import "AGRestLogger.h"
+
+@interface AGRestTrafficReplayer ()
+
+@property (nonatomic, copy, readwrite) NSArray<AGRestTrafficRecord *> *records;
+
+- (nullable AGRestRequest *)_requestForRecord:(AGRestTrafficRecord *)record;
+
+@end
+
+@implementation AGRestTrafficReplayer
+
+#pragma mark - Init
+#pragma mark -
+
+- (instancetype)initWithRecords:(NSArray<AGRestTrafficRecord *> *)records {
+    self = [super init];
+    if (!self) return nil;
+
+    // Records are written as the requests complete, replay them as they were submitted.
+    _records = [records sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(AGRestTrafficRecord *record1, AGRestTrafficRecord *record2) {
+        if (record1.startOffset == record2.startOffset) {
+            return NSOrderedSame;
+        }
+        return (record1.startOffset < record2.startOffset) ? NSOrderedAscending : NSOrderedDescending;
+    }];
+    _speed = 1.0;
+
+    return self;
+}
+
++ (nullable instancetype)replayerWithContentsOfFile:(NSString *)filePath
+                                              error:(NSError * __autoreleasing *)error
+{
+    NSArray *records = [AGRestTrafficRecorder recordsWithContentsOfFile:filePath error:error];
+    if (!records) {
+        return nil;
+    }
+    return [[self alloc] initWithRecords:records];
+}
+
+#pragma mark - Replay
+#pragma mark -
+
+- (BFTask *)replayAsync {
+    return [self replayAsyncWithCancellationToken:nil];
+}
+
+- (BFTask *)replayAsyncWithCancellationToken:(nullable BFCancellationToken *)cancellationToken {
+    NSArray<AGRestTrafficRecord *> *records = self.records;
+    double speed = self.speed;
+    NSUInteger maxConcurrentRequests = self.maxConcurrentRequests;
+
+    BFTaskCompletionSource *completionSource = [BFTaskCompletionSource taskCompletionSource];
+    NSMutableArray<AGRestRequest *> *sentRequests = [NSMutableArray arrayWithCapacity:records.count];
+    [cancellationToken registerCancellationObserverWithBlock:^{
+        @synchronized(sentRequests) {
+            [sentRequests makeObjectsPerformSelector:@selector(cancel)];
+        }
+    }];
+
+    // The pacing loop sleeps between the requests, on its own queue.
+    dispatch_queue_t replayQueue = dispatch_queue_create("com.AGRest.capture.replayQueue", DISPATCH_QUEUE_SERIAL);
+    dispatch_async(replayQueue, ^{
+        dispatch_semaphore_t window = (maxConcurrentRequests) ? dispatch_semaphore_create((long)maxConcurrentRequests) : NULL;
+        NSMutableArray<BFTask *> *tasks = [NSMutableArray arrayWithCapacity:records.count];
+        NSTimeInterval firstOffset = records.firstObject.startOffset;
+        NSTimeInterval startTime = AGRestPipelineCurrentTime();
+
+        for (AGRestTrafficRecord *record in records) {
+            if (cancellationToken.cancellationRequested) {
+                break;
+            }
+            if (speed > 0) {
+                NSTimeInterval wait = (record.startOffset - firstOffset) / speed - (AGRestPipelineCurrentTime() - startTime);
+                if (wait > 0) {
+                    [NSThread sleepForTimeInterval:wait];
+                }
+            }
+            if (window) {
+                dispatch_semaphore_wait(window, DISPATCH_TIME_FOREVER);
+            }
+
+            AGRestRequest *request = [self _requestForRecord:record];
+            BFTask *task = [request sendRequestInBackground];
+            if (!task) {
+                if (window) {
+                    dispatch_semaphore_signal(window);
+                }
+                [tasks addObject:[BFTask taskWithResult:nil]];
+                continue;
+            }
+            @synchronized(sentRequests) {
+                [sentRequests addObject:request];
+            }
+            [tasks addObject:[task continueWithBlock:^id(BFTask *task) {
+                if (window) {
+                    dispatch_semaphore_signal(window);
+                }
+                return task;
+            }]];
+        }
+
+        AGRestLogInfo(@"<AGRestTrafficReplayer> Sent %lu of %lu requests in %.1f s.",
+                      (unsigned long)tasks.count, (unsigned long)records.count, AGRestPipelineCurrentTime() - startTime);
+
+        [[BFTask taskForCompletionOfAllTasks:tasks] continueWithBlock:^id(BFTask *task) {
+            NSMutableArray *responses = [[tasks valueForKey:@"result"] mutableCopy];
+            // Requests left unsent once cancelled.
+            while (responses.count < records.count) {
+                [responses addObject:[NSNull null]];
+            }
+            [completionSource setResult:responses];
+            return nil;
+        }];
+    });
+    return completionSource.task;
+}
+
+#pragma mark - Private()
+#pragma mark -
+
+- (nullable AGRestRequest *)_requestForRecord:(AGRestTrafficRecord *)record {
+    AGRestRequest *request = [record request];
+    if (self.baseUrl) {
+        request.baseUrl = self.baseUrl;
+    }
+    request.cachePolicy = kAGRestRequestIgnoreCache;
+    request.objectMappingEnabled = NO;
+    return request;
+}
+
+@end
@@ -11,6 +11,7 @@
 #import "AGRestDataProvider.h"
 
 @class AGRestCore;
+@class BFTask;
 
 @protocol AGRestResponseSerializerProtocol;
 @protocol AGRestSessionProtocol;
@@ -19,6 +20,8 @@
 @protocol AGRestSessionStoreProtocol;
 @protocol AGRestResponseSerializerProtocol;
 @protocol AGRestLogging;
+@protocol AGRestMetricsCollecting;
+@class AGRestTrafficRecorder;
 
 /*!
  @class AGRestManager
@@ -33,7 +36,9 @@ AGRestSessionStoreProvider,
 AGRestServerProvider,
 AGRestResponseSerializerProvider,
 AGRestKeyValueCacheProvider,
-AGRestLoggerProvider>
+AGRestLoggerProvider,
+AGRestMetricsProvider,
+AGRestCircuitBreakerProvider>
 
 @property (nonatomic, copy, readonly) NSString                      *baseUrl;
 
@@ -48,6 +53,39 @@ AGRestLoggerProvider>
 @property (nonatomic, strong) id<AGRestResponseSerializerProtocol>  responseSerializer;
 @property (nonatomic, strong) id<AGRestKeyValueCaching>             keyValueCache;
 @property (nonatomic, strong) id<AGRestLogging>                     logger;
+@property (nonatomic, strong) id<AGRestMetricsCollecting>           metrics;
+
+/*!
+ @abstract Recorder of the completed requests, nil unless a capture was started.
+ */
+@property (nonatomic, strong, nullable) AGRestTrafficRecorder       *trafficRecorder;
+
+/*!
+ @abstract Circuits of the endpoints, kept when the request runner is replaced.
+ */
+@property (nonatomic, strong, readonly) AGRestCircuitBreaker        *circuitBreaker;
+
+/*!
+ @abstract Servers added with `addServer:forBaseUrl:`, keyed by host.
+ */
+@property (nonatomic, copy, readonly) NSDictionary<NSString *, id<AGRestServerProtocol>> *additionalServers;
+
+/*!
+ @abstract Urls of the hosts connected to by `warmUpConnections`, in addition to the base url host.
+ */
+@property (nonatomic, copy) NSArray<NSString *>                     *warmUpHosts;
+/*!
+ @abstract Whether `preload` warms up the connections. Disabled by default.
+ */
+@property (nonatomic, assign, getter=isConnectionWarmUpEnabled) BOOL connectionWarmUpEnabled;
+/*!
+ @abstract Task of the last connection warm-up, nil if none was started.
+ */
+@property (nonatomic, strong, readonly) BFTask                      *connectionWarmUpTask;
+/*!
+ @abstract Task returned by `preload`, nil until it's called.
+ */
+@property (nonatomic, strong, readonly) BFTask                      *preloadTask;
 
 ///-----------------------
 /// @name Init
@@ -56,7 +94,38 @@ AGRestLoggerProvider>
 - (instancetype)init NS_UNAVAILABLE;
 - (instancetype)initWithBaseUrl:(NSString *)baseUrl;
 
-- (void)preload;
+/*!
+ @abstract Load the modules in background, concurrently when they don't depend on each other.
+ @discussion Modules are still created on first access, so they can be used before the task completes.
+ The request server is created before returning, so a base url it can't be initialized with raises
+ NSInternalInconsistencyException on the calling thread. Calling it again returns the task of the first call.
+ @return A BFTask completing once every module is loaded. The time it took is logged.
+ */
+- (BFTask *)preload;
 - (void)reset;
 
+/*!
+ @abstract Send the requests to the host of `baseUrl` through `server` instead of `requestServer`.
+ @discussion Requests are routed by the scheme, host and port of their base url. Adding a server for a host replaces
+ the previous one.
+ @param server  The server.
+ @param baseUrl The base url of the requests to send through the server.
+ @return NO if `baseUrl` has no host.
+ */
+- (BOOL)addServer:(id<AGRestServerProtocol>)server forBaseUrl:(NSString *)baseUrl;
+
+/*!
+ @abstract Return the server sending the requests to the host of `baseUrl`, `requestServer` if none was added for it.
+ */
+- (id<AGRestServerProtocol>)requestServerForBaseUrl:(nullable NSString *)baseUrl;
+
+/*!
+ @abstract Connect to the base url host and to `warmUpHosts` in background, through the server each host is sent through.
+ @discussion Each connection is logged, handed to the logger trace and recorded by the metrics collector as a HEAD
+ request to its host, so that the cost of DNS, TCP and TLS at startup can be verified.
+ @return A BFTask resolving to an NSArray of AGRestResponse, one per host. Does nothing if the request server
+ doesn't implement `warmUpConnectionsToURLs:`.
+ */
+- (BFTask *)warmUpConnections;
+
 @end
@@ -8,9 +8,12 @@
 
 #import "AGRestManager.h"
 
+#import <pthread.h>
+
 #import "AGRestCore.h"
 #import "AGRestServer.h"
 #import "AGRestRequestRunner.h"
+#import "AGRestCircuitBreaker.h"
 #import "AGRestRequestCache.h"
 #import "AGRestObjectMapper.h"
 #import "AGRestSessionController.h"
@@ -19,10 +22,27 @@
 #import "AGRestResponseSerializer.h"
 #import "AGRestKeyValueCache.h"
 #import "AGRestLogger.h"
+#import "AGRestMetrics.h"
+#import "AGRestTrafficRecorder.h"
+#import "AGRestResponse.h"
+#import "AGRestRequestTrace.h"
+#import "AGRestPipelineInstrumentation.h"
+#import "BFTask+Private.h"
+
+/*!
+ @abstract Read a module slot, the module returned is retained by the caller even if it is replaced meanwhile.
+ */
+#define AGRestManagerLoadModule(ivar)               [self _loadModuleInSlot:(__strong id *)&(ivar)]
+/*!
+ @abstract Replace a module slot, once everything the module initialized is visible to the other threads.
+ */
+#define AGRestManagerPublishModule(ivar, module)    [self _publishModule:(module) inSlot:(__strong id *)&(ivar)]
 
 @interface AGRestManager() <AGRestCoreManagerDataSource> {
     dispatch_queue_t _eventuallyQueueAccessQueue;
     dispatch_queue_t _loggerAccessQueue;
+    dispatch_queue_t _metricsAccessQueue;
+    dispatch_queue_t _trafficRecorderAccessQueue;
     dispatch_queue_t _fileManagerAccessQueue;
     dispatch_queue_t _requestRunnerAccessQueue;
     dispatch_queue_t _requestServerAccessQueue;
@@ -33,6 +53,13 @@
     dispatch_queue_t _objectMapperAccessQueue;
     dispatch_queue_t _responseSerializerAccessQueue;
     dispatch_queue_t _preloadQueue;
+    dispatch_queue_t _warmUpAccessQueue;
+    
+    // Guards the loads and stores of the module slots, held only to retain or swap a module.
+    pthread_mutex_t _modulesMutex;
+    
+    // Servers added per host, replaced as a whole under `_requestServerAccessQueue`.
+    NSDictionary<NSString *, id<AGRestServerProtocol>> *_additionalServers;
 }
 
 @end
@@ -51,9 +78,16 @@
 @synthesize eventuallyQueue = _eventuallyQueue;
 @synthesize fileManager = _fileManager;
 @synthesize logger = _logger;
+@synthesize metrics = _metrics;
+@synthesize trafficRecorder = _trafficRecorder;
+@synthesize circuitBreaker = _circuitBreaker;
+@synthesize connectionWarmUpTask = _connectionWarmUpTask;
+@synthesize preloadTask = _preloadTask;
+@synthesize additionalServers = _additionalServers;
 
 - (void)dealloc {
     [self reset];
+    pthread_mutex_destroy(&_modulesMutex);
 }
 
 - (instancetype)initWithBaseUrl:(NSString *)baseUrl {
@@ -61,6 +95,8 @@
     self = [super init];
     if (!self) return nil;
     
+    pthread_mutex_init(&_modulesMutex, NULL);
+    
     _coreAccessQueue                = dispatch_queue_create("com.AGRest.core.coreAccessQueue",              DISPATCH_QUEUE_SERIAL);
     _requestRunnerAccessQueue       = dispatch_queue_create("com.AGRest.core.requesrRunnerAccessQueue",     DISPATCH_QUEUE_SERIAL);
     _requestServerAccessQueue       = dispatch_queue_create("com.AGRest.core.requestServerAccessQueue",     DISPATCH_QUEUE_SERIAL);
@@ -73,63 +109,123 @@
     _fileManagerAccessQueue         = dispatch_queue_create("com.AGRest.core.fileManagerAcceessQueue",      DISPATCH_QUEUE_SERIAL);
     _preloadQueue                   = dispatch_queue_create("com.AGRest.core.preloadAccessQueue",           DISPATCH_QUEUE_SERIAL);
     _loggerAccessQueue              = dispatch_queue_create("com.AGRest.core.loggerAccessQueue",            DISPATCH_QUEUE_SERIAL);
+    _metricsAccessQueue             = dispatch_queue_create("com.AGRest.core.metricsAccessQueue",           DISPATCH_QUEUE_SERIAL);
+    _trafficRecorderAccessQueue     = dispatch_queue_create("com.AGRest.core.trafficRecorderAccessQueue",   DISPATCH_QUEUE_SERIAL);
+    _warmUpAccessQueue              = dispatch_queue_create("com.AGRest.core.warmUpAccessQueue",            DISPATCH_QUEUE_SERIAL);
+    
+    _circuitBreaker                 = [[AGRestCircuitBreaker alloc] init];
     
     self.baseUrl = baseUrl;
     
     return self;
 }
 
-- (void)preload {
+- (BFTask *)preload {
     
     if ([AGRest isLoggingEnabled]) {
-        AGRestLogInfo(@"<AGRest> Initialize rest with base url : %@", _baseUrl);
+        AGRestLogInfo(@"<AGRest> Initialize rest with base url : %@", self.baseUrl);
     }
+    
+    // The only module failing on a bad configuration, it raises here rather than in a background task.
+    id<AGRestServerProtocol> requestServer = [self requestServer];
+    
+    __block BFTask *preloadTask = nil;
     dispatch_sync(_preloadQueue, ^{
-        // Load the file manager
-        [self fileManager];
-        // Load KeyValue Cache
-        [self keyValueCache];
-        // Load Server
-        [self requestServer];
-        // Load request runner
-        [self requestRunner];
-        // Load core
-        [self core];
-        // Load the eventually queue
-        [self eventuallyQueue];
+        if (_preloadTask) {
+            preloadTask = _preloadTask;
+            return;
+        }
+        
+        NSTimeInterval startTime = AGRestPipelineCurrentTime();
+        BFExecutor *executor = [BFExecutor defaultPriorityBackgroundExecutor];
+        
+        // Modules independent from each other load concurrently, each accessor creates its module once.
+        BFTask *fileManagerTask = [BFTask taskFromExecutor:executor withBlock:^id{
+            return [self fileManager];
+        }];
+        BFTask *metricsTask = [BFTask taskFromExecutor:executor withBlock:^id{
+            return [self metrics];
+        }];
+        BFTask *keyValueCacheTask = [BFTask taskFromExecutor:executor withBlock:^id{
+            return [self keyValueCache];
+        }];
+        BFTask *requestRunnerTask = [BFTask taskFromExecutor:executor withBlock:^id{
+            return [self requestRunner];
+        }];
+        BFTask *coreTask = [BFTask taskFromExecutor:executor withBlock:^id{
+            return [self core];
+        }];
+        // The eventually queue runs its requests with the runner and keeps them in the file manager directory.
+        BFTask *eventuallyQueueTask = [[BFTask taskForCompletionOfAllTasks:@[ fileManagerTask, requestRunnerTask ]]
+                                       continueWithExecutor:executor withBlock:^id(BFTask *task) {
+            return [self eventuallyQueue];
+        }];
+        
+        NSArray *tasks = @[ fileManagerTask, metricsTask, keyValueCacheTask, [BFTask taskWithResult:requestServer],
+                            requestRunnerTask, coreTask, eventuallyQueueTask ];
+        _preloadTask = [[BFTask taskForCompletionOfAllTasks:tasks] continueWithBlock:^id(BFTask *task) {
+            if (task.faulted) {
+                AGRestLogError(@"<AGRest> Modules failed to load : %@", task.error);
+            } else if ([AGRest isLoggingEnabled]) {
+                AGRestLogInfo(@"<AGRest> Modules loaded in %.1f ms.", (AGRestPipelineCurrentTime() - startTime) * 1000.0);
+            }
+            return task;
+        }];
+        preloadTask = _preloadTask;
     });
-    if ([AGRest isLoggingEnabled]) {
-        AGRestLogInfo(@"<AGRest> Modules loaded.");
+    
+    if (self.connectionWarmUpEnabled) {
+        // Connect in background, it mustn't delay the initialization.
+        [self warmUpConnections];
     }
+    return preloadTask;
+}
+
+- (BFTask *)preloadTask {
+    __block BFTask *preloadTask = nil;
+    dispatch_sync(_preloadQueue, ^{
+        preloadTask = _preloadTask;
+    });
+    return preloadTask;
 }
 
 - (void)reset {
-    _fileManager = nil;
-    _keyValueCache = nil;
-    _requestRunner = nil;
-    _eventuallyQueue = nil;
-    [_requestServer reset];
-    _requestRunner = nil;
-    _core = nil;
+    // The modules are reloaded by the next preload.
+    dispatch_sync(_preloadQueue, ^{
+        _preloadTask = nil;
+    });
+    AGRestManagerPublishModule(_fileManager, nil);
+    AGRestManagerPublishModule(_keyValueCache, nil);
+    AGRestManagerPublishModule(_eventuallyQueue, nil);
+    [AGRestManagerLoadModule(_requestServer) reset];
+    for (id<AGRestServerProtocol> server in [AGRestManagerLoadModule(_additionalServers) allValues]) {
+        [server reset];
+    }
+    AGRestManagerPublishModule(_additionalServers, nil);
+    AGRestManagerPublishModule(_requestRunner, nil);
+    [_circuitBreaker reset];
+    AGRestManagerPublishModule(_core, nil);
 }
 
 #pragma mark - Core
 #pragma mark -
 
 - (AGRestCore *)core {
-    __block AGRestCore *core = nil;
-    dispatch_sync(_coreAccessQueue, ^{
-        if (!_core) {
-            _core = [AGRestCore coreWithDataSource:self baseUrl:self.baseUrl];
-        }
-        core = _core;
-    });
+    AGRestCore *core = AGRestManagerLoadModule(_core);
+    if (!core) {
+        dispatch_sync(_coreAccessQueue, ^{
+            if (!AGRestManagerLoadModule(_core)) {
+                AGRestManagerPublishModule(_core, [AGRestCore coreWithDataSource:self baseUrl:self.baseUrl]);
+            }
+        });
+        core = AGRestManagerLoadModule(_core);
+    }
     return core;
 }
 
 - (void)setCore:(AGRestCore *)core {
     dispatch_sync(_coreAccessQueue, ^{
-        _core = core;
+        AGRestManagerPublishModule(_core, core);
     });
 }
 
@@ -138,31 +234,33 @@
 
 - (void)setBaseUrl:(NSString *)baseUrl {
     dispatch_sync(_coreAccessQueue, ^{
-        _baseUrl = baseUrl;
+        AGRestManagerPublishModule(_baseUrl, [baseUrl copy]);
     });
 }
 
 - (NSString *)baseUrl {
-    return _baseUrl;
+    return AGRestManagerLoadModule(_baseUrl);
 }
 
 #pragma mark - Object Mapper
 #pragma mark -
 
 - (id<AGRestObjectMapperProtocol>)objectMapper {
-    __block id<AGRestObjectMapperProtocol> objecMapper = nil;
-    dispatch_sync(_objectMapperAccessQueue, ^{
-        if (!_objectMapper) {
-            _objectMapper = [[AGRestObjectMapper alloc] init];
-        }
-        objecMapper = _objectMapper;
-    });
+    id<AGRestObjectMapperProtocol> objecMapper = AGRestManagerLoadModule(_objectMapper);
+    if (!objecMapper) {
+        dispatch_sync(_objectMapperAccessQueue, ^{
+            if (!AGRestManagerLoadModule(_objectMapper)) {
+                AGRestManagerPublishModule(_objectMapper, [[AGRestObjectMapper alloc] init]);
+            }
+        });
+        objecMapper = AGRestManagerLoadModule(_objectMapper);
+    }
     return objecMapper;
 }
 
 - (void)setObjectMapper:(id<AGRestObjectMapperProtocol>)objectMapper {
     dispatch_sync(_objectMapperAccessQueue, ^{
-        _objectMapper = objectMapper;
+        AGRestManagerPublishModule(_objectMapper, objectMapper);
     });
 }
 
@@ -170,22 +268,24 @@
 #pragma mark -
 
 - (id<AGRestSessionProtocol>)sessionController {
-    __block id<AGRestSessionProtocol> sessionController = nil;
-    dispatch_sync(_sessionControllerAccessQueue, ^{
-        if (!_sessionController) {
-            _sessionController = [[AGRestSessionController alloc] initWithDataSource:self];
-        }
-        sessionController = _sessionController;
-    });
+    id<AGRestSessionProtocol> sessionController = AGRestManagerLoadModule(_sessionController);
+    if (!sessionController) {
+        dispatch_sync(_sessionControllerAccessQueue, ^{
+            if (!AGRestManagerLoadModule(_sessionController)) {
+                AGRestManagerPublishModule(_sessionController, [[AGRestSessionController alloc] initWithDataSource:self]);
+            }
+        });
+        sessionController = AGRestManagerLoadModule(_sessionController);
+    }
     return sessionController;
 }
 
 - (void)setSessionController:(id<AGRestSessionProtocol>)sessionController {
     dispatch_async(_sessionControllerAccessQueue, ^{
-        _sessionController = sessionController;
-        if (![_sessionController dataSource]) {
-            [_sessionController setDataSource:self];
+        if (![sessionController dataSource]) {
+            [sessionController setDataSource:self];
         }
+        AGRestManagerPublishModule(_sessionController, sessionController);
     });
 }
 
@@ -193,19 +293,21 @@
 #pragma mark -
 
 - (id<AGRestSessionStoreProtocol>)sessionStore {
-    __block id<AGRestSessionStoreProtocol> sessionStore = nil;
-    dispatch_sync(_sessionStoreAccessQueue, ^{
-        if (!_sessionStore) {
-            _sessionStore = [[AGRestSessionStore alloc] init];
-        }
-        sessionStore = _sessionStore;
-    });
+    id<AGRestSessionStoreProtocol> sessionStore = AGRestManagerLoadModule(_sessionStore);
+    if (!sessionStore) {
+        dispatch_sync(_sessionStoreAccessQueue, ^{
+            if (!AGRestManagerLoadModule(_sessionStore)) {
+                AGRestManagerPublishModule(_sessionStore, [[AGRestSessionStore alloc] init]);
+            }
+        });
+        sessionStore = AGRestManagerLoadModule(_sessionStore);
+    }
     return sessionStore;
 }
 
 - (void)setSessionStore:(id<AGRestSessionStoreProtocol>)sessionStore {
     dispatch_sync(_sessionStoreAccessQueue, ^{
-        _sessionStore = sessionStore;
+        AGRestManagerPublishModule(_sessionStore, sessionStore);
     });
 }
 
@@ -213,19 +315,21 @@
 #pragma mark -
 
 - (id<AGRestKeyValueCaching>)keyValueCache {
-    __block id<AGRestKeyValueCaching> keyValueCache = nil;
-    dispatch_sync(_keyValueCacheAccessQueue, ^{
-        if (!_keyValueCache) {
-            _keyValueCache = [[AGRestKeyValueCache alloc] initWithDataSource:self];
-        }
-        keyValueCache = _keyValueCache;
-    });
+    id<AGRestKeyValueCaching> keyValueCache = AGRestManagerLoadModule(_keyValueCache);
+    if (!keyValueCache) {
+        dispatch_sync(_keyValueCacheAccessQueue, ^{
+            if (!AGRestManagerLoadModule(_keyValueCache)) {
+                AGRestManagerPublishModule(_keyValueCache, [[AGRestKeyValueCache alloc] initWithDataSource:self]);
+            }
+        });
+        keyValueCache = AGRestManagerLoadModule(_keyValueCache);
+    }
     return keyValueCache;
 }
 
 - (void)setKeyValueCache:(id<AGRestKeyValueCaching>)keyValueCache {
     dispatch_sync(_keyValueCacheAccessQueue, ^{
-        _keyValueCache = keyValueCache;
+        AGRestManagerPublishModule(_keyValueCache, keyValueCache);
     });
 }
 
@@ -234,17 +338,19 @@
 #pragma mark -
 
 - (id<AGRestServerProtocol>)requestServer {
-    __block id<AGRestServerProtocol> requestServer = nil;
-    dispatch_sync(_requestServerAccessQueue, ^{
-        if (!_requestServer) {
-            if ([AGRestServer initializeWithBaseUrl:_baseUrl]) {
-                _requestServer = [AGRestServer sharedServer];
-            } else {
-                [NSException raise:NSInternalInconsistencyException format:@"Server instance failed to initialize!"];
+    id<AGRestServerProtocol> requestServer = AGRestManagerLoadModule(_requestServer);
+    if (!requestServer) {
+        dispatch_sync(_requestServerAccessQueue, ^{
+            if (!AGRestManagerLoadModule(_requestServer) && [AGRestServer initializeWithBaseUrl:self.baseUrl]) {
+                AGRestManagerPublishModule(_requestServer, [AGRestServer sharedServer]);
             }
+        });
+        requestServer = AGRestManagerLoadModule(_requestServer);
+        // Raised outside of the access queue, which would stay locked otherwise.
+        if (!requestServer) {
+            [NSException raise:NSInternalInconsistencyException format:@"Server instance failed to initialize!"];
         }
-        requestServer = _requestServer;
-    });
+    }
     return requestServer;
 }
 
@@ -253,21 +359,52 @@
         [NSException raise:NSInternalInconsistencyException format:@"`serverInstance` can't be nil."];
     }
     dispatch_sync(_requestServerAccessQueue, ^{
-        _requestServer = requestServer;
+        AGRestManagerPublishModule(_requestServer, requestServer);
     });
 }
 
+- (BOOL)addServer:(id<AGRestServerProtocol>)server forBaseUrl:(NSString *)baseUrl {
+    NSString *serverKey = [[self class] _serverKeyForBaseUrl:baseUrl];
+    if (!server || !serverKey) {
+        return NO;
+    }
+    dispatch_sync(_requestServerAccessQueue, ^{
+        NSMutableDictionary *additionalServers = [NSMutableDictionary dictionaryWithDictionary:AGRestManagerLoadModule(_additionalServers)];
+        additionalServers[serverKey] = server;
+        AGRestManagerPublishModule(_additionalServers, [additionalServers copy]);
+    });
+    return YES;
+}
+
+- (id<AGRestServerProtocol>)requestServerForBaseUrl:(nullable NSString *)baseUrl {
+    NSDictionary *additionalServers = AGRestManagerLoadModule(_additionalServers);
+    if (additionalServers.count && baseUrl.length) {
+        NSString *serverKey = [[self class] _serverKeyForBaseUrl:baseUrl];
+        id<AGRestServerProtocol> server = (serverKey) ? additionalServers[serverKey] : nil;
+        if (server) {
+            return server;
+        }
+    }
+    return self.requestServer;
+}
+
+- (NSDictionary<NSString *, id<AGRestServerProtocol>> *)additionalServers {
+    return AGRestManagerLoadModule(_additionalServers) ?: @{};
+}
+
 #pragma mark - Request Runner
 #pragma mark -
 
 - (id<AGRestRequestRunning>)requestRunner {
-    __block id<AGRestRequestRunning> requestRunner = nil;
-    dispatch_sync(_requestRunnerAccessQueue, ^{
-        if (!_requestRunner) {
-            _requestRunner = [[AGRestRequestRunner alloc] initWithDataSource:self];
-        }
-        requestRunner = _requestRunner;
-    });
+    id<AGRestRequestRunning> requestRunner = AGRestManagerLoadModule(_requestRunner);
+    if (!requestRunner) {
+        dispatch_sync(_requestRunnerAccessQueue, ^{
+            if (!AGRestManagerLoadModule(_requestRunner)) {
+                AGRestManagerPublishModule(_requestRunner, [[AGRestRequestRunner alloc] initWithDataSource:self]);
+            }
+        });
+        requestRunner = AGRestManagerLoadModule(_requestRunner);
+    }
     return requestRunner;
 }
 
@@ -276,7 +413,7 @@
         if (!requestRunner) {
             [NSException raise:NSInternalInconsistencyException format:@"`requestRunner` can't be nil."];
         }
-        _requestRunner = requestRunner;
+        AGRestManagerPublishModule(_requestRunner, requestRunner);
     });
 }
 
@@ -284,13 +421,15 @@
 #pragma mark -
 
 - (id<AGRestResponseSerializerProtocol>)responseSerializer {
-    __block id<AGRestResponseSerializerProtocol> responseSerializer = nil;
-    dispatch_sync(_responseSerializerAccessQueue, ^{
-        if (!_responseSerializer) {
-            _responseSerializer = [[AGRestResponseSerializer alloc] initWithDataSource:self];
-        }
-        responseSerializer = _responseSerializer;
-    });
+    id<AGRestResponseSerializerProtocol> responseSerializer = AGRestManagerLoadModule(_responseSerializer);
+    if (!responseSerializer) {
+        dispatch_sync(_responseSerializerAccessQueue, ^{
+            if (!AGRestManagerLoadModule(_responseSerializer)) {
+                AGRestManagerPublishModule(_responseSerializer, [[AGRestResponseSerializer alloc] initWithDataSource:self]);
+            }
+        });
+        responseSerializer = AGRestManagerLoadModule(_responseSerializer);
+    }
     return responseSerializer;
 }
 
@@ -299,7 +438,7 @@
         if (!responseSerializer) {
             [NSException raise:NSInternalInconsistencyException format:@"`responseSerializer` can't be nil."];
         }
-        _responseSerializer = responseSerializer;
+        AGRestManagerPublishModule(_responseSerializer, responseSerializer);
     });
 }
 
@@ -307,17 +446,19 @@
 #pragma mark -
 
 - (AGRestEventuallyQueue *)eventuallyQueue {
-    __block AGRestEventuallyQueue *eventuallyQueue = nil;
-    dispatch_sync(_eventuallyQueueAccessQueue, ^{
-        if (!_eventuallyQueue) {
-            AGRestRequestCache *requestCache = [AGRestRequestCache cacheWithRequestRunner:self.requestRunner
-                                                                           cacheDirectory:self.fileManager.restCacheDirectory
-                                                                             maxCacheSize:(NSUInteger)AGRestRequestsCacheDefaultDiskCacheSize];
-            
-            _eventuallyQueue = requestCache;
-        }
-        eventuallyQueue = _eventuallyQueue;
-    });
+    AGRestEventuallyQueue *eventuallyQueue = AGRestManagerLoadModule(_eventuallyQueue);
+    if (!eventuallyQueue) {
+        dispatch_sync(_eventuallyQueueAccessQueue, ^{
+            if (!AGRestManagerLoadModule(_eventuallyQueue)) {
+                AGRestRequestCache *requestCache = [AGRestRequestCache cacheWithRequestRunner:self.requestRunner
+                                                                               cacheDirectory:self.fileManager.restCacheDirectory
+                                                                                 maxCacheSize:(NSUInteger)AGRestRequestsCacheDefaultDiskCacheSize];
+                
+                AGRestManagerPublishModule(_eventuallyQueue, requestCache);
+            }
+        });
+        eventuallyQueue = AGRestManagerLoadModule(_eventuallyQueue);
+    }
     return eventuallyQueue;
 }
 
@@ -325,13 +466,15 @@
 #pragma mark -
 
 - (AGRestFileManager *)fileManager {
-    __block AGRestFileManager * fileManager = nil;
-    dispatch_sync(_fileManagerAccessQueue, ^{
-        if (!_fileManager) {
-            _fileManager = [[AGRestFileManager alloc] initWithRestDirectory:[[self class] restRootDirectory]];
-        }
-        fileManager = _fileManager;
-    });
+    AGRestFileManager * fileManager = AGRestManagerLoadModule(_fileManager);
+    if (!fileManager) {
+        dispatch_sync(_fileManagerAccessQueue, ^{
+            if (!AGRestManagerLoadModule(_fileManager)) {
+                AGRestManagerPublishModule(_fileManager, [[AGRestFileManager alloc] initWithRestDirectory:[[self class] restRootDirectory]]);
+            }
+        });
+        fileManager = AGRestManagerLoadModule(_fileManager);
+    }
     return fileManager;
 }
 
@@ -339,25 +482,154 @@
 #pragma mark -
 
 - (id<AGRestLogging>)logger {
-    __block id<AGRestLogging> logger = nil;
-    dispatch_sync(_loggerAccessQueue, ^{
-        if (!_logger) {
-            _logger = [AGRestLogger sharedLogger];
-        }
-        logger = _logger;
-    });
+    id<AGRestLogging> logger = AGRestManagerLoadModule(_logger);
+    if (!logger) {
+        dispatch_sync(_loggerAccessQueue, ^{
+            if (!AGRestManagerLoadModule(_logger)) {
+                AGRestManagerPublishModule(_logger, [AGRestLogger sharedLogger]);
+            }
+        });
+        logger = AGRestManagerLoadModule(_logger);
+    }
     return logger;
 }
 
 - (void)setLogger:(id<AGRestLogging>)logger {
     dispatch_sync(_loggerAccessQueue, ^{
-        _logger = logger;
+        AGRestManagerPublishModule(_logger, logger);
     });
 }
 
+#pragma mark - Metrics
+#pragma mark -
+
+- (id<AGRestMetricsCollecting>)metrics {
+    id<AGRestMetricsCollecting> metrics = AGRestManagerLoadModule(_metrics);
+    if (!metrics) {
+        dispatch_sync(_metricsAccessQueue, ^{
+            if (!AGRestManagerLoadModule(_metrics)) {
+                AGRestManagerPublishModule(_metrics, [[AGRestMetrics alloc] init]);
+            }
+        });
+        metrics = AGRestManagerLoadModule(_metrics);
+    }
+    return metrics;
+}
+
+- (void)setMetrics:(id<AGRestMetricsCollecting>)metrics {
+    dispatch_sync(_metricsAccessQueue, ^{
+        AGRestManagerPublishModule(_metrics, metrics);
+    });
+}
+
+#pragma mark - Traffic Capture
+#pragma mark -
+
+- (AGRestTrafficRecorder *)trafficRecorder {
+    // Never created lazily, nil unless a capture was started.
+    return AGRestManagerLoadModule(_trafficRecorder);
+}
+
+- (void)setTrafficRecorder:(AGRestTrafficRecorder *)trafficRecorder {
+    dispatch_sync(_trafficRecorderAccessQueue, ^{
+        AGRestManagerPublishModule(_trafficRecorder, trafficRecorder);
+    });
+}
+
+#pragma mark - Connection Warm-up
+#pragma mark -
+
+- (BFTask *)warmUpConnections {
+    NSMutableArray<NSURL *> *urls = [NSMutableArray array];
+    NSURL *baseUrl = [NSURL URLWithString:self.baseUrl];
+    if (baseUrl.host) {
+        [urls addObject:baseUrl];
+    }
+    for (NSString *host in self.warmUpHosts) {
+        NSURL *url = [NSURL URLWithString:host];
+        if (url.host && ![urls containsObject:url]) {
+            [urls addObject:url];
+        }
+    }
+    
+    // Connections are pooled per session, warm up the ones of the server each host is sent through
+    NSMutableArray<NSURL *> *warmUpUrls = [NSMutableArray arrayWithCapacity:urls.count];
+    NSMutableArray<BFTask *> *warmUpTasks = [NSMutableArray arrayWithCapacity:urls.count];
+    for (NSURL *url in urls) {
+        id<AGRestServerProtocol> requestServer = [self requestServerForBaseUrl:url.absoluteString];
+        if ([requestServer respondsToSelector:@selector(warmUpConnectionsToURLs:)]) {
+            [warmUpUrls addObject:url];
+            [warmUpTasks addObject:[requestServer warmUpConnectionsToURLs:@[url]]];
+        }
+    }
+    if (!warmUpTasks.count) {
+        return [BFTask taskWithResult:@[]];
+    }
+    
+    weakify(self);
+    BFTask *task = [[BFTask taskForCompletionOfAllTasksWithResults:warmUpTasks] continueWithSuccessBlock:^id(BFTask *task) {
+        strongify(self);
+        id<AGRestLogging> logger = strongSelf.logger;
+        id<AGRestMetricsCollecting> metrics = strongSelf.metrics;
+        NSArray *responses = [task.result valueForKeyPath:@"@unionOfArrays.self"];
+        [responses enumerateObjectsUsingBlock:^(AGRestResponse *response, NSUInteger index, BOOL *stop) {
+            if (response.trace && [logger respondsToSelector:@selector(logTrace:)]) {
+                [logger logTrace:response.trace];
+            }
+            [metrics recordRequestWithMethod:@"HEAD"
+                                    endpoint:warmUpUrls[index].host
+                                  statusCode:[response httpStatusCode]
+                                    duration:response.trace.totalDuration];
+        }];
+        return responses;
+    }];
+    
+    dispatch_sync(_warmUpAccessQueue, ^{
+        _connectionWarmUpTask = task;
+    });
+    return task;
+}
+
+- (BFTask *)connectionWarmUpTask {
+    __block BFTask *connectionWarmUpTask = nil;
+    dispatch_sync(_warmUpAccessQueue, ^{
+        connectionWarmUpTask = _connectionWarmUpTask;
+    });
+    return connectionWarmUpTask;
+}
+
 #pragma mark - Private()
 #pragma mark -
 
+- (id)_loadModuleInSlot:(__strong id *)slot {
+    pthread_mutex_lock(&_modulesMutex);
+    id module = *slot;
+    pthread_mutex_unlock(&_modulesMutex);
+    return module;
+}
+
+- (void)_publishModule:(id)module inSlot:(__strong id *)slot {
+    pthread_mutex_lock(&_modulesMutex);
+    id replacedModule = *slot;
+    *slot = module;
+    pthread_mutex_unlock(&_modulesMutex);
+    // Released out of the lock, its dealloc may read other modules.
+    replacedModule = nil;
+}
+
+// Requests are routed per host, whatever their path.
++ (nullable NSString *)_serverKeyForBaseUrl:(nullable NSString *)baseUrl {
+    NSURL *url = (baseUrl.length) ? [NSURL URLWithString:baseUrl] : nil;
+    if (!url.host) {
+        return nil;
+    }
+    NSString *scheme = url.scheme.lowercaseString ?: @"https";
+    if (url.port) {
+        return [NSString stringWithFormat:@"%@://%@:%@", scheme, url.host.lowercaseString, url.port];
+    }
+    return [NSString stringWithFormat:@"%@://%@", scheme, url.host.lowercaseString];
+}
+
 + (NSString *)restRootDirectory {
     return [[AGRestFileManager applicationSupport] stringByAppendingPathComponent:@"AGRest"];
 }
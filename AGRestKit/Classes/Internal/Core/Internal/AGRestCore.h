@@ -26,7 +26,9 @@ AGRestResponseSerializerProvider,
 AGRestKeyValueCacheProvider,
 AGRestEventuallyQueueProvider,
 AGRestFileManagerProvider,
-AGRestLoggerProvider>
+AGRestLoggerProvider,
+AGRestMetricsProvider,
+AGRestCircuitBreakerProvider>
 @end
 
 /*!
@@ -64,6 +64,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, weak, readonly) id<AGRestServerProtocol> requestServer;
 
+/*!
+ @abstract Return the server sending the requests to the host of `baseUrl`, `requestServer` if none was added for it.
+ */
+- (id<AGRestServerProtocol>)requestServerForBaseUrl:(nullable NSString *)baseUrl;
+
 @end
 
 #pragma mark - Protocol ResponseProvider
@@ -116,6 +121,26 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+#pragma mark - Metrics
+
+@protocol AGRestMetricsCollecting;
+
+@protocol AGRestMetricsProvider <NSObject>
+
+@property (nonatomic, strong, readonly) id<AGRestMetricsCollecting> metrics;
+
+@end
+
+#pragma mark - Circuit Breaker
+
+@class AGRestCircuitBreaker;
+
+@protocol AGRestCircuitBreakerProvider <NSObject>
+
+@property (nonatomic, strong, readonly) AGRestCircuitBreaker * circuitBreaker;
+
+@end
+
 #endif
 
 NS_ASSUME_NONNULL_END
@@ -26,5 +26,11 @@
 
 - (id)waitForResult:(NSError **)error;
 - (id)waitForResult:(NSError **)error withMainThreadWarning:(BOOL)warningEnabled;
+/*!
+ @abstract Wait for the task to finish, at most `timeout` seconds.
+ @discussion A wait that times out sets a kAGErrorTimeout error. Like `waitForResult:`, a cancelled task returns nil
+ without any error, check `cancelled` to tell it apart.
+ */
+- (id)waitForResult:(NSError **)error timeout:(NSTimeInterval)timeout;
 
 @end
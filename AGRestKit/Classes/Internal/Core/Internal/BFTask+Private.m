@@ -8,6 +8,9 @@
 
 #import "BFTask+Private.h"
 
+#import "AGRestConstants.h"
+#import "AGRestErrorUtilities.h"
+
 @implementation BFExecutor (AGRest)
 
 + (instancetype)defaultPriorityBackgroundExecutor {
@@ -67,4 +70,28 @@
     return self.result;
 }
 
+- (id)waitForResult:(NSError **)error timeout:(NSTimeInterval)timeout {
+    if (!self.completed) {
+        dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+        [self continueWithBlock:^id(BFTask *task) {
+            dispatch_semaphore_signal(semaphore);
+            return nil;
+        }];
+        if (dispatch_semaphore_wait(semaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC))) != 0) {
+            if (error) {
+                *error = [AGRestErrorUtilities errorWithCode:kAGErrorTimeout
+                                                     message:@"Timed out waiting for the task to finish."];
+            }
+            return nil;
+        }
+    }
+    if (self.cancelled) {
+        return nil;
+    }
+    if (self.error && error) {
+        *error = self.error;
+    }
+    return self.result;
+}
+
 @end
@@ -0,0 +1,45 @@
+//
+//  AGRestFileGroupCommitWriter.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 27/10/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class BFTask;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class AGRestFileGroupCommitWriter
+ 
+ @discussion Coalesces durable file writes. Writes received within `commitInterval` of each other are
+ written together and flushed to disk with a single full sync, instead of one sync per file.
+ */
+@interface AGRestFileGroupCommitWriter : NSObject
+
+/*!
+ @abstract Time to wait for more writes once the first one of a batch is received. Default is 10ms.
+ */
+@property (nonatomic, assign) NSTimeInterval commitInterval;
+
+/*!
+ @abstract Number of pending writes after which a batch is committed without waiting. Default is 64.
+ */
+@property (nonatomic, assign) NSUInteger maxBatchSize;
+
++ (instancetype)sharedWriter;
+
+/*!
+ @abstract Atomically write data to a file as part of the next group commit.
+ @param data        The NSData to write.
+ @param filePath    The destination filepath.
+ @return BFTask completed once the data is durable on disk, or faulted with the write error.
+ */
+- (BFTask *)writeDataAsync:(NSData *)data toFileAtPath:(NSString *)filePath;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,234 @@
+//
+//  AGRestFileGroupCommitWriter.m
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 27/10/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestFileGroupCommitWriter.h"
+
+#import <fcntl.h>
+#import <unistd.h>
+
+#import <Bolts/BFTask.h>
+#import <Bolts/BFTaskCompletionSource.h>
+
+static NSTimeInterval const _AGRestFileGroupCommitDefaultInterval = 0.01;
+static NSUInteger const _AGRestFileGroupCommitDefaultMaxBatchSize = 64;
+
+static NSError *_AGRestFileGroupCommitErrorFromErrno(NSString *path) {
+    return [NSError errorWithDomain:NSPOSIXErrorDomain
+                               code:errno
+                           userInfo:@{ NSFilePathErrorKey : path ?: @"" }];
+}
+
+// Flushes the drive cache, `fsync` alone doesn't on Darwin. File systems without it only get the `fsync`.
+static BOOL _AGRestFileGroupCommitFullSync(int fileDescriptor) {
+    if (fcntl(fileDescriptor, F_FULLFSYNC) == 0) {
+        return YES;
+    }
+    return (errno == ENOTSUP || errno == ENOTTY);
+}
+
+#pragma mark - Pending Write
+
+@interface _AGRestFileGroupCommitWrite : NSObject
+
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, copy) NSString *filePath;
+@property (nonatomic, copy) NSString *temporaryFilePath;
+@property (nonatomic, strong) BFTaskCompletionSource *taskCompletionSource;
+@property (nonatomic, strong) NSError *error;
+@property (nonatomic, assign) int fileDescriptor;
+
+@end
+
+@implementation _AGRestFileGroupCommitWrite
+@end
+
+#pragma mark - Writer
+
+@interface AGRestFileGroupCommitWriter () {
+    dispatch_queue_t _commitQueue;
+    NSMutableArray<_AGRestFileGroupCommitWrite *> *_pendingWrites;
+    BOOL _commitScheduled;
+}
+
+@end
+
+@implementation AGRestFileGroupCommitWriter
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) return nil;
+    
+    _commitQueue = dispatch_queue_create("com.AGRest.filemanager.groupcommit", DISPATCH_QUEUE_SERIAL);
+    _pendingWrites = [NSMutableArray array];
+    _commitInterval = _AGRestFileGroupCommitDefaultInterval;
+    _maxBatchSize = _AGRestFileGroupCommitDefaultMaxBatchSize;
+    
+    return self;
+}
+
++ (instancetype)sharedWriter {
+    static AGRestFileGroupCommitWriter *writer;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        writer = [[AGRestFileGroupCommitWriter alloc] init];
+    });
+    return writer;
+}
+
+- (BFTask *)writeDataAsync:(NSData *)data toFileAtPath:(NSString *)filePath {
+    _AGRestFileGroupCommitWrite *pendingWrite = [[_AGRestFileGroupCommitWrite alloc] init];
+    pendingWrite.data = data;
+    pendingWrite.filePath = filePath;
+    pendingWrite.taskCompletionSource = [BFTaskCompletionSource taskCompletionSource];
+    pendingWrite.fileDescriptor = -1;
+    
+    dispatch_async(_commitQueue, ^{
+        [_pendingWrites addObject:pendingWrite];
+        if ([_pendingWrites count] >= self.maxBatchSize) {
+            [self _commitPendingWrites];
+        } else if (!_commitScheduled) {
+            _commitScheduled = YES;
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.commitInterval * NSEC_PER_SEC)), _commitQueue, ^{
+                [self _commitPendingWrites];
+            });
+        }
+    });
+    
+    return pendingWrite.taskCompletionSource.task;
+}
+
+#pragma mark - Commit
+
+// Must be called on `_commitQueue`.
+- (void)_commitPendingWrites {
+    _commitScheduled = NO;
+    if ([_pendingWrites count] == 0) {
+        return;
+    }
+    
+    NSArray *writes = [_pendingWrites copy];
+    [_pendingWrites removeAllObjects];
+    
+    // 1. Write every file to a temporary sibling, without syncing.
+    for (_AGRestFileGroupCommitWrite *pendingWrite in writes) {
+        [self _writeTemporaryFileForWrite:pendingWrite];
+    }
+    
+    // 2. One full sync covers every file of the batch.
+    int lastFileDescriptor = -1;
+    for (_AGRestFileGroupCommitWrite *pendingWrite in writes) {
+        if (pendingWrite.fileDescriptor < 0) {
+            continue;
+        }
+        if (fsync(pendingWrite.fileDescriptor) != 0) {
+            pendingWrite.error = _AGRestFileGroupCommitErrorFromErrno(pendingWrite.filePath);
+        }
+        lastFileDescriptor = pendingWrite.fileDescriptor;
+    }
+    if (lastFileDescriptor >= 0 && !_AGRestFileGroupCommitFullSync(lastFileDescriptor)) {
+        // The full sync covers the whole batch, none of its files is durable.
+        int fullSyncErrno = errno;
+        for (_AGRestFileGroupCommitWrite *pendingWrite in writes) {
+            if (!pendingWrite.error) {
+                errno = fullSyncErrno;
+                pendingWrite.error = _AGRestFileGroupCommitErrorFromErrno(pendingWrite.filePath);
+            }
+        }
+    }
+    
+    // 3. Move the synced files in place.
+    NSMutableSet *directoryPaths = [NSMutableSet set];
+    for (_AGRestFileGroupCommitWrite *pendingWrite in writes) {
+        if (pendingWrite.fileDescriptor >= 0) {
+            close(pendingWrite.fileDescriptor);
+            pendingWrite.fileDescriptor = -1;
+        }
+        if (pendingWrite.error) {
+            unlink([pendingWrite.temporaryFilePath fileSystemRepresentation]);
+            continue;
+        }
+        if (rename([pendingWrite.temporaryFilePath fileSystemRepresentation], [pendingWrite.filePath fileSystemRepresentation]) != 0) {
+            pendingWrite.error = _AGRestFileGroupCommitErrorFromErrno(pendingWrite.filePath);
+            unlink([pendingWrite.temporaryFilePath fileSystemRepresentation]);
+            continue;
+        }
+        [directoryPaths addObject:[pendingWrite.filePath stringByDeletingLastPathComponent]];
+    }
+    // 4. The renames are only durable once the directories are synced, then flushed by a last full sync.
+    NSError *directoryError = nil;
+    int lastDirectoryDescriptor = -1;
+    for (NSString *directoryPath in directoryPaths) {
+        int directoryDescriptor = open([directoryPath fileSystemRepresentation], O_RDONLY);
+        if (directoryDescriptor < 0 || fsync(directoryDescriptor) != 0) {
+            directoryError = directoryError ?: _AGRestFileGroupCommitErrorFromErrno(directoryPath);
+        }
+        if (directoryDescriptor >= 0) {
+            if (lastDirectoryDescriptor >= 0) {
+                close(lastDirectoryDescriptor);
+            }
+            lastDirectoryDescriptor = directoryDescriptor;
+        }
+    }
+    if (lastDirectoryDescriptor >= 0) {
+        if (!_AGRestFileGroupCommitFullSync(lastDirectoryDescriptor)) {
+            directoryError = directoryError ?: _AGRestFileGroupCommitErrorFromErrno([directoryPaths anyObject]);
+        }
+        close(lastDirectoryDescriptor);
+    }
+    if (directoryError) {
+        for (_AGRestFileGroupCommitWrite *pendingWrite in writes) {
+            pendingWrite.error = pendingWrite.error ?: directoryError;
+        }
+    }
+    
+    for (_AGRestFileGroupCommitWrite *pendingWrite in writes) {
+        if (pendingWrite.error) {
+            [pendingWrite.taskCompletionSource setError:pendingWrite.error];
+        } else {
+            [pendingWrite.taskCompletionSource setResult:nil];
+        }
+    }
+}
+
+- (void)_writeTemporaryFileForWrite:(_AGRestFileGroupCommitWrite *)pendingWrite {
+    // Dot-prefixed so that a leftover file never matches what callers enumerate in the directory.
+    NSString *temporaryFileName = [NSString stringWithFormat:@".%@.%@.tmp",
+                                   [pendingWrite.filePath lastPathComponent],
+                                   [[NSUUID UUID] UUIDString]];
+    pendingWrite.temporaryFilePath = [[pendingWrite.filePath stringByDeletingLastPathComponent] stringByAppendingPathComponent:temporaryFileName];
+    
+    int fileDescriptor = open([pendingWrite.temporaryFilePath fileSystemRepresentation], O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fileDescriptor < 0) {
+        pendingWrite.error = _AGRestFileGroupCommitErrorFromErrno(pendingWrite.filePath);
+        return;
+    }
+    pendingWrite.fileDescriptor = fileDescriptor;
+    
+#if TARGET_OS_IPHONE || TARGET_IPHONE_SIMULATOR
+    [[NSFileManager defaultManager] setAttributes:@{ NSFileProtectionKey : NSFileProtectionCompleteUntilFirstUserAuthentication }
+                                     ofItemAtPath:pendingWrite.temporaryFilePath
+                                            error:nil];
+#endif
+    
+    const uint8_t *bytes = [pendingWrite.data bytes];
+    NSUInteger remaining = [pendingWrite.data length];
+    while (remaining > 0) {
+        ssize_t written = write(fileDescriptor, bytes, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            pendingWrite.error = _AGRestFileGroupCommitErrorFromErrno(pendingWrite.filePath);
+            return;
+        }
+        bytes += written;
+        remaining -= (NSUInteger)written;
+    }
+}
+
+@end
@@ -8,6 +8,21 @@
 
 #import <Foundation/Foundation.h>
 
+/*!
+ @enum AGRestFileLockMode
+ @discussion Locking modes supported by AGRestFileLock.
+ */
+typedef NS_ENUM(uint8_t, AGRestFileLockMode) {
+    /*!
+     @abstract Read lock. Any number of shared holders can access the file at the same time.
+     */
+    AGRestFileLockModeShared,
+    /*!
+     @abstract Write lock. Only one holder can access the file, no shared holder is allowed.
+     */
+    AGRestFileLockModeExclusive
+};
+
 @interface AGRestFileLock : NSObject
 
 @property (nonatomic, copy, readonly) NSString    *filePath;
@@ -16,7 +31,33 @@
 - (instancetype)initFileLockWithFileAtPath:(NSString *)filePath;
 + (instancetype)fileLockForFileAtPath:(NSString *)path;
 
-- (void)lock;
-- (void)unlock;
+/*!
+ @abstract Acquire an exclusive lock on the file. Same as `lockWithMode:AGRestFileLockModeExclusive`.
+ @return The owner of the hold, to unlock it with.
+ */
+- (id)lock;
+/*!
+ @abstract Acquire the lock with the given mode, blocking the calling thread until it is granted.
+ @discussion Waiting writers have priority over new readers so that a steady flow of readers can't starve them.
+ Holds belong to the returned owner, not to the calling thread: the lock can be released from any thread, e.g. by the
+ continuation of the task working on the file.
+ @param mode AGRestFileLockMode to acquire.
+ @return The owner of the hold, to unlock it with.
+ */
+- (id)lockWithMode:(AGRestFileLockMode)mode;
+/*!
+ @abstract Acquire the lock with the given mode on behalf of an owner.
+ @discussion An owner holding the lock locks it again without waiting, in any mode if it holds it exclusively, shared
+ otherwise, and must unlock it as many times. Locking exclusively while holding it shared raises an exception.
+ @param mode    AGRestFileLockMode to acquire.
+ @param owner   The owner returned by a previous lock, nil to acquire a new hold.
+ @return The owner of the hold, `owner` if not nil.
+ */
+- (id)lockWithMode:(AGRestFileLockMode)mode owner:(id)owner;
+/*!
+ @abstract Release a hold previously acquired with `lock` or `lockWithMode:`, from any thread.
+ @param owner The owner returned when locking.
+ */
+- (void)unlockWithOwner:(id)owner;
 
 @end
@@ -9,8 +9,17 @@
 #import "AGRestFileLock.h"
 
 @interface AGRestFileLock() {
-    dispatch_queue_t _synchronizationQueue;
-    int _fileDescriptor;
+    NSCondition         *_condition;
+    NSUInteger          _readersCount;
+    NSUInteger          _waitingWritersCount;
+    BOOL                _writing;
+    // Set while the first reader takes the process lock, outside of the condition.
+    BOOL                _acquiringSharedLock;
+    int                 _fileDescriptor;
+    // Holds of each owner, so that an owner locking again doesn't wait for itself. Owners are retained
+    // while they hold the lock and compared by pointer, whatever thread locks or unlocks.
+    NSMapTable<id, NSNumber *> *_holdsByOwner;
+    id                  _writer;
 }
 
 @property (nonatomic, copy, readwrite) NSString *filePath;
@@ -33,8 +42,11 @@
         _filePath = [filePath copy];
         _lockFilePath = [filePath stringByAppendingPathExtension:@"lock"];
         
-        NSString *queueName = [NSString stringWithFormat:@"com.AGRest.fileprocesslock.%@", [[filePath lastPathComponent] stringByDeletingPathExtension]];
-        _synchronizationQueue = dispatch_queue_create([queueName UTF8String], DISPATCH_QUEUE_SERIAL);
+        _condition = [[NSCondition alloc] init];
+        _holdsByOwner = [[NSMapTable alloc] initWithKeyOptions:(NSMapTableStrongMemory | NSMapTableObjectPointerPersonality)
+                                                  valueOptions:NSMapTableStrongMemory
+                                                      capacity:0];
+        _condition.name = [NSString stringWithFormat:@"com.AGRest.fileprocesslock.%@", [[filePath lastPathComponent] stringByDeletingPathExtension]];
     }
     return self;
 }
@@ -46,41 +58,128 @@
 #pragma mark - Locking
 #pragma mark -
 
-- (void)lock {
-    dispatch_sync(_synchronizationQueue, ^{
-        // Greater than zero means that the lock was already succesfully acquired.
-        if (_fileDescriptor > 0) {
-            return;
+- (id)lock {
+    return [self lockWithMode:AGRestFileLockModeExclusive];
+}
+
+- (id)lockWithMode:(AGRestFileLockMode)mode {
+    return [self lockWithMode:mode owner:nil];
+}
+
+- (id)lockWithMode:(AGRestFileLockMode)mode owner:(id)owner {
+    [_condition lock];
+    NSUInteger holds = (owner) ? [[_holdsByOwner objectForKey:owner] unsignedIntegerValue] : 0;
+    if (holds > 0) {
+        // Nested lock: the writer may lock in any mode, a reader only shared.
+        if (mode == AGRestFileLockModeExclusive && _writer != owner) {
+            [_condition unlock];
+            [NSException raise:NSInternalInconsistencyException
+                        format:@"<AGRestFileLock> Can't lock %@ exclusively while holding it shared.", self.filePath];
         }
-        BOOL locked = NO;
-        while (!locked) @autoreleasepool {
-            locked = [self _tryLock];
-            if (!locked) {
-                [NSThread sleepForTimeInterval:0.002];
-            }
+        [_holdsByOwner setObject:@(holds + 1) forKey:owner];
+        [_condition unlock];
+        return owner;
+    }
+    owner = owner ?: [[NSObject alloc] init];
+
+    if (mode == AGRestFileLockModeExclusive) {
+        _waitingWritersCount++;
+        while (_writing || _readersCount > 0) {
+            [_condition wait];
         }
-    });
+        _waitingWritersCount--;
+        // Reserved, the process lock is taken without blocking the other threads on the condition.
+        _writing = YES;
+        _writer = owner;
+        [_holdsByOwner setObject:@1 forKey:owner];
+        [_condition unlock];
+
+        [self _acquireProcessLockWithMode:AGRestFileLockModeExclusive];
+        return owner;
+    }
+
+    while (_writing || _waitingWritersCount > 0 || _acquiringSharedLock) {
+        [_condition wait];
+    }
+    _readersCount++;
+    [_holdsByOwner setObject:@1 forKey:owner];
+    if (_readersCount > 1) {
+        [_condition unlock];
+        return owner;
+    }
+    // Only the first reader takes the process lock, others share it.
+    _acquiringSharedLock = YES;
+    [_condition unlock];
+
+    [self _acquireProcessLockWithMode:AGRestFileLockModeShared];
+
+    [_condition lock];
+    _acquiringSharedLock = NO;
+    [_condition broadcast];
+    [_condition unlock];
+    return owner;
 }
 
-- (void)unlock {
-    dispatch_sync(_synchronizationQueue, ^{
-        // Only descriptor that is greater than zero is going to be open.
-        if (_fileDescriptor <= 0) {
-            return;
+- (void)unlockWithOwner:(id)owner {
+    [_condition lock];
+    NSUInteger holds = (owner) ? [[_holdsByOwner objectForKey:owner] unsignedIntegerValue] : 0;
+    if (holds == 0) {
+        [_condition unlock];
+        return;
+    }
+    if (holds > 1) {
+        [_holdsByOwner setObject:@(holds - 1) forKey:owner];
+        [_condition unlock];
+        return;
+    }
+    [_holdsByOwner removeObjectForKey:owner];
+    if (_writing && _writer == owner) {
+        _writing = NO;
+        _writer = nil;
+        [self _releaseProcessLock];
+    } else if (_readersCount > 0) {
+        _readersCount--;
+        if (_readersCount == 0) {
+            [self _releaseProcessLock];
         }
-        // Close the file with _fileDescriptor
-        close(_fileDescriptor);
-        _fileDescriptor = 0;
-    });
+    }
+    [_condition broadcast];
+    [_condition unlock];
 }
 
 #pragma mark - Private()
 #pragma mark -
 
-- (BOOL)_tryLock {
+// Called without holding the condition, by the only owner allowed to take the process lock.
+- (void)_acquireProcessLockWithMode:(AGRestFileLockMode)mode {
+    // Greater than zero means that the lock was already succesfully acquired.
+    if (_fileDescriptor > 0) {
+        return;
+    }
+    BOOL locked = NO;
+    while (!locked) @autoreleasepool {
+        locked = [self _tryLockWithMode:mode];
+        if (!locked) {
+            [NSThread sleepForTimeInterval:0.002];
+        }
+    }
+}
+
+- (void)_releaseProcessLock {
+    // Only descriptor that is greater than zero is going to be open.
+    if (_fileDescriptor <= 0) {
+        return;
+    }
+    // Close the file with _fileDescriptor
+    close(_fileDescriptor);
+    _fileDescriptor = 0;
+}
+
+- (BOOL)_tryLockWithMode:(AGRestFileLockMode)mode {
     const char *filePath = [self.lockFilePath fileSystemRepresentation];
+    int lockFlag = (mode == AGRestFileLockModeShared) ? O_SHLOCK : O_EXLOCK;
     // Open the file
-    _fileDescriptor = open(filePath, (O_RDWR | O_CREAT | O_EXLOCK),
+    _fileDescriptor = open(filePath, (O_RDWR | O_CREAT | lockFlag),
                            ((S_IRUSR | S_IWUSR | S_IXUSR) | (S_IRGRP | S_IWGRP | S_IXGRP) | (S_IROTH | S_IWOTH | S_IXOTH)));
     return (_fileDescriptor > 0);
 }
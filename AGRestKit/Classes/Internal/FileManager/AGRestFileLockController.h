@@ -8,12 +8,40 @@
 
 #import <Foundation/Foundation.h>
 
+#import "AGRestFileLock.h"
+
 @interface AGRestFileLockController : NSObject
 
 + (instancetype)sharedController;
 
-- (void)beginLockContentOfFileAtPath:(NSString *)filePath;
-- (void)endLockContentOfFileAtPath:(NSString *)filePath;
+/*!
+ @abstract Lock the content of the file exclusively. Same as `beginLockContentOfFileAtPath:mode:` with AGRestFileLockModeExclusive.
+ @param filePath The file path to lock.
+ @return The owner of the lock, to end it with.
+ */
+- (id)beginLockContentOfFileAtPath:(NSString *)filePath;
+/*!
+ @abstract Lock the content of the file with the given mode.
+ @discussion Use AGRestFileLockModeShared for reading, readers of the same file proceed concurrently and only block writers.
+ @param filePath The file path to lock.
+ @param mode     The AGRestFileLockMode to acquire.
+ @return The owner of the lock, to end it with, from any thread.
+ */
+- (id)beginLockContentOfFileAtPath:(NSString *)filePath mode:(AGRestFileLockMode)mode;
+/*!
+ @abstract Lock the content of the file again on behalf of an owner, see `-[AGRestFileLock lockWithMode:owner:]`.
+ @param filePath The file path to lock.
+ @param mode     The AGRestFileLockMode to acquire.
+ @param owner    The owner returned by a previous begin, nil to acquire a new hold.
+ @return The owner of the lock, `owner` if not nil.
+ */
+- (id)beginLockContentOfFileAtPath:(NSString *)filePath mode:(AGRestFileLockMode)mode owner:(id)owner;
+/*!
+ @abstract Unlock the content of the file.
+ @param filePath The file path to unlock.
+ @param owner    The owner returned by the matching begin.
+ */
+- (void)endLockContentOfFileAtPath:(NSString *)filePath owner:(id)owner;
 
 - (NSUInteger)lockedContentAccessCountForFileAtPath:(NSString *)filePath;
 
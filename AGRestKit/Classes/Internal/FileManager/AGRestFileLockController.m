@@ -41,27 +41,43 @@
     return controller;
 }
 
-- (void)beginLockContentOfFileAtPath:(NSString *)filePath {
+- (id)beginLockContentOfFileAtPath:(NSString *)filePath {
+    return [self beginLockContentOfFileAtPath:filePath mode:AGRestFileLockModeExclusive owner:nil];
+}
+
+- (id)beginLockContentOfFileAtPath:(NSString *)filePath mode:(AGRestFileLockMode)mode {
+    return [self beginLockContentOfFileAtPath:filePath mode:mode owner:nil];
+}
+
+- (id)beginLockContentOfFileAtPath:(NSString *)filePath mode:(AGRestFileLockMode)mode owner:(id)owner {
+    __block AGRestFileLock *fileLock = nil;
     dispatch_barrier_sync(_synchronizationQueue, ^{
-        AGRestFileLock *fileLock = _locksDictionary[filePath];
+        fileLock = _locksDictionary[filePath];
         if (!fileLock) {
             fileLock = [AGRestFileLock fileLockForFileAtPath:filePath];
             _locksDictionary[filePath] = fileLock;
         }
         
-        [fileLock lock];
-        
         NSUInteger contentAccess = [_contentAccessDictionary[filePath] unsignedIntegerValue];
         _contentAccessDictionary[filePath] = @(contentAccess + 1);
     });
+    
+    // Wait for the lock outside of the synchronization queue, so waiting on a file doesn't block other files.
+    return [fileLock lockWithMode:mode owner:owner];
 }
 
-- (void)endLockContentOfFileAtPath:(NSString *)filePath {
+- (void)endLockContentOfFileAtPath:(NSString *)filePath owner:(id)owner {
+    __block AGRestFileLock *fileLock = nil;
+    dispatch_sync(_synchronizationQueue, ^{
+        fileLock = _locksDictionary[filePath];
+    });
+    [fileLock unlockWithOwner:owner];
+    
     dispatch_barrier_sync(_synchronizationQueue, ^{
-        AGRestFileLock *fileLock = _locksDictionary[filePath];
-        [fileLock unlock];
-        
-        if (fileLock && [_contentAccessDictionary[filePath] unsignedIntegerValue] == 0) {
+        NSUInteger contentAccess = [_contentAccessDictionary[filePath] unsignedIntegerValue];
+        if (contentAccess > 1) {
+            _contentAccessDictionary[filePath] = @(contentAccess - 1);
+        } else {
             [_locksDictionary removeObjectForKey:filePath];
             [_contentAccessDictionary removeObjectForKey:filePath];
         }
@@ -15,6 +15,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 extern NSString * const AGRestDefaultCacheDirectory;
 extern NSString * const AGRestDefaultDataDirectory;
+extern NSInteger const AGRestFileManagerIOExecutorMaxConcurrentOperationCount;
 
 /*!
  @class AGRestFileManager
@@ -31,6 +32,22 @@ extern NSString * const AGRestDefaultDataDirectory;
 ///-----------------------
 - (instancetype)initWithRestDirectory:(NSString *)restDirectory;
 
+///-----------------------
+#pragma mark - I/O Executor
+/// @name I/O Executor
+///-----------------------
+/*!
+ @abstract Executor used by every operation that isn't given one explicitly.
+ @discussion Runs at most `AGRestFileManagerIOExecutorMaxConcurrentOperationCount` operations at once,
+ so bursts of disk work don't fan out to the global concurrent queues.
+ */
++ (BFExecutor *)IOExecutor;
+/*!
+ @abstract The number of operations currently queued or running on the I/O executor.
+ @discussion Also reported to the metrics collector, see `AGRestMetricsIOQueueDepthKey`.
+ */
++ (NSUInteger)IOExecutorQueueDepth;
+
 ///-----------------------
 #pragma mark - Domain Directories
 /// @name Domain Directories
@@ -222,6 +239,17 @@ extern NSString * const AGRestDefaultDataDirectory;
               toFileAtPath:(NSString *)filePath
               withExecutor:(BFExecutor *)executor;
 
+/*!
+ @abstract Write given data atomically and durably to a given filepath.
+ @discussion Writes arriving within a short window are committed together with a single disk sync,
+ which makes bursts of small writes much cheaper than separate `writeDataAsync:toFileAtPath:` calls.
+ @param data        The NSData to write.
+ @param filePath    The destination filepath.
+ @return On-going BFTask, completed once the data is durable on disk.
+ */
++ (BFTask *)writeDataDurablyAsync:(nonnull NSData *)data
+                     toFileAtPath:(nonnull NSString *)filePath;
+
 /*!
  @abstract Get an item's content as NSString asynchronously to a given filepath.
  @param filePath    The item's filepath.
@@ -254,6 +282,18 @@ extern NSString * const AGRestDefaultDataDirectory;
 + (BFTask *)contentDataAsyncFromFile:(nonnull NSString *)filePath
                         withExecutor:(nonnull BFExecutor *)executor;
 
+/*!
+ @abstract Map a file's content in memory synchronously.
+ @discussion The returned NSData is backed by the mapping, its bytes are paged in on access and never copied.
+ Accessing the bytes of a file truncated by another writer raises SIGBUS, so the caller must hold the file lock
+ for as long as the data is alive. Prefer `contentDataAsyncFromFile:` otherwise.
+ @param filePath    The item's filepath.
+ @param error       Set on failure.
+ @return The mapped content, or nil on failure.
+ */
++ (nullable NSData *)mappedContentDataOfFile:(nonnull NSString *)filePath
+                                       error:(NSError * _Nullable __autoreleasing * _Nullable)error;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -8,10 +8,18 @@
 
 #import "AGRestFileManager.h"
 
+#import <libkern/OSAtomic.h>
+#import <sys/mman.h>
+#import <sys/stat.h>
+
 #import <Bolts/Bolts.h>
 
 #import "BFTask+Private.h"
 #import "AGRestFileLockController.h"
+#import "AGRestFileGroupCommitWriter.h"
+#import "AGRest_Private.h"
+#import "AGRestManager.h"
+#import "AGRestMetricsCollecting.h"
 
 static NSDictionary *_AGRestFileManagerDefaultDirectoryFileAttributes() {
 #if TARGET_OS_IPHONE || TARGET_IPHONE_SIMULATOR
@@ -31,6 +39,9 @@ static NSDataWritingOptions _AGRestFileManagerDefaultDataWritingOptions() {
 
 NSString * const AGRestDefaultCacheDirectory = @"caches";
 NSString * const AGRestDefaultDataDirectory = @"data";
+NSInteger const AGRestFileManagerIOExecutorMaxConcurrentOperationCount = 4;
+
+static volatile int32_t _AGRestFileManagerIOExecutorQueueDepth = 0;
 
 @interface AGRestFileManager()
 
@@ -54,6 +65,35 @@ NSString * const AGRestDefaultDataDirectory = @"data";
     return self;
 }
 
+#pragma mark - I/O Executor
+#pragma mark -
+
++ (BFExecutor *)IOExecutor {
+    static BFExecutor *executor;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSOperationQueue *operationQueue = [[NSOperationQueue alloc] init];
+        operationQueue.name = @"com.AGRest.filemanager.io";
+        operationQueue.maxConcurrentOperationCount = AGRestFileManagerIOExecutorMaxConcurrentOperationCount;
+        operationQueue.qualityOfService = NSQualityOfServiceUtility;
+        
+        executor = [BFExecutor executorWithBlock:^(void (^block)()) {
+            int32_t depth = OSAtomicIncrement32Barrier(&_AGRestFileManagerIOExecutorQueueDepth);
+            [[AGRest _currentManager].metrics recordIOQueueDepth:(NSUInteger)MAX(depth, 0)];
+            [operationQueue addOperationWithBlock:^{
+                block();
+                int32_t depth = OSAtomicDecrement32Barrier(&_AGRestFileManagerIOExecutorQueueDepth);
+                [[AGRest _currentManager].metrics recordIOQueueDepth:(NSUInteger)MAX(depth, 0)];
+            }];
+        }];
+    });
+    return executor;
+}
+
++ (NSUInteger)IOExecutorQueueDepth {
+    return (NSUInteger)MAX(_AGRestFileManagerIOExecutorQueueDepth, 0);
+}
+
 #pragma mark - Domain Directory
 #pragma mark -
 
@@ -92,7 +132,7 @@ NSString * const AGRestDefaultDataDirectory = @"data";
 
 + (BFTask *)createDirectoryIfNeededAsyncAtPath:(nonnull NSString *)directoryPath {
     return [[self class] createDirectoryIfNeededAsyncAtPath:directoryPath
-                                               withExecutor:[BFExecutor defaultPriorityBackgroundExecutor]];
+                                               withExecutor:[self IOExecutor]];
 }
 
 + (BFTask *)createDirectoryIfNeededAsyncAtPath:(nonnull NSString *)directoryPath
@@ -121,7 +161,7 @@ NSString * const AGRestDefaultDataDirectory = @"data";
 {
     return [[self class] moveDirectoryContentsAsyncFromPath:fromPath
                                                      toPath:toPath
-                                               withExecutor:[BFExecutor defaultPriorityBackgroundExecutor]];
+                                               withExecutor:[self IOExecutor]];
 }
 
 + (BFTask *)moveDirectoryContentsAsyncFromPath:(nonnull NSString *)fromPath
@@ -158,14 +198,16 @@ NSString * const AGRestDefaultDataDirectory = @"data";
 
 + (BFTask *)removeDirectoryContentsAsyncAtPath:(nonnull NSString *)directoryPath {
     return [[self class] removeDirectoryContentsAsyncAtPath:directoryPath
-                                               withExecutor:[BFExecutor defaultPriorityBackgroundExecutor]];
+                                               withExecutor:[self IOExecutor]];
 }
 
 + (BFTask *)removeDirectoryContentsAsyncAtPath:(NSString *)directoryPath
                                   withExecutor:(BFExecutor *)executor
 {
+    // Released by the continuation, on whatever thread completes the removals.
+    __block id lockOwner = nil;
     BFTask *task = [[BFTask taskFromExecutor:executor withBlock:^id{
-        [[AGRestFileLockController sharedController] beginLockContentOfFileAtPath:directoryPath];
+        lockOwner = [[AGRestFileLockController sharedController] beginLockContentOfFileAtPath:directoryPath];
         NSError *error = nil;
         NSArray *contents = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:directoryPath error:&error];
         if (error) {
@@ -184,7 +226,7 @@ NSString * const AGRestDefaultDataDirectory = @"data";
         }
         return [BFTask taskForCompletionOfAllTasks:fileTasks];
     }] continueWithBlock:^id(BFTask *task) {
-        [[AGRestFileLockController sharedController] endLockContentOfFileAtPath:directoryPath];
+        [[AGRestFileLockController sharedController] endLockContentOfFileAtPath:directoryPath owner:lockOwner];
         return nil;
     }];
     return task;
@@ -196,16 +238,17 @@ NSString * const AGRestDefaultDataDirectory = @"data";
  {
     return [[self class] removeItemAsynAtPath:itemPath
                                    shouldLock:lock
-                                 withExecutor:[BFExecutor defaultPriorityBackgroundExecutor]];
+                                 withExecutor:[self IOExecutor]];
 }
 
 + (BFTask *)removeItemAsynAtPath:(nonnull NSString *)itemPath
                       shouldLock:(BOOL)lock
                     withExecutor:(nonnull BFExecutor *)executor
 {
+    __block id lockOwner = nil;
     BFTask *task = [[BFTask taskFromExecutor:executor withBlock:^id{
         if (lock) {
-            [[AGRestFileLockController sharedController] beginLockContentOfFileAtPath:itemPath];
+            lockOwner = [[AGRestFileLockController sharedController] beginLockContentOfFileAtPath:itemPath];
         }
         NSError * error = nil;
         if (![[NSFileManager defaultManager] removeItemAtPath:itemPath
@@ -215,7 +258,7 @@ NSString * const AGRestDefaultDataDirectory = @"data";
         return nil;
     }] continueWithBlock:^id(BFTask *task) {
         if (lock) {
-            [[AGRestFileLockController sharedController] endLockContentOfFileAtPath:itemPath];
+            [[AGRestFileLockController sharedController] endLockContentOfFileAtPath:itemPath owner:lockOwner];
         }
         return nil;
     }];
@@ -229,7 +272,7 @@ NSString * const AGRestDefaultDataDirectory = @"data";
 {
     return [[self class] copyItemAsyncAtPath:atPath
                                       toPath:toPath
-                                withExecutor:[BFExecutor defaultPriorityBackgroundExecutor]];
+                                withExecutor:[self IOExecutor]];
 }
 
 + (BFTask *)copyItemAsyncAtPath:(nonnull NSString *)atPath
@@ -253,7 +296,7 @@ NSString * const AGRestDefaultDataDirectory = @"data";
 {
     return [[self class] moveItemAsyncFromPath:fromPath
                                         toPath:toPath
-                                  withExecutor:[BFExecutor defaultExecutor]];
+                                  withExecutor:[self IOExecutor]];
 }
 
 + (BFTask *)moveItemAsyncFromPath:(nonnull NSString *)fromPath
@@ -284,7 +327,7 @@ NSString * const AGRestDefaultDataDirectory = @"data";
 {
     return [[self class] writeStringAsync:string
                              toFileAtPath:filePath
-                             withExecutor:[BFExecutor defaultPriorityBackgroundExecutor]];
+                             withExecutor:[self IOExecutor]];
 }
 
 + (BFTask *)writeStringAsync:(nonnull NSString *)string
@@ -307,14 +350,14 @@ NSString * const AGRestDefaultDataDirectory = @"data";
 {
     return [[self class] writeDataAsync:data
                            toFileAtPath:filePath
-                           withExecutor:[BFExecutor defaultPriorityBackgroundExecutor]];
+                           withExecutor:[self IOExecutor]];
 }
 
 + (BFTask *)writeDataAsync:(NSData *)data
               toFileAtPath:(NSString *)filePath
               withExecutor:(BFExecutor *)executor
 {
-    BFTask *task = [BFTask taskFromExecutor:[BFExecutor defaultPriorityBackgroundExecutor] withBlock:^id{
+    BFTask *task = [BFTask taskFromExecutor:executor withBlock:^id{
         NSError *error = nil;
         [data writeToFile:filePath
                   options:_AGRestFileManagerDefaultDataWritingOptions()
@@ -327,11 +370,17 @@ NSString * const AGRestDefaultDataDirectory = @"data";
     return task;
 }
 
++ (BFTask *)writeDataDurablyAsync:(nonnull NSData *)data
+                     toFileAtPath:(nonnull NSString *)filePath
+{
+    return [[AGRestFileGroupCommitWriter sharedWriter] writeDataAsync:data toFileAtPath:filePath];
+}
+
 #pragma - Read Content String File
 
 + (BFTask *)contentStringAsyncFromFile:(nonnull NSString *)filePath {
     return [[self class] contentStringAsyncFromFile:filePath
-                                       withExecutor:[BFExecutor defaultPriorityBackgroundExecutor]];
+                                       withExecutor:[self IOExecutor]];
 }
 
 + (BFTask *)contentStringAsyncFromFile:(nonnull NSString *)filePath
@@ -350,7 +399,7 @@ NSString * const AGRestDefaultDataDirectory = @"data";
 
 + (BFTask *)contentDataAsyncFromFile:(nonnull NSString *)filePath {
     return [[self class] contentDataAsyncFromFile:filePath
-                                     withExecutor:[BFExecutor defaultPriorityBackgroundExecutor]];
+                                     withExecutor:[self IOExecutor]];
 }
 
 + (BFTask *)contentDataAsyncFromFile:(nonnull NSString *)filePath
@@ -358,13 +407,56 @@ NSString * const AGRestDefaultDataDirectory = @"data";
 {
     BFTask * task = [BFTask taskFromExecutor:executor withBlock:^id{
         NSError *error = nil;
-        NSData *fileContentString = [NSData dataWithContentsOfFile:filePath options:NSDataReadingMappedIfSafe error:&error];
+        NSData *fileContentData = [NSData dataWithContentsOfFile:filePath options:NSDataReadingMappedIfSafe error:&error];
         if (error) {
             return [BFTask taskWithError:error];
         }
-        return [BFTask taskWithResult:fileContentString];
+        return [BFTask taskWithResult:fileContentData];
     }];
     return task;
 }
 
++ (nullable NSData *)mappedContentDataOfFile:(nonnull NSString *)filePath
+                                       error:(NSError * _Nullable __autoreleasing * _Nullable)error
+{
+    int fileDescriptor = open([filePath fileSystemRepresentation], O_RDONLY);
+    if (fileDescriptor < 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{ NSFilePathErrorKey : filePath }];
+        }
+        return nil;
+    }
+    
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) != 0) {
+        int statErrno = errno;
+        close(fileDescriptor);
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:statErrno userInfo:@{ NSFilePathErrorKey : filePath }];
+        }
+        return nil;
+    }
+    
+    size_t length = (size_t)fileStat.st_size;
+    if (length == 0) {
+        close(fileDescriptor);
+        return [NSData data];
+    }
+    
+    void *bytes = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    int mapErrno = errno;
+    // The mapping keeps its own reference to the file.
+    close(fileDescriptor);
+    if (bytes == MAP_FAILED) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:mapErrno userInfo:@{ NSFilePathErrorKey : filePath }];
+        }
+        return nil;
+    }
+    
+    return [[NSData alloc] initWithBytesNoCopy:bytes length:length deallocator:^(void *mappedBytes, NSUInteger mappedLength) {
+        munmap(mappedBytes, mappedLength);
+    }];
+}
+
 @end
@@ -20,8 +20,21 @@ static int ddLogLevel = DDLogLevelVerbose;
 static int ddLogLevel = DDLogLevelError;
 #endif
 
+/*!
+ Maximum number of formatted messages waiting to be written. Messages logged while it is full are dropped.
+ */
+extern NSUInteger const AGRestLoggerMessageBufferCapacity;
+
+static inline BOOL AGRestLoggerIsLevelEnabled(id<AGRestLogging> logger, AGRestLoggingLevel level) {
+    return logger && (![logger respondsToSelector:@selector(isLoggingLevelEnabled:)] || [logger isLoggingLevelEnabled:level]);
+}
+
+// Arguments are only evaluated when the level is enabled.
 #define AGRestLog(level, format, ...)  \
-    do { if (level && format) [[AGRest _currentManager].logger log:level message:(format), ##__VA_ARGS__]; } while (0)
+    do { \
+        id<AGRestLogging> _agrestLogger = [AGRest _currentManager].logger; \
+        if (level && format && AGRestLoggerIsLevelEnabled(_agrestLogger, level)) [_agrestLogger log:level message:(format), ##__VA_ARGS__]; \
+    } while (0)
 
 #define AGRestLogWarn(format, ...)     AGRestLog(AGRestLoggingLevelWarning, format, ##__VA_ARGS__)
 #define AGRestLogInfo(format, ...)     AGRestLog(AGRestLoggingLevelInfo,    format, ##__VA_ARGS__)
@@ -33,6 +46,8 @@ static int ddLogLevel = DDLogLevelError;
  
     @discussion Default singleton logger conforming to protocol AGRestLogging.
     AGRestLogger uses CocoaLumberjack as a base logger.
+    Messages are formatted on the calling thread, then handed to a bounded ring buffer drained on a
+    background queue: logging never waits for the output, and drops messages when the buffer is full.
  */
 @interface AGRestLogger : NSObject <AGRestLogging>
 
@@ -42,5 +57,16 @@ static int ddLogLevel = DDLogLevelError;
 + (instancetype)sharedLogger;
 
 - (void)log:(AGRestLoggingLevel)logLevel message:(NSString *)message, ... NS_FORMAT_FUNCTION(2,3);
+- (BOOL)isLoggingLevelEnabled:(AGRestLoggingLevel)logLevel;
+
+/*!
+ @abstract Blocks until all the buffered messages are written.
+ */
+- (void)flush;
+
+/*!
+ @return Number of messages dropped because the buffer was full.
+ */
+- (NSUInteger)droppedMessageCount;
 
 @end
@@ -9,11 +9,27 @@
 #import "AGRestLogger.h"
 
 #import <CocoaLumberjack/CocoaLumberjack.h>
+#import <pthread.h>
 
 #import "AGRestManager.h"
+#import "AGRestRequestTrace.h"
+
+NSUInteger const AGRestLoggerMessageBufferCapacity = 1024;
 
 @interface AGRestLogger() {
-    AGRestLoggingLevel _logLevel;
+    volatile AGRestLoggingLevel _logLevel;
+    
+    // Ring buffer of formatted messages, guarded by _bufferMutex.
+    pthread_mutex_t     _bufferMutex;
+    CFStringRef         *_bufferMessages;
+    AGRestLoggingLevel  *_bufferLevels;
+    NSUInteger          _bufferHead;
+    NSUInteger          _bufferCount;
+    NSUInteger          _droppedMessageCount;
+    NSUInteger          _reportedDroppedMessageCount;
+    
+    dispatch_queue_t    _drainQueue;
+    dispatch_source_t   _drainSource;
 }
 
 @end
@@ -51,10 +67,32 @@
     self = [super init];
     if (self) {
         _logLevel = AGRestLoggingLevelCrash;
+        
+        pthread_mutex_init(&_bufferMutex, NULL);
+        _bufferMessages = calloc(AGRestLoggerMessageBufferCapacity, sizeof(CFStringRef));
+        _bufferLevels = calloc(AGRestLoggerMessageBufferCapacity, sizeof(AGRestLoggingLevel));
+        
+        _drainQueue = dispatch_queue_create("com.AGRest.logger.drainQueue", DISPATCH_QUEUE_SERIAL);
+        _drainSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_DATA_ADD, 0, 0, _drainQueue);
+        __unsafe_unretained AGRestLogger *unsafeSelf = self; // The shared logger is never deallocated.
+        dispatch_source_set_event_handler(_drainSource, ^{
+            [unsafeSelf _drainBuffer];
+        });
+        dispatch_resume(_drainSource);
     }
     return self;
 }
 
+- (void)dealloc {
+    dispatch_source_cancel(_drainSource);
+    for (NSUInteger i = 0; i < _bufferCount; i++) {
+        CFRelease(_bufferMessages[(_bufferHead + i) % AGRestLoggerMessageBufferCapacity]);
+    }
+    free(_bufferMessages);
+    free(_bufferLevels);
+    pthread_mutex_destroy(&_bufferMutex);
+}
+
 + (instancetype)sharedLogger {
     static AGRestLogger *logger = nil;
     static dispatch_once_t onceToken;
@@ -68,40 +106,125 @@
     _logLevel = level;
 }
 
+- (BOOL)isLoggingLevelEnabled:(AGRestLoggingLevel)logLevel {
+    return logLevel != AGRestLoggingLevelNone && _logLevel >= logLevel;
+}
+
 - (void)log:(AGRestLoggingLevel)logLevel message:(NSString *)message, ...
 {
-    if (_logLevel >= logLevel)
-    {
-        va_list ap;
-        va_start(ap, message);
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wformat-security"
-        switch (logLevel) {
-            case AGRestLoggingLevelNone:    /* Do nothing*/          break;
-            case AGRestLoggingLevelInfo:    { [self ddlog:DDLogLevelInfo    flag:DDLogFlagInfo format:message args:ap]; } break;
-            case AGRestLoggingLevelDebug:   { [self ddlog:DDLogLevelDebug   flag:DDLogFlagDebug format:message args:ap]; } break;
-            case AGRestLoggingLevelCrash:
-            case AGRestLoggingLevelError:   { [self ddlog:DDLogLevelError   flag:DDLogFlagError format:message args:ap]; } break;
-            case AGRestLoggingLevelWarning: { [self ddlog:DDLogLevelWarning flag:DDLogFlagWarning format:message args:ap]; } break;
-            default: break;
+    if (![self isLoggingLevelEnabled:logLevel]) {
+        return;
+    }
+    
+    // The arguments don't outlive the call, so the message is formatted here and only written later.
+    va_list ap;
+    va_start(ap, message);
+    NSString *formattedMessage = [[NSString alloc] initWithFormat:message arguments:ap];
+    va_end(ap);
+    
+    [self _enqueueMessage:formattedMessage level:logLevel];
+    
+    // Don't lose the last words before a crash.
+    if (logLevel == AGRestLoggingLevelCrash) {
+        [self flush];
+    }
+}
+
+- (void)logTrace:(AGRestRequestTrace *)trace {
+    [self log:AGRestLoggingLevelInfo message:@"<AGRestLogger> %@", trace];
+}
+
+- (void)flush {
+    dispatch_sync(_drainQueue, ^{
+        [self _drainBuffer];
+    });
+}
+
+- (NSUInteger)droppedMessageCount {
+    pthread_mutex_lock(&_bufferMutex);
+    NSUInteger droppedMessageCount = _droppedMessageCount;
+    pthread_mutex_unlock(&_bufferMutex);
+    return droppedMessageCount;
+}
+
+#pragma mark - Buffer
+#pragma mark -
+
+- (void)_enqueueMessage:(NSString *)message level:(AGRestLoggingLevel)logLevel {
+    BOOL enqueued = NO;
+    
+    pthread_mutex_lock(&_bufferMutex);
+    if (_bufferCount < AGRestLoggerMessageBufferCapacity) {
+        NSUInteger index = (_bufferHead + _bufferCount) % AGRestLoggerMessageBufferCapacity;
+        _bufferMessages[index] = (CFStringRef)CFBridgingRetain(message);
+        _bufferLevels[index] = logLevel;
+        _bufferCount++;
+        enqueued = YES;
+    } else {
+        _droppedMessageCount++;
+    }
+    pthread_mutex_unlock(&_bufferMutex);
+    
+    if (enqueued) {
+        dispatch_source_merge_data(_drainSource, 1);
+    }
+}
+
+- (void)_drainBuffer {
+    while (YES) {
+        NSString *message = nil;
+        AGRestLoggingLevel logLevel = AGRestLoggingLevelNone;
+        NSUInteger droppedMessageCount = 0;
+        
+        pthread_mutex_lock(&_bufferMutex);
+        if (_droppedMessageCount > _reportedDroppedMessageCount) {
+            droppedMessageCount = _droppedMessageCount - _reportedDroppedMessageCount;
+            _reportedDroppedMessageCount = _droppedMessageCount;
+        }
+        if (_bufferCount > 0) {
+            message = CFBridgingRelease(_bufferMessages[_bufferHead]);
+            logLevel = _bufferLevels[_bufferHead];
+            _bufferMessages[_bufferHead] = NULL;
+            _bufferHead = (_bufferHead + 1) % AGRestLoggerMessageBufferCapacity;
+            _bufferCount--;
+        }
+        pthread_mutex_unlock(&_bufferMutex);
+        
+        if (droppedMessageCount > 0) {
+            [self _writeMessage:[NSString stringWithFormat:@"<AGRestLogger> Dropped %lu messages, the log buffer was full.", (unsigned long)droppedMessageCount]
+                          level:AGRestLoggingLevelWarning];
         }
-#pragma cland diagnostic pop
-        va_end(ap);
+        if (!message) {
+            break;
+        }
+        [self _writeMessage:message level:logLevel];
+    }
+}
+
+- (void)_writeMessage:(NSString *)message level:(AGRestLoggingLevel)logLevel {
+    switch (logLevel) {
+        case AGRestLoggingLevelNone:    /* Do nothing*/          break;
+        case AGRestLoggingLevelInfo:    { [self ddlog:DDLogLevelInfo    flag:DDLogFlagInfo message:message]; } break;
+        case AGRestLoggingLevelDebug:   { [self ddlog:DDLogLevelDebug   flag:DDLogFlagDebug message:message]; } break;
+        case AGRestLoggingLevelCrash:
+        case AGRestLoggingLevelError:   { [self ddlog:DDLogLevelError   flag:DDLogFlagError message:message]; } break;
+        case AGRestLoggingLevelWarning: { [self ddlog:DDLogLevelWarning flag:DDLogFlagWarning message:message]; } break;
+        default: break;
     }
 }
 
-- (void)ddlog:(NSUInteger)level flag:(NSUInteger)flag format:(NSString *)format args:(va_list)args
+- (void)ddlog:(NSUInteger)level flag:(NSUInteger)flag message:(NSString *)message
 {
-    [DDLog log:YES
+    // Already off the calling thread, no need for another asynchronous hop.
+    [DDLog log:NO
          level:level
           flag:flag
        context:0
-           file:__FILE__
+          file:__FILE__
       function:__FUNCTION__
           line:__LINE__
            tag:nil
-        format:format
-          args:args];
+        format:@"%@", message];
 }
 
 @end
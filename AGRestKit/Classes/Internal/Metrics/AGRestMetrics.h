@@ -0,0 +1,47 @@
+//
+//  AGRestMetrics.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 02/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "AGRestMetricsCollecting.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ Maximum number of distinct method, endpoint and status class combinations tracked.
+ Requests past this limit are recorded in a single overflow histogram keyed "* * *".
+ */
+extern NSUInteger const AGRestMetricsMaxHistogramCount;
+
+/*!
+ @class AGRestMetrics
+
+ @discussion Default AGRestMetricsCollecting implementation. Counters are updated with atomic operations and the
+ histograms live in a fixed open-addressing table whose slots are claimed with compare-and-swap, so recording
+ never takes a lock. Latencies are kept in log-linear buckets (16 per power of two, microsecond resolution),
+ which bounds the error of the reported percentiles to about 6%.
+ */
+@interface AGRestMetrics : NSObject <AGRestMetricsCollecting>
+
+- (void)recordRequestWithMethod:(nullable NSString *)method
+                       endpoint:(nullable NSString *)endpoint
+                     statusCode:(NSInteger)statusCode
+                       duration:(NSTimeInterval)duration;
+- (void)recordRetry;
+- (void)recordCacheHit;
+- (void)recordCacheMiss;
+- (void)recordCircuitBreakerRejection;
+- (void)recordEventuallyQueueDepth:(NSUInteger)depth;
+- (void)recordIOQueueDepth:(NSUInteger)depth;
+
+- (NSDictionary<NSString *, id> *)snapshot;
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
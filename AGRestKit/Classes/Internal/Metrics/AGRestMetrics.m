@@ -0,0 +1,319 @@
+//
+//  AGRestMetrics.m
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 02/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestMetrics.h"
+
+#import <libkern/OSAtomic.h>
+
+#import "AGRestRequest+Format.h"
+
+NSUInteger const AGRestMetricsMaxHistogramCount = 256;
+
+// Log-linear buckets: values below 16us get one bucket each, then every power of two is split in 16 buckets.
+#define _AGRestMetricsSubBucketBits     4
+#define _AGRestMetricsSubBucketCount    (1 << _AGRestMetricsSubBucketBits)
+#define _AGRestMetricsMagnitudeCount    26 // Up to 2^30us, about 18 minutes.
+#define _AGRestMetricsBucketCount       ((_AGRestMetricsMagnitudeCount + 1) * _AGRestMetricsSubBucketCount)
+#define _AGRestMetricsMaxValue          ((1LL << (_AGRestMetricsMagnitudeCount + _AGRestMetricsSubBucketBits)) - 1)
+
+// Must be a power of two, larger than AGRestMetricsMaxHistogramCount to keep the probe sequences short.
+#define _AGRestMetricsTableSize         512
+
+typedef struct {
+    volatile int64_t count;
+    volatile int64_t totalMicroseconds;
+    volatile int64_t maxMicroseconds;
+    volatile int64_t buckets[_AGRestMetricsBucketCount];
+} _AGRestMetricsHistogram;
+
+typedef struct {
+    NSUInteger      hash;
+    NSInteger       statusClass;
+    CFStringRef     method;
+    CFStringRef     endpoint;
+    _AGRestMetricsHistogram histogram;
+} _AGRestMetricsHistogramEntry;
+
+static inline NSUInteger _AGRestMetricsBucketIndex(int64_t value) {
+    if (value < _AGRestMetricsSubBucketCount) {
+        return (NSUInteger)MAX(value, 0);
+    }
+    value = MIN(value, _AGRestMetricsMaxValue);
+    int shift = (63 - __builtin_clzll((uint64_t)value)) - _AGRestMetricsSubBucketBits;
+    NSUInteger subBucket = (NSUInteger)((value >> shift) & (_AGRestMetricsSubBucketCount - 1));
+    return (NSUInteger)(shift + 1) * _AGRestMetricsSubBucketCount + subBucket;
+}
+
+static inline double _AGRestMetricsBucketMidpoint(NSUInteger index) {
+    if (index < _AGRestMetricsSubBucketCount) {
+        return (double)index;
+    }
+    NSUInteger shift = index / _AGRestMetricsSubBucketCount - 1;
+    NSUInteger subBucket = index % _AGRestMetricsSubBucketCount;
+    int64_t lowerBound = (int64_t)(_AGRestMetricsSubBucketCount + subBucket) << shift;
+    return (double)lowerBound + (double)((1LL << shift) - 1) / 2.0;
+}
+
+static inline void _AGRestMetricsAtomicMax(volatile int64_t *target, int64_t value) {
+    int64_t current = *target;
+    while (value > current) {
+        if (OSAtomicCompareAndSwap64Barrier(current, value, target)) {
+            return;
+        }
+        current = *target;
+    }
+}
+
+static inline NSInteger _AGRestMetricsStatusClass(NSInteger statusCode) {
+    return (statusCode >= 100 && statusCode < 600) ? statusCode / 100 : 0;
+}
+
+@interface AGRestMetrics() {
+    _AGRestMetricsHistogramEntry *volatile _entries[_AGRestMetricsTableSize];
+    _AGRestMetricsHistogramEntry *_overflowEntry;
+    volatile int32_t _entryCount;
+
+    volatile int64_t _requestCount;
+    volatile int64_t _retryCount;
+    volatile int64_t _cacheHitCount;
+    volatile int64_t _cacheMissCount;
+    volatile int64_t _eventuallyQueueDepth;
+    volatile int64_t _ioQueueDepth;
+    volatile int64_t _circuitBreakerRejectionCount;
+}
+
+@end
+
+@implementation AGRestMetrics
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) return nil;
+
+    _overflowEntry = [[self class] _newEntryWithHash:0 method:@"*" endpoint:@"*" statusClass:-1];
+
+    return self;
+}
+
+- (void)dealloc {
+    for (NSUInteger i = 0; i < _AGRestMetricsTableSize; i++) {
+        [[self class] _freeEntry:_entries[i]];
+    }
+    [[self class] _freeEntry:_overflowEntry];
+}
+
+#pragma mark - Recording
+#pragma mark -
+
+- (void)recordRequestWithMethod:(NSString *)method
+                       endpoint:(NSString *)endpoint
+                     statusCode:(NSInteger)statusCode
+                       duration:(NSTimeInterval)duration
+{
+    OSAtomicIncrement64(&_requestCount);
+
+    // One histogram per endpoint template, not per resource.
+    _AGRestMetricsHistogramEntry *entry = [self _entryForMethod:(method ?: @"")
+                                                       endpoint:[AGRestRequest normalizedEndPoint:endpoint]
+                                                    statusClass:_AGRestMetricsStatusClass(statusCode)];
+    _AGRestMetricsHistogram *histogram = &entry->histogram;
+
+    int64_t microseconds = (int64_t)MAX(duration * USEC_PER_SEC, 0);
+    OSAtomicIncrement64(&histogram->buckets[_AGRestMetricsBucketIndex(microseconds)]);
+    OSAtomicAdd64(microseconds, &histogram->totalMicroseconds);
+    _AGRestMetricsAtomicMax(&histogram->maxMicroseconds, microseconds);
+    // Count last, readers use it to tell whether the histogram holds any value.
+    OSAtomicIncrement64Barrier(&histogram->count);
+}
+
+- (void)recordRetry {
+    OSAtomicIncrement64(&_retryCount);
+}
+
+- (void)recordCacheHit {
+    OSAtomicIncrement64(&_cacheHitCount);
+}
+
+- (void)recordCacheMiss {
+    OSAtomicIncrement64(&_cacheMissCount);
+}
+
+- (void)recordCircuitBreakerRejection {
+    OSAtomicIncrement64(&_circuitBreakerRejectionCount);
+}
+
+- (void)recordEventuallyQueueDepth:(NSUInteger)depth {
+    _eventuallyQueueDepth = (int64_t)depth;
+    OSMemoryBarrier();
+}
+
+- (void)recordIOQueueDepth:(NSUInteger)depth {
+    _ioQueueDepth = (int64_t)depth;
+    OSMemoryBarrier();
+}
+
+#pragma mark - Reading
+#pragma mark -
+
+- (NSDictionary<NSString *, id> *)snapshot {
+    OSMemoryBarrier();
+
+    NSMutableDictionary *latency = [NSMutableDictionary dictionary];
+    for (NSUInteger i = 0; i < _AGRestMetricsTableSize; i++) {
+        [self _addEntry:_entries[i] toLatencySnapshot:latency];
+    }
+    [self _addEntry:_overflowEntry toLatencySnapshot:latency];
+
+    int64_t cacheHits = _cacheHitCount;
+    int64_t cacheMisses = _cacheMissCount;
+
+    NSMutableDictionary *snapshot = [@{AGRestMetricsRequestCountKey:          @(_requestCount),
+                                       AGRestMetricsRetryCountKey:            @(_retryCount),
+                                       AGRestMetricsCacheHitCountKey:         @(cacheHits),
+                                       AGRestMetricsCacheMissCountKey:        @(cacheMisses),
+                                       AGRestMetricsEventuallyQueueDepthKey:  @(_eventuallyQueueDepth),
+                                       AGRestMetricsIOQueueDepthKey:          @(_ioQueueDepth),
+                                       AGRestMetricsCircuitBreakerRejectionCountKey: @(_circuitBreakerRejectionCount),
+                                       AGRestMetricsLatencyKey:               [latency copy]} mutableCopy];
+    // A ratio of 0 would read as "the cache never hits" while no cache was consulted.
+    if (cacheHits + cacheMisses > 0) {
+        snapshot[AGRestMetricsCacheHitRatioKey] = @((double)cacheHits / (double)(cacheHits + cacheMisses));
+    }
+    return [snapshot copy];
+}
+
+- (void)reset {
+    // Entries stay in place so that concurrent recorders never see a freed histogram.
+    for (NSUInteger i = 0; i < _AGRestMetricsTableSize; i++) {
+        if (_entries[i]) {
+            [[self class] _resetHistogram:&_entries[i]->histogram];
+        }
+    }
+    [[self class] _resetHistogram:&_overflowEntry->histogram];
+
+    _requestCount = 0;
+    _retryCount = 0;
+    _cacheHitCount = 0;
+    _cacheMissCount = 0;
+    _circuitBreakerRejectionCount = 0;
+    OSMemoryBarrier();
+}
+
+#pragma mark - Private
+#pragma mark -
+
+- (_AGRestMetricsHistogramEntry *)_entryForMethod:(NSString *)method
+                                         endpoint:(NSString *)endpoint
+                                      statusClass:(NSInteger)statusClass
+{
+    NSUInteger hash = ([method hash] * 31 + [endpoint hash]) * 31 + (NSUInteger)statusClass;
+    _AGRestMetricsHistogramEntry *candidate = NULL;
+
+    for (NSUInteger probe = 0; probe < _AGRestMetricsTableSize; probe++) {
+        NSUInteger slot = (hash + probe) & (_AGRestMetricsTableSize - 1);
+        _AGRestMetricsHistogramEntry *entry = _entries[slot];
+
+        if (!entry) {
+            if (_entryCount >= (int32_t)AGRestMetricsMaxHistogramCount) {
+                break;
+            }
+            if (!candidate) {
+                candidate = [[self class] _newEntryWithHash:hash method:method endpoint:endpoint statusClass:statusClass];
+            }
+            if (OSAtomicCompareAndSwapPtrBarrier(NULL, candidate, (void *volatile *)&_entries[slot])) {
+                OSAtomicIncrement32(&_entryCount);
+                return candidate;
+            }
+            // Another thread claimed the slot first, it may hold the same key.
+            entry = _entries[slot];
+        }
+
+        if (entry->hash == hash &&
+            entry->statusClass == statusClass &&
+            CFEqual(entry->method, (__bridge CFStringRef)method) &&
+            CFEqual(entry->endpoint, (__bridge CFStringRef)endpoint)) {
+            [[self class] _freeEntry:candidate];
+            return entry;
+        }
+    }
+
+    [[self class] _freeEntry:candidate];
+    return _overflowEntry;
+}
+
+- (void)_addEntry:(_AGRestMetricsHistogramEntry *)entry toLatencySnapshot:(NSMutableDictionary *)latency {
+    if (!entry || entry->histogram.count == 0) {
+        return;
+    }
+
+    _AGRestMetricsHistogram *histogram = &entry->histogram;
+    int64_t buckets[_AGRestMetricsBucketCount];
+    int64_t count = 0;
+    for (NSUInteger i = 0; i < _AGRestMetricsBucketCount; i++) {
+        buckets[i] = histogram->buckets[i];
+        count += buckets[i];
+    }
+    if (count == 0) {
+        return;
+    }
+
+    NSString *statusClass = (entry->statusClass > 0) ? [NSString stringWithFormat:@"%ldxx", (long)entry->statusClass] : ((entry->statusClass == 0) ? @"error" : @"*");
+    NSString *key = [NSString stringWithFormat:@"%@ %@ %@", (__bridge NSString *)entry->method, (__bridge NSString *)entry->endpoint, statusClass];
+
+    latency[key] = @{AGRestMetricsLatencyCountKey:  @(count),
+                     AGRestMetricsLatencyMeanKey:   @((double)histogram->totalMicroseconds / (double)count / USEC_PER_MSEC),
+                     AGRestMetricsLatencyMaxKey:    @((double)histogram->maxMicroseconds / USEC_PER_MSEC),
+                     AGRestMetricsLatencyP50Key:    @([[self class] _percentile:0.50 ofBuckets:buckets count:count] / USEC_PER_MSEC),
+                     AGRestMetricsLatencyP90Key:    @([[self class] _percentile:0.90 ofBuckets:buckets count:count] / USEC_PER_MSEC),
+                     AGRestMetricsLatencyP99Key:    @([[self class] _percentile:0.99 ofBuckets:buckets count:count] / USEC_PER_MSEC)};
+}
+
++ (double)_percentile:(double)percentile ofBuckets:(const int64_t *)buckets count:(int64_t)count {
+    int64_t rank = (int64_t)ceil(percentile * (double)count);
+    int64_t seen = 0;
+    for (NSUInteger i = 0; i < _AGRestMetricsBucketCount; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return _AGRestMetricsBucketMidpoint(i);
+        }
+    }
+    return _AGRestMetricsBucketMidpoint(_AGRestMetricsBucketCount - 1);
+}
+
++ (_AGRestMetricsHistogramEntry *)_newEntryWithHash:(NSUInteger)hash
+                                             method:(NSString *)method
+                                           endpoint:(NSString *)endpoint
+                                        statusClass:(NSInteger)statusClass
+{
+    _AGRestMetricsHistogramEntry *entry = calloc(1, sizeof(_AGRestMetricsHistogramEntry));
+    entry->hash = hash;
+    entry->statusClass = statusClass;
+    entry->method = CFStringCreateCopy(kCFAllocatorDefault, (__bridge CFStringRef)method);
+    entry->endpoint = CFStringCreateCopy(kCFAllocatorDefault, (__bridge CFStringRef)endpoint);
+    return entry;
+}
+
++ (void)_freeEntry:(_AGRestMetricsHistogramEntry *)entry {
+    if (!entry) {
+        return;
+    }
+    CFRelease(entry->method);
+    CFRelease(entry->endpoint);
+    free(entry);
+}
+
++ (void)_resetHistogram:(_AGRestMetricsHistogram *)histogram {
+    histogram->count = 0;
+    histogram->totalMicroseconds = 0;
+    histogram->maxMicroseconds = 0;
+    for (NSUInteger i = 0; i < _AGRestMetricsBucketCount; i++) {
+        histogram->buckets[i] = 0;
+    }
+}
+
+@end
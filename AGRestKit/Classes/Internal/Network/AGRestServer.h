@@ -13,6 +13,7 @@
 
 #define AGRestRequestSessionTimeoutInterval     60
 #define AGRestRessourceSessionTimeoutInterval   120
+#define AGRestServerWarmUpTimeoutInterval       10
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -38,11 +39,22 @@ NS_ASSUME_NONNULL_BEGIN
  You are encouraged to subclass AGRestServer only if you aim to extend running operations with additionnal features or fine-tune server
  configurations. If you need a server instance that can manage its own queues, threads and running operations behaviours or if you don't want to use
  AFNetworking as the underlying server client then prefer creating a new class that conforms to AGRestServerProtocol.
+ AGRestSessionServer is such a server, running the requests straight on an NSURLSession without an operations queue.
  In any case, change the default AGRestServer instance with your own by calling AGRest method `[AGRest setServerInstance:]` .
  
  */
 @interface AGRestServer : AFHTTPSessionManager <AGRestServerProtocol>
 
+/*!
+ @abstract Name of the server, in the name of its operations queue and in the logs. The shared instance is named "default".
+ */
+@property (nonatomic, copy, readonly) NSString      *name;
+
+/*!
+ @abstract Maximum number of requests running at once, or 0 to follow the reachability status.
+ */
+@property (nonatomic, assign) NSInteger             maxConcurrentOperationCount;
+
 - (instancetype)init NS_UNAVAILABLE;
 
 ///------------------
@@ -60,6 +72,21 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (nullable instancetype)sharedServer;
 
+/*!
+ @abstract Return a new server, with its own session, connections and operations queue.
+ @discussion Use it to send the requests to another host, e.g. a CDN, with `[AGRest addServerInstance:forBaseUrl:]`,
+ so that a slow host doesn't hold the requests to the others. Headers set on the shared instance aren't set on it.
+ @param name            The server name.
+ @param url             The base server url.
+ @param configuration   The session configuration, e.g. to limit the connections per host. Default configuration if nil.
+ @param count           Maximum number of requests running at once, or 0 to follow the reachability status.
+ @return A configured server, nil if the url is invalid.
+ */
++ (nullable instancetype)serverWithName:(nonnull NSString *)name
+                                baseUrl:(nonnull NSString *)url
+                   sessionConfiguration:(nullable NSURLSessionConfiguration *)configuration
+            maxConcurrentOperationCount:(NSInteger)count;
+
 - (void)reset;
 
 ///------------------
@@ -84,6 +111,18 @@ NS_ASSUME_NONNULL_BEGIN
                 withOptions:(AGRestRequestRunningOptions)options
           cancellationToken:(nullable BFCancellationToken *)cancellationToken;
 
+///------------------
+/// @name Warm-up
+///------------------
+/*!
+ @abstract Send a HEAD request to each url through the server session, so that the connections are in its pool
+ before the first request.
+ @discussion Runs in background. Any HTTP response, whatever its status code, counts as a warmed up connection.
+ @param urls NSArray of NSURL to connect to.
+ @return Returns a BFTask resolving to an NSArray of AGRestResponse, one per url in the same order.
+ */
+- (BFTask *)warmUpConnectionsToURLs:(nonnull NSArray<NSURL *> *)urls;
+
 ///------------------
 /// @name Configure
 ///------------------
@@ -9,6 +9,8 @@
 #import "AGRestServer.h"
 
 #import <Foundation/Foundation.h>
+#import <libkern/OSAtomic.h>
+#import <objc/runtime.h>
 
 #import "Bolts.h"
 #import "BFTask+Private.h"
@@ -20,15 +22,69 @@
 #import "AGRestResponse.h"
 #import "AGRestErrorUtilities.h"
 #import "AGRestLogger.h"
+#import "AGRestPipelineInstrumentation.h"
+#import "AGRestRequestTrace_Private.h"
+#import "AGRestRequest_Private.h"
+#import "AGRestRequestTemplate_Private.h"
 
 #define kRestServerMaxConcurrentOperationsWAN   2
 #define kRestServerMaxConcurrentOperationsWIFI  4
 
 static NSString * const kAlamoSerializationReponseErrorData = @"com.alamofire.serialization.response.error.data";
 
+static const void *_AGRestServerDecodeTimesKey = &_AGRestServerDecodeTimesKey;
+static const void *_AGRestServerCompletionTimeKey = &_AGRestServerCompletionTimeKey;
+
+/*!
+ @abstract Response serializer recording the time spent decoding each response, on the response itself.
+ */
+@interface _AGRestTracingResponseSerializer : AFCompoundResponseSerializer
+@end
+
+@implementation _AGRestTracingResponseSerializer
+
+- (id)responseObjectForResponse:(NSURLResponse *)response data:(NSData *)data error:(NSError * __autoreleasing *)error {
+    NSTimeInterval startTime = AGRestPipelineCurrentTime();
+    id responseObject = [super responseObjectForResponse:response data:data error:error];
+    if (response) {
+        objc_setAssociatedObject(response, _AGRestServerDecodeTimesKey, @[ @(startTime), @(AGRestPipelineCurrentTime()) ], OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    return responseObject;
+}
+
+@end
+
+static void _AGRestServerRecordResponseTrace(AGRestRequestTrace *trace, NSURLSessionDataTask *task) {
+    if (!trace) {
+        return;
+    }
+    NSArray *decodeTimes = task.response ? objc_getAssociatedObject(task.response, _AGRestServerDecodeTimesKey) : nil;
+    if (decodeTimes.count == 2) {
+        [trace recordStage:AGRestRequestTraceStageDecode
+                 startTime:[decodeTimes[0] doubleValue]
+                   endTime:[decodeTimes[1] doubleValue]];
+    }
+    [trace beginStage:AGRestRequestTraceStageCompletion];
+}
+
+// The response is handed to the completion queue once decoded, or right after the task completed when it failed.
+static void _AGRestServerRecordCompletionHop(NSURLSessionDataTask *task) {
+    if (![AGRestPipelineInstrumentation isEnabled]) {
+        return;
+    }
+    NSArray *decodeTimes = task.response ? objc_getAssociatedObject(task.response, _AGRestServerDecodeTimesKey) : nil;
+    NSTimeInterval handoffTime = (decodeTimes.count == 2) ? [decodeTimes[1] doubleValue] :
+                                                            [objc_getAssociatedObject(task, _AGRestServerCompletionTimeKey) doubleValue];
+    if (handoffTime > 0) {
+        [AGRestPipelineInstrumentation recordHopForStage:AGRestPipelineStageCompletionQueue
+                                           queueingDelay:AGRestPipelineCurrentTime() - handoffTime];
+    }
+}
+
 @interface AGRestServer () {
-    dispatch_queue_t _executionAccessQueue;
     dispatch_queue_t _operationQueueAccessQueue;
+    // Changed whenever a header is set, so that request templates prepared with the old headers get prepared again.
+    volatile int32_t _requestHeadersVersion;
 }
 
 @property (nonatomic, strong, readonly) NSOperationQueue     *operationsQueue;
@@ -38,9 +94,13 @@ static NSString * const kAlamoSerializationReponseErrorData = @"com.alamofire.se
                                 URLString:(nonnull NSString *)url
                                parameters:(nullable id)parameters
                                   headers:(nullable NSDictionary *)headers
+                               urlRequest:(nullable NSURLRequest *)urlRequest
                                   options:(AGRestRequestRunningOptions)options
+                                    trace:(nullable AGRestRequestTrace *)trace
                         cancellationToken:(nullable BFCancellationToken *)cancellationToken;
 
+- (nullable NSURLRequest *)_templateURLRequestForRequest:(nonnull AGRestRequest *)request;
+
 - (void)didReachabilityChanged:(NSNotification *)aNotification;
 
 @end
@@ -54,6 +114,8 @@ static NSString * kRestServerHTTPContentTypeJson         = @"application/json";
 
 @interface AGRestServer()
 
+@property (nonatomic, copy, readwrite) NSString *name;
+
 - (void)configureServer;
 
 @end
@@ -82,6 +144,7 @@ static AGRestServer *_sharedServer = nil; // shared instance
     dispatch_once(&onceToken, ^{
         _sharedServer = [[AGRestServer alloc] initWithBaseURL:[NSURL URLWithString:url]];
         if (_sharedServer) {
+            _sharedServer.name = @"default";
             [_sharedServer configureServer];
             ret = YES;
         }
@@ -89,7 +152,29 @@ static AGRestServer *_sharedServer = nil; // shared instance
     return ret;
 }
 
++ (nullable instancetype)serverWithName:(nonnull NSString *)name
+                                baseUrl:(nonnull NSString *)url
+                   sessionConfiguration:(nullable NSURLSessionConfiguration *)configuration
+            maxConcurrentOperationCount:(NSInteger)count
+{
+    NSURL *baseURL = (url.length) ? [NSURL URLWithString:url] : nil;
+    if (!baseURL.host) {
+        return nil;
+    }
+    AGRestServer *server = [[self alloc] initWithBaseURL:baseURL sessionConfiguration:configuration];
+    server.name = name;
+    server.maxConcurrentOperationCount = count;
+    [server configureServer];
+    return server;
+}
+
 - (void)reset {
+    if (self != _sharedServer) {
+        // The session retains its delegate, this server, until invalidated
+        [self.operationsQueue cancelAllOperations];
+        [self invalidateSessionCancelingTasks:YES];
+        return;
+    }
     @synchronized(_sharedServer) {
         _sharedServer = nil;
     }
@@ -97,7 +182,6 @@ static AGRestServer *_sharedServer = nil; // shared instance
 
 - (void)configureServer
 {
-    _executionAccessQueue = dispatch_queue_create("com.AGRest.server.executionAccessQueue", DISPATCH_QUEUE_SERIAL);
     _operationQueueAccessQueue = dispatch_queue_create("com.AGRest.server.operationQueueAccessQueue", DISPATCH_QUEUE_SERIAL);
     
     // Set the server security policy
@@ -112,7 +196,7 @@ static AGRestServer *_sharedServer = nil; // shared instance
     [self.session.configuration setRequestCachePolicy:NSURLRequestReloadIgnoringLocalCacheData];
     
     // Set the Response Serializer
-    AFCompoundResponseSerializer *responseSerializer = [AFCompoundResponseSerializer serializer];
+    AFCompoundResponseSerializer *responseSerializer = [_AGRestTracingResponseSerializer serializer];
     [self.responseSerializer setAcceptableContentTypes:[NSSet setWithObject:kRestServerHTTPContentTypeJson]];
     [self setResponseSerializer:responseSerializer];
     
@@ -144,8 +228,8 @@ static AGRestServer *_sharedServer = nil; // shared instance
         if (!_operationsQueue) {
             // Configure operations queue
             _operationsQueue = [[NSOperationQueue alloc] init];
-            _operationsQueue.maxConcurrentOperationCount = kRestServerMaxConcurrentOperationsWAN;
-            _operationsQueue.name = kRestServerOperationsQueueName;
+            _operationsQueue.maxConcurrentOperationCount = (_maxConcurrentOperationCount > 0) ? _maxConcurrentOperationCount : kRestServerMaxConcurrentOperationsWAN;
+            _operationsQueue.name = [NSString stringWithFormat:@"%@.%@", kRestServerOperationsQueueName, _name];
             _operationsQueue.qualityOfService = NSQualityOfServiceUserInitiated;
         }
         operationQueue = _operationsQueue;
@@ -168,36 +252,39 @@ static AGRestServer *_sharedServer = nil; // shared instance
         return [BFTask cancelledTask];
     }
     
-    return [BFTask taskFromExecutor:[BFExecutor executorWithDispatchQueue:_executionAccessQueue] withBlock:^id{
-        @autoreleasepool {
-            switch (request.httpMethod)
+    [request.trace endStage:AGRestRequestTraceStageRunnerDispatch];
+    
+    // Runs on the request controller thread, the operation queue is the only handoff until the response comes back.
+    @autoreleasepool {
+        switch (request.httpMethod)
+        {
+            case AGRestRequestMethodHttpPOST:
+            case AGRestRequestMethodHttpPUT:
+            case AGRestRequestMethodHttpHEAD:
+            case AGRestREquestMethodHttpPATCH:
+            case AGRestRequestMethodHttpGET:
+            case AGRestRequestMethodHttpDELETE:
             {
-                case AGRestRequestMethodHttpPOST:
-                case AGRestRequestMethodHttpPUT:
-                case AGRestRequestMethodHttpHEAD:
-                case AGRestREquestMethodHttpPATCH:
-                case AGRestRequestMethodHttpGET:
-                case AGRestRequestMethodHttpDELETE:
-                {
-                    return [self _performRequestWithIdentifier:request.requestIdentifier
-                                                        method:request.httpMethodString
-                                                     URLString:request.endPoint
-                                                    parameters:request.body
-                                                       headers:request.headers
-                                                       options:options
-                                             cancellationToken:token];
-                } break;
-                    
-                default: {
-                    NSString *errorMsg = [NSString stringWithFormat:@"<AGRestServer> HTTP method not supported : %@", request.httpMethodString];
-                    NSError *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal
-                                                                    message:errorMsg
-                                                                  shouldLog:NO];
-                    return [BFTask taskWithError:error];
-                }  break;
-            }
+                return [self _performRequestWithIdentifier:request.requestIdentifier
+                                                    method:request.httpMethodString
+                                                 URLString:request.endPoint
+                                                parameters:request.body
+                                                   headers:request.headers
+                                                urlRequest:[self _templateURLRequestForRequest:request]
+                                                   options:options
+                                                     trace:request.trace
+                                         cancellationToken:token];
+            } break;
+                
+            default: {
+                NSString *errorMsg = [NSString stringWithFormat:@"<AGRestServer> HTTP method not supported : %@", request.httpMethodString];
+                NSError *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal
+                                                                message:errorMsg
+                                                              shouldLog:NO];
+                return [BFTask taskWithError:error];
+            }  break;
         }
-    }];
+    }
 }
 
 #pragma mark - AGRestServerProtocol
@@ -205,6 +292,7 @@ static AGRestServer *_sharedServer = nil; // shared instance
 
 - (void)setValue:(nullable NSString *)value forHTTPHeaderField:(nonnull NSString *)key {
     [self.requestSerializer setValue:value forHTTPHeaderField:key];
+    OSAtomicIncrement32Barrier(&_requestHeadersVersion);
 }
 
 - (void)setAcceptableContentTypes:(nonnull NSSet *)contentTypes {
@@ -223,77 +311,189 @@ static AGRestServer *_sharedServer = nil; // shared instance
                                 URLString:(nonnull NSString *)url
                                parameters:(nullable id)parameters
                                   headers:(nullable NSDictionary *)headers
+                               urlRequest:(nullable NSURLRequest *)urlRequest
                                   options:(AGRestRequestRunningOptions)options
+                                    trace:(nullable AGRestRequestTrace *)trace
                         cancellationToken:(nullable BFCancellationToken *)cancellationToken
 {
     if (cancellationToken.cancellationRequested) {
         return [BFTask cancelledTask];
     }
     
-    weakify(self)
-    BFTask *task = [BFTask taskFromExecutor:[BFExecutor executorWithDispatchQueue:_executionAccessQueue] withBlock:^id{
-        strongify(weakSelf)
-        if (strongSelf)
-        {
-            AGRestLogInfo(@"<AGRestServer> Fetch request <%@> in background :\nmethod: %@\nurl: %@\nparams: %@\nheaders: %@\n",
-                          requestIdentifier, method, url, (parameters)?:@"nil", (headers)?:@"nil");
-            
-            BFTaskCompletionSource *completionSource = [BFTaskCompletionSource taskCompletionSource];
-            
-            void (^success)(NSURLSessionDataTask *, id) = ^(NSURLSessionDataTask *task, id result)
-            {
-                // Map with AGRestResponse
-                NSDictionary    *header = [(NSHTTPURLResponse *)task.response allHeaderFields];
-            
-                NSInteger       statusCode = [(NSHTTPURLResponse *)task.response statusCode];
-                AGRestResponse  *response = [AGRestResponse responseWithData:result
-                                                                      header:header
-                                                                  statusCode:statusCode];
-                [completionSource setResult:response];
-            };
-            void (^failure)(NSURLSessionDataTask *, NSError *) = ^(NSURLSessionDataTask *task, NSError *error)
-            {
-                // Map with AGRestResponse
-                NSInteger       statusCode = [(NSHTTPURLResponse *)task.response statusCode];
-                
-                NSData          *errorData = error.userInfo[kAlamoSerializationReponseErrorData];
-                NSDictionary    *errorDict = nil;
-                if (errorData) {
-                    errorDict = [NSJSONSerialization JSONObjectWithData:errorData options:NSJSONReadingAllowFragments error:nil];
-                }
-                
-                AGRestResponse  *response = [AGRestResponse responseWithError:error statusCode:statusCode];
-                response.responseData = errorDict;
-                [completionSource setResult:response];
-            };
-            
-            // Create the request operation
-            AFHTTPSessionOperation *operation = [AFHTTPSessionOperation operationWithManager:strongSelf
-                                                                                      method:method
-                                                                                   urlString:url
-                                                                                  parameters:parameters
-                                                                                     headers:headers
-                                                                                     success:success
-                                                                                     failure:failure];
-            // Set Operation name
-            operation.name = [NSString stringWithFormat:@"Request<%@> %@", requestIdentifier, url];
-            
-            // Add cancellation token block
-            [cancellationToken registerCancellationObserverWithBlock:^{
-                [operation cancel];
-            }];
-            
-            // Add Operation to the queue
-            [strongSelf.operationsQueue addOperation:operation];
-            return completionSource.task;
+    AGRestLogInfo(@"<AGRestServer> Fetch request <%@> in background on %@ :\nmethod: %@\nurl: %@\nparams: %@\nheaders: %@\n",
+                  requestIdentifier, self.name, method, url, (parameters)?:@"nil", (headers)?:@"nil");
+    
+    BFTaskCompletionSource *completionSource = [BFTaskCompletionSource taskCompletionSource];
+    
+    void (^success)(NSURLSessionDataTask *, id) = ^(NSURLSessionDataTask *task, id result)
+    {
+        _AGRestServerRecordCompletionHop(task);
+        _AGRestServerRecordResponseTrace(trace, task);
+        
+        // Map with AGRestResponse
+        NSDictionary    *header = [(NSHTTPURLResponse *)task.response allHeaderFields];
+    
+        NSInteger       statusCode = [(NSHTTPURLResponse *)task.response statusCode];
+        AGRestResponse  *response = [AGRestResponse responseWithData:result
+                                                              header:header
+                                                          statusCode:statusCode];
+        [completionSource setResult:response];
+    };
+    void (^failure)(NSURLSessionDataTask *, NSError *) = ^(NSURLSessionDataTask *task, NSError *error)
+    {
+        _AGRestServerRecordCompletionHop(task);
+        _AGRestServerRecordResponseTrace(trace, task);
+        
+        // Map with AGRestResponse
+        NSInteger       statusCode = [(NSHTTPURLResponse *)task.response statusCode];
+        
+        NSData          *errorData = error.userInfo[kAlamoSerializationReponseErrorData];
+        NSDictionary    *errorDict = nil;
+        if (errorData) {
+            errorDict = [NSJSONSerialization JSONObjectWithData:errorData options:NSJSONReadingAllowFragments error:nil];
+        }
+        
+        AGRestResponse  *response = [AGRestResponse responseWithError:error statusCode:statusCode];
+        response.responseData = errorDict;
+        [completionSource setResult:response];
+    };
+    
+    // Create the request operation, from the url request of its template if any
+    AFHTTPSessionOperation *operation = nil;
+    if (urlRequest) {
+        operation = [AFHTTPSessionOperation operationWithManager:self
+                                                      urlRequest:urlRequest
+                                                         success:success
+                                                         failure:failure];
+    } else {
+        operation = [AFHTTPSessionOperation operationWithManager:self
+                                                          method:method
+                                                       urlString:url
+                                                      parameters:parameters
+                                                         headers:headers
+                                                         success:success
+                                                         failure:failure];
+    }
+    // Set Operation name
+    operation.name = [NSString stringWithFormat:@"Request<%@> %@", requestIdentifier, url];
+    
+    // Add cancellation token block
+    [cancellationToken registerCancellationObserverWithBlock:^{
+        [operation cancel];
+    }];
+    
+    // Add Operation to the queue
+    operation.trace = trace;
+    [trace beginStage:AGRestRequestTraceStageServerQueueWait];
+    operation.enqueueTime = AGRestPipelineCurrentTime();
+    [self.operationsQueue addOperation:operation];
+    return completionSource.task;
+}
+
+- (nullable NSURLRequest *)_templateURLRequestForRequest:(nonnull AGRestRequest *)request {
+    AGRestRequestTemplate *requestTemplate = request.requestTemplate;
+    if (!requestTemplate ||
+        requestTemplate.httpMethod != request.httpMethod ||
+        ![requestTemplate.endPoint isEqualToString:request.endPoint]) {
+        return nil;
+    }
+    // On failure the request is built the regular way, which reports the error.
+    return [requestTemplate _URLRequestWithParameters:request.templateParameters
+                                              baseURL:self.baseURL
+                                    requestSerializer:self.requestSerializer
+                                       headersVersion:(NSUInteger)_requestHeadersVersion
+                                                error:nil];
+}
+
+#pragma mark - Warm-up
+#pragma mark -
+
+- (BFTask *)warmUpConnectionsToURLs:(nonnull NSArray<NSURL *> *)urls {
+    return [BFTask taskFromExecutor:[BFExecutor defaultPriorityBackgroundExecutor] withBlock:^id{
+        NSMutableArray *tasks = [NSMutableArray arrayWithCapacity:urls.count];
+        for (NSURL *url in urls) {
+            [tasks addObject:[self _warmUpConnectionToURL:url]];
+        }
+        return [[BFTask taskForCompletionOfAllTasks:tasks] continueWithBlock:^id(BFTask *task) {
+            return [tasks valueForKey:@"result"];
+        }];
+    }];
+}
+
+- (BFTask *)_warmUpConnectionToURL:(nonnull NSURL *)url {
+    NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:url
+                                                              cachePolicy:NSURLRequestReloadIgnoringLocalCacheData
+                                                          timeoutInterval:AGRestServerWarmUpTimeoutInterval];
+    urlRequest.HTTPMethod = @"HEAD";
+    
+    AGRestRequestTrace *trace = [AGRestRequestTrace traceWithRequestIdentifier:[NSString stringWithFormat:@"warm-up %@", url.host]];
+    NSTimeInterval startTime = AGRestPipelineCurrentTime();
+    BFTaskCompletionSource *completionSource = [BFTaskCompletionSource taskCompletionSource];
+    
+    NSURLSessionDataTask *task = [self dataTaskWithRequest:urlRequest
+                                         completionHandler:^(NSURLResponse *urlResponse, id responseObject, NSError *error)
+    {
+        // The network stages are only known from the session metrics, the log reports the whole exchange otherwise.
+        NSTimeInterval totalDuration = AGRestPipelineCurrentTime() - startTime;
+        
+        // A response of any kind means the connection is open, only transport errors are failures.
+        NSInteger statusCode = [(NSHTTPURLResponse *)urlResponse statusCode];
+        AGRestResponse *response = nil;
+        if (urlResponse) {
+            response = [AGRestResponse responseWithData:nil
+                                                 header:[(NSHTTPURLResponse *)urlResponse allHeaderFields]
+                                             statusCode:statusCode];
+            AGRestLogInfo(@"<AGRestServer> Connection to %@ warmed up in %.1f ms total : %@",
+                          url.host, totalDuration * 1000.0, [trace dictionaryRepresentation]);
+        } else {
+            NSError *warmUpError = error ?: [AGRestErrorUtilities errorWithCode:kAGErrorConnectionFailed
+                                                                         message:@"<AGRestServer> Connection warm-up failed."
+                                                                       shouldLog:NO];
+            response = [AGRestResponse responseWithError:warmUpError statusCode:statusCode];
+            AGRestLogWarn(@"<AGRestServer> Connection warm-up to %@ failed : %@", url.host, warmUpError.localizedDescription);
         }
-        return [BFTask taskWithResult:nil];
+        response.trace = trace;
+        [completionSource setResult:response];
     }];
-    return task;
+    
+    [trace attachToTask:task];
+    [task resume];
+    return completionSource.task;
+}
+
+#pragma mark - NSURLSessionTaskDelegate
+#pragma mark -
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    if ([AGRestPipelineInstrumentation isEnabled]) {
+        objc_setAssociatedObject(task, _AGRestServerCompletionTimeKey, @(AGRestPipelineCurrentTime()), OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    [super URLSession:session task:task didCompleteWithError:error];
+}
+
+#if defined(__IPHONE_10_0) && __IPHONE_OS_VERSION_MAX_ALLOWED >= __IPHONE_10_0
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics {
+    [[AGRestRequestTrace traceForTask:task] recordTaskMetrics:metrics];
+}
+#endif
+
+#pragma mark - Reachability
+#pragma mark -
+
+- (void)setMaxConcurrentOperationCount:(NSInteger)maxConcurrentOperationCount {
+    _maxConcurrentOperationCount = maxConcurrentOperationCount;
+    if (_operationQueueAccessQueue && maxConcurrentOperationCount > 0) {
+        self.operationsQueue.maxConcurrentOperationCount = maxConcurrentOperationCount;
+    }
 }
 
 - (void)didReachabilityChanged:(NSNotification *)aNotification {
     
+    // A fixed limit doesn't follow the connectivity
+    if (self.maxConcurrentOperationCount > 0) {
+        return;
+    }
+    
     // Update max concurrent operations depending of the connectivity
     NSInteger reachabilityStatus = [aNotification.object integerValue];
     switch (reachabilityStatus) {
@@ -0,0 +1,113 @@
+//
+//  AGRestSessionServer.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 09/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "AGRestConstants.h"
+#import "AGRestServerProtocol.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class AGRestSessionServer
+
+ @discussion A server running every request straight on its own NSURLSession, without an operations queue in front of it.
+
+ AGRestServer runs each request in an operation of a queue limited to a few concurrent operations, so that requests wait
+ in the queue even when the connection could carry more. AGRestSessionServer hands every request to the session as soon
+ as it's run and lets the session schedule them: requests to a host are multiplexed on a single connection when it speaks
+ HTTP/2, and otherwise spread over at most `HTTPMaximumConnectionsPerHost` kept-alive connections of the configuration.
+ Session events are delivered on a serial queue which does nothing else, responses are validated on a background queue.
+
+ Requests, request templates and responses are the same as with AGRestServer: the JSON request serializer, and the raw
+ response data handed to the response serializer. The trace of each request holds its network stages, protocol and
+ whether its connection was reused.
+
+ @note The session retains the server until `reset` is called.
+
+ Use it as the default server with `[AGRest setServerInstance:]`, or for a single host with `[AGRest addServerInstance:forBaseUrl:]`.
+ */
+@interface AGRestSessionServer : NSObject <AGRestServerProtocol>
+
+/*!
+ @abstract Name of the server, in the name of its session queue and in the logs.
+ */
+@property (nonatomic, copy, readonly) NSString  *name;
+
+/*!
+ @abstract Url the request end points are relative to.
+ */
+@property (nonatomic, strong, readonly) NSURL   *baseURL;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+///------------------
+/// @name Initialize
+///------------------
+/*!
+ @abstract Return a new server, with its own session and connections.
+ @param name            The server name.
+ @param url             The base server url.
+ @param configuration   The session configuration, e.g. to change the connections per host. Default configuration if nil.
+ @return A configured server, nil if the url is invalid.
+ */
++ (nullable instancetype)serverWithName:(nonnull NSString *)name
+                                baseUrl:(nonnull NSString *)url
+                   sessionConfiguration:(nullable NSURLSessionConfiguration *)configuration;
+
+/*!
+ @abstract Cancel the running requests and invalidate the session. Requests run afterwards fail.
+ */
+- (void)reset;
+
+///------------------
+/// @name Run Request
+///------------------
+/*!
+ @abstract Run a request asynchronously.
+ @param request AGRestRequest to execute.
+ @param options AGRestRequestRunningOptions for running the request.
+ @return Returns a BFTask resolving to an AGRestResponse.
+ */
+- (BFTask *)runRequestAsync:(nonnull AGRestRequest *)request
+                withOptions:(AGRestRequestRunningOptions)options;
+
+/*!
+ @abstract Run a request asynchronously.
+ @param request AGRestRequest to execute.
+ @param options AGRestRequestRunningOptions for running the request.
+ @param cancellationToken The BFCancellationToken for cancelling the request.
+ @return Returns a BFTask resolving to an AGRestResponse.
+ */
+- (BFTask *)runRequestAsync:(nonnull AGRestRequest *)request
+                withOptions:(AGRestRequestRunningOptions)options
+          cancellationToken:(nullable BFCancellationToken *)cancellationToken;
+
+///------------------
+/// @name Warm-up
+///------------------
+/*!
+ @abstract Send a HEAD request to each url through the server session, so that the connections are in its pool
+ before the first request.
+ @param urls NSArray of NSURL to connect to.
+ @return Returns a BFTask resolving to an NSArray of AGRestResponse, one per url in the same order.
+ */
+- (BFTask *)warmUpConnectionsToURLs:(nonnull NSArray<NSURL *> *)urls;
+
+///------------------
+/// @name Configure
+///------------------
+- (void)setValue:(nullable NSString *)value forHTTPHeaderField:(nonnull NSString *)key;
+
+- (void)setAcceptableContentTypes:(nonnull NSSet *)contentTypes;
+
+- (void)setAcceptableStatusCodes:(nonnull NSIndexSet *)httpStatusCodes;
+
+@end
+
+NS_ASSUME_NONNULL_END
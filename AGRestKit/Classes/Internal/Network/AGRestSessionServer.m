@@ -0,0 +1,373 @@
+//
+//  AGRestSessionServer.m
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 09/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestSessionServer.h"
+
+#import <AFNetworking/AFURLRequestSerialization.h>
+#import <AFNetworking/AFURLResponseSerialization.h>
+#import <libkern/OSAtomic.h>
+
+#import "Bolts.h"
+
+#import "AGRestServer.h"
+#import "AGRestRequest.h"
+#import "AGRestRequest+Format.h"
+#import "AGRestResponse.h"
+#import "AGRestErrorUtilities.h"
+#import "AGRestLogger.h"
+#import "AGRestPipelineInstrumentation.h"
+#import "AGRestRequestTrace_Private.h"
+#import "AGRestRequest_Private.h"
+#import "AGRestRequestTemplate_Private.h"
+
+static NSString * kRestSessionServerDelegateQueueName    = @"com.restserver.session";
+
+static NSString * kRestSessionServerHTTPHeaderContentTypeKey = @"Content-Type";
+static NSString * kRestSessionServerHTTPHeaderAcceptKey      = @"Accept";
+static NSString * kRestSessionServerHTTPContentTypeJson      = @"application/json";
+
+@interface AGRestSessionServer () <NSURLSessionDataDelegate> {
+    NSURLSession        *_session;
+    // Changed whenever a header is set, so that request templates prepared with the old headers get prepared again.
+    volatile int32_t    _requestHeadersVersion;
+}
+
+@property (nonatomic, copy, readwrite) NSString                         *name;
+@property (nonatomic, strong, readwrite) NSURL                          *baseURL;
+@property (nonatomic, strong) AFJSONRequestSerializer                   *requestSerializer;
+@property (nonatomic, strong) AFHTTPResponseSerializer                  *responseSerializer;
+
+- (instancetype)initWithName:(NSString *)name
+                     baseURL:(NSURL *)baseURL
+        sessionConfiguration:(nullable NSURLSessionConfiguration *)configuration;
+
+- (nullable NSURLSession *)_currentSession;
+
+- (nullable NSURLRequest *)_URLRequestForRequest:(nonnull AGRestRequest *)request
+                                           error:(NSError * __autoreleasing *)error;
+
+- (AGRestResponse *)_responseWithData:(nullable NSData *)data
+                          urlResponse:(nullable NSURLResponse *)urlResponse
+                                error:(nullable NSError *)error
+                                trace:(nullable AGRestRequestTrace *)trace;
+
+@end
+
+@implementation AGRestSessionServer
+
+#pragma mark - Init methods
+#pragma mark -
+
++ (nullable instancetype)serverWithName:(nonnull NSString *)name
+                                baseUrl:(nonnull NSString *)url
+                   sessionConfiguration:(nullable NSURLSessionConfiguration *)configuration
+{
+    NSURL *baseURL = (url.length) ? [NSURL URLWithString:url] : nil;
+    if (!baseURL.host) {
+        return nil;
+    }
+    return [[self alloc] initWithName:name baseURL:baseURL sessionConfiguration:configuration];
+}
+
+- (instancetype)initWithName:(NSString *)name
+                     baseURL:(NSURL *)baseURL
+        sessionConfiguration:(nullable NSURLSessionConfiguration *)configuration
+{
+    self = [super init];
+    if (!self) return nil;
+
+    _name = [name copy];
+
+    // End points resolve under the base url path only when it ends with a slash
+    if (baseURL.path.length && ![baseURL.absoluteString hasSuffix:@"/"]) {
+        baseURL = [baseURL URLByAppendingPathComponent:@""];
+    }
+    _baseURL = baseURL;
+
+    // Configure the session, it copies the configuration
+    NSURLSessionConfiguration *sessionConfiguration = [configuration copy] ?: [NSURLSessionConfiguration defaultSessionConfiguration];
+    [sessionConfiguration setTimeoutIntervalForRequest:AGRestRequestSessionTimeoutInterval];
+    [sessionConfiguration setTimeoutIntervalForResource:AGRestRessourceSessionTimeoutInterval];
+    [sessionConfiguration setRequestCachePolicy:NSURLRequestReloadIgnoringLocalCacheData];
+
+    // Session events only complete the tasks, a serial queue is enough however many requests are running
+    NSOperationQueue *delegateQueue = [[NSOperationQueue alloc] init];
+    delegateQueue.maxConcurrentOperationCount = 1;
+    delegateQueue.name = [NSString stringWithFormat:@"%@.%@", kRestSessionServerDelegateQueueName, _name];
+    delegateQueue.qualityOfService = NSQualityOfServiceUserInitiated;
+    _session = [NSURLSession sessionWithConfiguration:sessionConfiguration delegate:self delegateQueue:delegateQueue];
+
+    // Set the Response Serializer, the response data is decoded by the AGRestResponseSerializer
+    _responseSerializer = [AFHTTPResponseSerializer serializer];
+
+    // Set the Request Serializer
+    _requestSerializer = [AFJSONRequestSerializer serializerWithWritingOptions:NSJSONWritingPrettyPrinted];
+    [_requestSerializer setValue:kRestSessionServerHTTPContentTypeJson forHTTPHeaderField:kRestSessionServerHTTPHeaderAcceptKey];
+    [_requestSerializer setValue:kRestSessionServerHTTPContentTypeJson forHTTPHeaderField:kRestSessionServerHTTPHeaderContentTypeKey];
+    [_requestSerializer setHTTPShouldHandleCookies:NO];
+    [_requestSerializer setTimeoutInterval:AGRestRequestSessionTimeoutInterval];
+
+    return self;
+}
+
+- (void)reset {
+    NSURLSession *session = nil;
+    @synchronized(self) {
+        session = _session;
+        _session = nil;
+    }
+    // The session retains its delegate, this server, until invalidated
+    [session invalidateAndCancel];
+}
+
+- (nullable NSURLSession *)_currentSession {
+    @synchronized(self) {
+        return _session;
+    }
+}
+
+#pragma mark - AGRestRequestRunning
+#pragma mark -
+
+- (BFTask *)runRequestAsync:(AGRestRequest *)request withOptions:(AGRestRequestRunningOptions)options {
+    return [self runRequestAsync:request withOptions:options cancellationToken:nil];
+}
+
+- (BFTask *)runRequestAsync:(AGRestRequest *)request
+                withOptions:(AGRestRequestRunningOptions)options
+          cancellationToken:(BFCancellationToken *)token
+{
+    if (token.cancellationRequested) {
+        return [BFTask cancelledTask];
+    }
+
+    [request.trace endStage:AGRestRequestTraceStageRunnerDispatch];
+
+    NSURLSession *session = [self _currentSession];
+    if (!session) {
+        NSString *errorMsg = [NSString stringWithFormat:@"<AGRestSessionServer> Server %@ has been reset.", self.name];
+        NSError *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal
+                                                     message:errorMsg
+                                                   shouldLog:NO];
+        return [BFTask taskWithError:error];
+    }
+
+    switch (request.httpMethod)
+    {
+        case AGRestRequestMethodHttpPOST:
+        case AGRestRequestMethodHttpPUT:
+        case AGRestRequestMethodHttpHEAD:
+        case AGRestREquestMethodHttpPATCH:
+        case AGRestRequestMethodHttpGET:
+        case AGRestRequestMethodHttpDELETE: break;
+
+        default: {
+            NSString *errorMsg = [NSString stringWithFormat:@"<AGRestSessionServer> HTTP method not supported : %@", request.httpMethodString];
+            NSError *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal
+                                                         message:errorMsg
+                                                       shouldLog:NO];
+            return [BFTask taskWithError:error];
+        }  break;
+    }
+
+    AGRestLogInfo(@"<AGRestSessionServer> Fetch request <%@> in background on %@ :\nmethod: %@\nurl: %@\nparams: %@\nheaders: %@\n",
+                  request.requestIdentifier, self.name, request.httpMethodString, request.endPoint,
+                  (request.body)?:@"nil", (request.headers)?:@"nil");
+
+    // A request which can't be serialized fails like the requests the server rejects
+    NSError *serializationError = nil;
+    NSURLRequest *urlRequest = [self _URLRequestForRequest:request error:&serializationError];
+    if (!urlRequest) {
+        return [BFTask taskWithResult:[AGRestResponse responseWithError:serializationError statusCode:0]];
+    }
+
+    BFTaskCompletionSource *completionSource = [BFTaskCompletionSource taskCompletionSource];
+    AGRestRequestTrace *trace = request.trace;
+
+    NSURLSessionDataTask *task = [session dataTaskWithRequest:urlRequest
+                                            completionHandler:^(NSData *data, NSURLResponse *urlResponse, NSError *error)
+    {
+        // Keep the session queue free for the other tasks events
+        NSTimeInterval handoffTime = AGRestPipelineCurrentTime();
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [AGRestPipelineInstrumentation recordHopForStage:AGRestPipelineStageCompletionQueue
+                                               queueingDelay:AGRestPipelineCurrentTime() - handoffTime];
+            [completionSource setResult:[self _responseWithData:data urlResponse:urlResponse error:error trace:trace]];
+        });
+    }];
+
+    // Add cancellation token block
+    [token registerCancellationObserverWithBlock:^{
+        [task cancel];
+    }];
+
+    if (trace) {
+        [trace attachToTask:task];
+    }
+    [task resume];
+    return completionSource.task;
+}
+
+#pragma mark - AGRestServerProtocol
+#pragma mark -
+
+- (void)setValue:(nullable NSString *)value forHTTPHeaderField:(nonnull NSString *)key {
+    [self.requestSerializer setValue:value forHTTPHeaderField:key];
+    OSAtomicIncrement32Barrier(&_requestHeadersVersion);
+}
+
+- (void)setAcceptableContentTypes:(nonnull NSSet *)contentTypes {
+    [self.responseSerializer setAcceptableContentTypes:contentTypes];
+}
+
+- (void)setAcceptableStatusCodes:(nonnull NSIndexSet *)httpStatusCodes {
+    [self.responseSerializer setAcceptableStatusCodes:httpStatusCodes];
+}
+
+#pragma mark - Private()
+#pragma mark -
+
+- (nullable NSURLRequest *)_URLRequestForRequest:(nonnull AGRestRequest *)request
+                                           error:(NSError * __autoreleasing *)error
+{
+    // From the url request of its template if any
+    AGRestRequestTemplate *requestTemplate = request.requestTemplate;
+    if (requestTemplate &&
+        requestTemplate.httpMethod == request.httpMethod &&
+        [requestTemplate.endPoint isEqualToString:request.endPoint]) {
+        // On failure the request is built the regular way, which reports the error.
+        NSURLRequest *urlRequest = [requestTemplate _URLRequestWithParameters:request.templateParameters
+                                                                      baseURL:self.baseURL
+                                                            requestSerializer:self.requestSerializer
+                                                               headersVersion:(NSUInteger)_requestHeadersVersion
+                                                                        error:nil];
+        if (urlRequest) {
+            return urlRequest;
+        }
+    }
+
+    NSString *url = [[NSURL URLWithString:request.endPoint relativeToURL:self.baseURL] absoluteString];
+    NSMutableURLRequest *urlRequest = [self.requestSerializer requestWithMethod:request.httpMethodString
+                                                                      URLString:url
+                                                                     parameters:request.body
+                                                                          error:error];
+
+    // Add custom headers for request
+    NSDictionary *headers = request.headers;
+    for (NSString *httpHeaderKey in [headers allKeys]) {
+        [urlRequest addValue:headers[httpHeaderKey] forHTTPHeaderField:httpHeaderKey];
+    }
+    return urlRequest;
+}
+
+- (AGRestResponse *)_responseWithData:(nullable NSData *)data
+                          urlResponse:(nullable NSURLResponse *)urlResponse
+                                error:(nullable NSError *)error
+                                trace:(nullable AGRestRequestTrace *)trace
+{
+    NSHTTPURLResponse *httpResponse = ([urlResponse isKindOfClass:[NSHTTPURLResponse class]]) ? (NSHTTPURLResponse *)urlResponse : nil;
+
+    // Validate the status code and content type
+    id responseObject = nil;
+    if (!error) {
+        NSTimeInterval startTime = AGRestPipelineCurrentTime();
+        responseObject = [self.responseSerializer responseObjectForResponse:urlResponse data:data error:&error];
+        [trace recordStage:AGRestRequestTraceStageDecode startTime:startTime endTime:AGRestPipelineCurrentTime()];
+    }
+    [trace beginStage:AGRestRequestTraceStageCompletion];
+
+    if (error) {
+        NSData          *errorData = error.userInfo[AFNetworkingOperationFailingURLResponseDataErrorKey];
+        NSDictionary    *errorDict = nil;
+        if (errorData) {
+            errorDict = [NSJSONSerialization JSONObjectWithData:errorData options:NSJSONReadingAllowFragments error:nil];
+        }
+
+        AGRestResponse  *response = [AGRestResponse responseWithError:error statusCode:httpResponse.statusCode];
+        response.responseData = errorDict;
+        return response;
+    }
+    return [AGRestResponse responseWithData:responseObject
+                                     header:httpResponse.allHeaderFields
+                                 statusCode:httpResponse.statusCode];
+}
+
+#pragma mark - Warm-up
+#pragma mark -
+
+- (BFTask *)warmUpConnectionsToURLs:(nonnull NSArray<NSURL *> *)urls {
+    return [BFTask taskFromExecutor:[BFExecutor defaultPriorityBackgroundExecutor] withBlock:^id{
+        NSMutableArray *tasks = [NSMutableArray arrayWithCapacity:urls.count];
+        for (NSURL *url in urls) {
+            [tasks addObject:[self _warmUpConnectionToURL:url]];
+        }
+        return [[BFTask taskForCompletionOfAllTasks:tasks] continueWithBlock:^id(BFTask *task) {
+            return [tasks valueForKey:@"result"];
+        }];
+    }];
+}
+
+- (BFTask *)_warmUpConnectionToURL:(nonnull NSURL *)url {
+    NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:url
+                                                              cachePolicy:NSURLRequestReloadIgnoringLocalCacheData
+                                                          timeoutInterval:AGRestServerWarmUpTimeoutInterval];
+    urlRequest.HTTPMethod = @"HEAD";
+
+    AGRestRequestTrace *trace = [AGRestRequestTrace traceWithRequestIdentifier:[NSString stringWithFormat:@"warm-up %@", url.host]];
+    NSTimeInterval startTime = AGRestPipelineCurrentTime();
+    BFTaskCompletionSource *completionSource = [BFTaskCompletionSource taskCompletionSource];
+
+    NSURLSessionDataTask *task = [[self _currentSession] dataTaskWithRequest:urlRequest
+                                                           completionHandler:^(NSData *data, NSURLResponse *urlResponse, NSError *error)
+    {
+        // The network stages are only known from the session metrics, the log reports the whole exchange otherwise.
+        NSTimeInterval totalDuration = AGRestPipelineCurrentTime() - startTime;
+
+        // A response of any kind means the connection is open, only transport errors are failures.
+        NSInteger statusCode = [(NSHTTPURLResponse *)urlResponse statusCode];
+        AGRestResponse *response = nil;
+        if (urlResponse) {
+            response = [AGRestResponse responseWithData:nil
+                                                 header:[(NSHTTPURLResponse *)urlResponse allHeaderFields]
+                                             statusCode:statusCode];
+            AGRestLogInfo(@"<AGRestSessionServer> Connection to %@ warmed up in %.1f ms total : %@",
+                          url.host, totalDuration * 1000.0, [trace dictionaryRepresentation]);
+        } else {
+            NSError *warmUpError = error ?: [AGRestErrorUtilities errorWithCode:kAGErrorConnectionFailed
+                                                                         message:@"<AGRestSessionServer> Connection warm-up failed."
+                                                                       shouldLog:NO];
+            response = [AGRestResponse responseWithError:warmUpError statusCode:statusCode];
+            AGRestLogWarn(@"<AGRestSessionServer> Connection warm-up to %@ failed : %@", url.host, warmUpError.localizedDescription);
+        }
+        response.trace = trace;
+        [completionSource setResult:response];
+    }];
+    if (!task) {
+        NSError *error = [AGRestErrorUtilities errorWithCode:kAGErrorConnectionFailed
+                                                     message:@"<AGRestSessionServer> Connection warm-up failed, the server has been reset."
+                                                   shouldLog:NO];
+        AGRestResponse *response = [AGRestResponse responseWithError:error statusCode:0];
+        response.trace = trace;
+        return [BFTask taskWithResult:response];
+    }
+
+    [trace attachToTask:task];
+    [task resume];
+    return completionSource.task;
+}
+
+#pragma mark - NSURLSessionTaskDelegate
+#pragma mark -
+
+#if defined(__IPHONE_10_0) && __IPHONE_OS_VERSION_MAX_ALLOWED >= __IPHONE_10_0
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics {
+    [[AGRestRequestTrace traceForTask:task] recordTaskMetrics:metrics];
+}
+#endif
+
+@end
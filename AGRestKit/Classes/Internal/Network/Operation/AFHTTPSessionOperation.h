@@ -9,6 +9,7 @@
 #import "AGRestConcurrentOperation.h"
 
 @class AFHTTPSessionManager;
+@class AGRestRequestTrace;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -22,6 +23,24 @@ NS_ASSUME_NONNULL_BEGIN
                                       success:(nullable void (^)(NSURLSessionDataTask *task, id responseObject))success
                                       failure:(nullable void (^)(NSURLSessionDataTask *task, NSError * error))failure;
 
+/*!
+ @abstract Returns an operation running an url request already built, e.g. from an AGRestRequestTemplate.
+ */
++ (nullable instancetype)operationWithManager:(nonnull AFHTTPSessionManager *)manager
+                                   urlRequest:(nonnull NSURLRequest *)urlRequest
+                                      success:(nullable void (^)(NSURLSessionDataTask *task, id responseObject))success
+                                      failure:(nullable void (^)(NSURLSessionDataTask *task, NSError * error))failure;
+
+/*!
+ @abstract Time at which the operation was added to its queue, from `AGRestPipelineCurrentTime()`.
+ @discussion When set, the time spent waiting in the queue is recorded once the operation starts.
+ */
+@property (nonatomic, assign) NSTimeInterval enqueueTime;
+/*!
+ @abstract Trace of the request run by the operation, attached to its session task.
+ */
+@property (nonatomic, strong, nullable) AGRestRequestTrace *trace;
+
 - (void)resume;
 - (void)suspend;
 
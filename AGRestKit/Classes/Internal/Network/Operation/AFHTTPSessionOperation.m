@@ -9,6 +9,9 @@
 #import "AFHTTPSessionOperation.h"
 #import "AFNetworking.h"
 
+#import "AGRestPipelineInstrumentation.h"
+#import "AGRestRequestTrace_Private.h"
+
 @interface AFHTTPSessionManager (DataTask)
 
 // this method is not publicly defined in @interface in .h, so we need to define our own interface for it
@@ -27,6 +30,7 @@
 @property (nonatomic, copy) NSString *urlString;
 @property (nonatomic, copy) id parameters;
 @property (nonatomic, copy) NSDictionary * headers;
+@property (nonatomic, copy) NSURLRequest *urlRequest;
 @property (nonatomic, copy) void (^success)(NSURLSessionDataTask *task, id responseObject);
 @property (nonatomic, copy) void (^failure)(NSURLSessionDataTask *task, NSError * error);
 
@@ -57,22 +61,55 @@
     return operation;
 }
 
-- (void)main {    
-    NSURLSessionTask *task = [self dataTaskWithHTTPMethod:self.method
-                                                urlString:self.urlString
-                                               parameters:self.parameters
-                                                  headers:self.headers
-                                                  success:^(NSURLSessionDataTask *task, id responseObject) {
++ (nullable instancetype)operationWithManager:(nonnull AFHTTPSessionManager *)manager
+                                   urlRequest:(nonnull NSURLRequest *)urlRequest
+                                      success:(nullable void (^)(NSURLSessionDataTask *task, id responseObject))success
+                                      failure:(nullable void (^)(NSURLSessionDataTask *task, NSError * error))failure
+{
+    AFHTTPSessionOperation *operation = [[self alloc] init];
+    
+    operation.manager = manager;
+    operation.urlRequest = urlRequest;
+    operation.success = success;
+    operation.failure = failure;
+    
+    return operation;
+}
+
+- (void)main {
+    if (self.enqueueTime > 0) {
+        [AGRestPipelineInstrumentation recordHopForStage:AGRestPipelineStageOperationQueue
+                                           queueingDelay:AGRestPipelineCurrentTime() - self.enqueueTime];
+    }
+    [self.trace endStage:AGRestRequestTraceStageServerQueueWait];
+    
+    void (^success)(NSURLSessionDataTask *, id) = ^(NSURLSessionDataTask *task, id responseObject) {
         if (self.success) {
             self.success(task, responseObject);
         }
         [self completeOperation];
-    } failure:^(NSURLSessionDataTask *task, NSError *error) {
+    };
+    void (^failure)(NSURLSessionDataTask *, NSError *) = ^(NSURLSessionDataTask *task, NSError *error) {
         if (self.failure) {
             self.failure(task, error);
         }
         [self completeOperation];
-    }];
+    };
+    
+    NSURLSessionTask *task = nil;
+    if (self.urlRequest) {
+        task = [self dataTaskWithRequest:self.urlRequest success:success failure:failure];
+    } else {
+        task = [self dataTaskWithHTTPMethod:self.method
+                                  urlString:self.urlString
+                                 parameters:self.parameters
+                                    headers:self.headers
+                                    success:success
+                                    failure:failure];
+    }
+    if (task && self.trace) {
+        [self.trace attachToTask:task];
+    }
     [task resume];
     self.task = task;
 }
@@ -110,6 +147,13 @@
         [request addValue:httpHeaderValue forHTTPHeaderField:httpHeaderKey];
     }
     
+    return [self dataTaskWithRequest:request success:success failure:failure];
+}
+
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request
+                                      success:(void (^)(NSURLSessionDataTask *, id))success
+                                      failure:(void (^)(NSURLSessionDataTask *, NSError *))failure
+{
     __block NSURLSessionDataTask *dataTask = nil;
     dataTask = [self.manager dataTaskWithRequest:request completionHandler:^(NSURLResponse * __unused response, id responseObject, NSError *error) {
         if (error) {
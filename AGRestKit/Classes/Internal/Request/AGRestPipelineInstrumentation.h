@@ -0,0 +1,64 @@
+//
+//  AGRestPipelineInstrumentation.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 25/10/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  @typedef AGRestPipelineStage
+ *  Thread handoffs a request goes through between submission and completion.
+ */
+typedef NS_ENUM(NSUInteger, AGRestPipelineStage) {
+    /*!
+     From the submitting thread to a background thread, before the request is run.
+     */
+    AGRestPipelineStageSubmission = 0,
+    /*!
+     From the runner to the server operation queue, right before the request goes on the wire.
+     */
+    AGRestPipelineStageOperationQueue,
+    /*!
+     From the URL session to the server completion queue, once the response is received and decoded.
+     */
+    AGRestPipelineStageCompletionQueue,
+    AGRestPipelineStageCount
+};
+
+/*!
+ @return Monotonic time in seconds, suitable for measuring short intervals.
+ */
+extern NSTimeInterval AGRestPipelineCurrentTime(void);
+
+/*!
+ @class AGRestPipelineInstrumentation
+ 
+ @discussion Process-wide counters of the thread hops taken by requests, and of the time spent
+ waiting in each queue before the work started. Disabled by default, hops are then not recorded at all.
+ */
+@interface AGRestPipelineInstrumentation : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
++ (void)setEnabled:(BOOL)enabled;
++ (BOOL)isEnabled;
+
++ (void)recordHopForStage:(AGRestPipelineStage)stage queueingDelay:(NSTimeInterval)queueingDelay;
+
++ (NSUInteger)hopCountForStage:(AGRestPipelineStage)stage;
++ (NSTimeInterval)totalQueueingDelayForStage:(AGRestPipelineStage)stage;
++ (NSTimeInterval)maxQueueingDelayForStage:(AGRestPipelineStage)stage;
+
+/*!
+ @abstract Reset every counter to zero.
+ */
++ (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,79 @@
+//
+//  AGRestPipelineInstrumentation.m
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 25/10/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestPipelineInstrumentation.h"
+
+#import <libkern/OSAtomic.h>
+#import <mach/mach_time.h>
+
+// Delays are kept in nanoseconds, so that every counter is updated with a single atomic operation.
+typedef struct {
+    volatile int64_t    hopCount;
+    volatile int64_t    totalQueueingDelay;
+    volatile int64_t    maxQueueingDelay;
+} _AGRestPipelineStageCounters;
+
+static _AGRestPipelineStageCounters _AGRestPipelineCounters[AGRestPipelineStageCount];
+static volatile int32_t _AGRestPipelineInstrumentationEnabled = 0;
+
+NSTimeInterval AGRestPipelineCurrentTime(void) {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+    return (NSTimeInterval)(mach_absolute_time() * timebase.numer / timebase.denom) / NSEC_PER_SEC;
+}
+
+@implementation AGRestPipelineInstrumentation
+
++ (void)setEnabled:(BOOL)enabled {
+    _AGRestPipelineInstrumentationEnabled = (enabled) ? 1 : 0;
+    OSMemoryBarrier();
+}
+
++ (BOOL)isEnabled {
+    return (_AGRestPipelineInstrumentationEnabled != 0);
+}
+
++ (void)recordHopForStage:(AGRestPipelineStage)stage queueingDelay:(NSTimeInterval)queueingDelay {
+    if (!_AGRestPipelineInstrumentationEnabled || stage >= AGRestPipelineStageCount) {
+        return;
+    }
+    _AGRestPipelineStageCounters *counters = &_AGRestPipelineCounters[stage];
+    int64_t delay = (int64_t)(MAX(queueingDelay, 0) * NSEC_PER_SEC);
+    OSAtomicIncrement64(&counters->hopCount);
+    OSAtomicAdd64(delay, &counters->totalQueueingDelay);
+    int64_t maxDelay = counters->maxQueueingDelay;
+    while (delay > maxDelay && !OSAtomicCompareAndSwap64(maxDelay, delay, &counters->maxQueueingDelay)) {
+        maxDelay = counters->maxQueueingDelay;
+    }
+}
+
++ (NSUInteger)hopCountForStage:(AGRestPipelineStage)stage {
+    return (stage < AGRestPipelineStageCount) ? (NSUInteger)_AGRestPipelineCounters[stage].hopCount : 0;
+}
+
++ (NSTimeInterval)totalQueueingDelayForStage:(AGRestPipelineStage)stage {
+    return (stage < AGRestPipelineStageCount) ? (NSTimeInterval)_AGRestPipelineCounters[stage].totalQueueingDelay / NSEC_PER_SEC : 0;
+}
+
++ (NSTimeInterval)maxQueueingDelayForStage:(AGRestPipelineStage)stage {
+    return (stage < AGRestPipelineStageCount) ? (NSTimeInterval)_AGRestPipelineCounters[stage].maxQueueingDelay / NSEC_PER_SEC : 0;
+}
+
++ (void)reset {
+    for (NSUInteger stage = 0; stage < AGRestPipelineStageCount; stage++) {
+        _AGRestPipelineCounters[stage].hopCount = 0;
+        _AGRestPipelineCounters[stage].totalQueueingDelay = 0;
+        _AGRestPipelineCounters[stage].maxQueueingDelay = 0;
+    }
+    OSMemoryBarrier();
+}
+
+@end
@@ -0,0 +1,35 @@
+//
+//  AGRestRequestTemplate_Private.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 04/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestRequestTemplate.h"
+
+@class AFHTTPRequestSerializer;
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface AGRestRequestTemplate ()
+
+/*!
+ @abstract Returns the url request of a template request, built from the prepared one.
+ @discussion The template is prepared again first when the base url or the headers version differ from the last preparation.
+ Thread safe.
+ @param parameters          The parameters specific to the request.
+ @param baseURL             The base url the endpoint is resolved against.
+ @param requestSerializer   The serializer providing the server headers and request settings.
+ @param headersVersion      Version of the serializer headers, changed by the server whenever a header is set.
+ @param error               Set if the url or the body couldn't be encoded.
+ */
+- (nullable NSMutableURLRequest *)_URLRequestWithParameters:(nullable NSDictionary *)parameters
+                                                    baseURL:(nullable NSURL *)baseURL
+                                          requestSerializer:(AFHTTPRequestSerializer *)requestSerializer
+                                             headersVersion:(NSUInteger)headersVersion
+                                                      error:(NSError * __autoreleasing *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
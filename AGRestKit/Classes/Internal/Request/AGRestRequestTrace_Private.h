@@ -0,0 +1,44 @@
+//
+//  AGRestRequestTrace_Private.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 30/10/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestRequestTrace.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface AGRestRequestTrace ()
+
++ (instancetype)traceWithRequestIdentifier:(NSString *)requestIdentifier;
+
+- (void)beginStage:(AGRestRequestTraceStage)stage;
+- (void)endStage:(AGRestRequestTraceStage)stage;
+/*!
+ @abstract Record a stage measured elsewhere, with wall clock dates (i.e. NSURLSessionTaskMetrics).
+ @discussion The dates are converted to `AGRestPipelineCurrentTime()` against the current date, so they must be recent.
+ */
+- (void)recordStage:(AGRestRequestTraceStage)stage startDate:(nullable NSDate *)startDate endDate:(nullable NSDate *)endDate;
+/*!
+ @abstract Record a stage measured elsewhere, with times from `AGRestPipelineCurrentTime()`.
+ */
+- (void)recordStage:(AGRestRequestTraceStage)stage startTime:(NSTimeInterval)startTime endTime:(NSTimeInterval)endTime;
+
+/*!
+ @abstract Associate the trace with the session task running the request, to find it back from session callbacks.
+ */
+- (void)attachToTask:(NSURLSessionTask *)task;
++ (nullable instancetype)traceForTask:(NSURLSessionTask *)task;
+
+#if defined(__IPHONE_10_0) && __IPHONE_OS_VERSION_MAX_ALLOWED >= __IPHONE_10_0
+/*!
+ @abstract Record the network stages, protocol and connection reuse from the metrics of the task running the request.
+ */
+- (void)recordTaskMetrics:(NSURLSessionTaskMetrics *)metrics;
+#endif
+
+@end
+
+NS_ASSUME_NONNULL_END
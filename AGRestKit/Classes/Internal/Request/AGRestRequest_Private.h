@@ -10,6 +10,40 @@
 
 #import "AGRestCachable.h"
 
+@class AGRestRequestTrace;
+@class AGRestRequestTemplate;
+@class BFTask;
+
 @interface AGRestRequest() <AGRestCachable>
 
+/*!
+ @abstract Trace of the current run of the request, created when it's submitted to the request controller.
+ */
+@property (strong, nullable) AGRestRequestTrace *trace;
+/*!
+ @abstract Template the request was created from. The server ignores it once the request no longer matches it.
+ */
+@property (strong, nullable) AGRestRequestTemplate *requestTemplate;
+/*!
+ @abstract Parameters of the request on top of the template body.
+ */
+@property (copy, nullable) NSDictionary *templateParameters;
+/*!
+ @abstract YES for the request refreshing the session, which is never parked behind the refresh it performs.
+ */
+@property (assign) BOOL sessionRefreshRequest;
+
+/*!
+ @abstract Send requests and wait for them, at most `timeout` seconds.
+ @discussion Fails with kAGErrorOperationForbidden, without calling `taskBlock`, on the main thread. On timeout, calls
+ `cancellationBlock` and fails with kAGErrorTimeout. Otherwise returns the finished task, cancelled tasks included.
+ @param timeout             Maximum time to wait.
+ @param taskBlock           Sends the requests, returns their task or nil when they can't be sent.
+ @param cancellationBlock   Cancels the requests.
+ @return Completed BFTask, or nil if `taskBlock` returned nil.
+ */
++ (nullable BFTask *)_sendSynchronouslyWithTimeout:(NSTimeInterval)timeout
+                                         taskBlock:(BFTask * _Nullable (^ _Nonnull)(void))taskBlock
+                                 cancellationBlock:(dispatch_block_t _Nonnull)cancellationBlock;
+
 @end
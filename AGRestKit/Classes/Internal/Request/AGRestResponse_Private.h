@@ -0,0 +1,36 @@
+//
+//  AGRestResponse_Private.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 04/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "AGRestResponse.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef _Nullable id (^AGRestResponseDataDecoder)(AGRestResponse *response);
+
+@interface AGRestResponse()
+
+/*!
+ @abstract Defers the decoding of the response body until `responseData` is first read.
+ @discussion The decoder runs at most once, on the first thread reading `responseData` and without holding any lock,
+ and its result replaces the raw body. While it runs, reads of `responseData` from the decoder itself return the raw body;
+ other threads wait for the result. Setting `responseData` discards a pending decoder, or the result of a running one.
+ @param decoder The block returning the decoded response data.
+ */
+- (void)_setResponseDataDecoder:(nullable AGRestResponseDataDecoder)decoder;
+
+/*!
+ @abstract Returns the response data without running a pending decoder.
+ @return The raw body while the decoder hasn't run, the decoded data afterwards.
+ */
+- (nullable id)_rawResponseData;
+
+@end
+
+NS_ASSUME_NONNULL_END
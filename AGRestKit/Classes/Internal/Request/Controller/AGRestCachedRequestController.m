@@ -13,6 +13,7 @@
 #import "AGRestKeyValueCache.h"
 #import "AGRestRequest.h"
 #import "AGRestResponse.h"
+#import "AGRestErrorUtilities.h"
 
 @implementation AGRestCachedRequestController
 
@@ -47,36 +48,39 @@
             
         // Load from network then cache if network failed
         case kAGRestRequestNetworkElseCache: {
-            return [[super runRequestAsync:request withCancellationToken:cancellationToken] continueWithBlock:^id(BFTask *task) {
-                AGRestResponse *response = task.result;
-                if (response.responseError || task.error) {
-                    return [self _runRequestAsyncFromCache:request withCancellationToken:cancellationToken];
+            return [[super runRequestAsync:request withCancellationToken:cancellationToken] continueWithBlock:^id(BFTask *networkTask) {
+                AGRestResponse *response = networkTask.result;
+                if (response.responseError || networkTask.error) {
+                    // On a cache miss, the network failure (e.g. `kAGErrorCircuitOpen`) is returned.
+                    return [[self _runRequestAsyncFromCache:request withCancellationToken:cancellationToken] continueWithBlock:^id(BFTask *task) {
+                        AGRestResponse *cachedResponse = task.result;
+                        return (cachedResponse.succeeded) ? task : networkTask;
+                    }];
                 }
-                return [task continueWithBlock:^id(BFTask *task) {
+                return [networkTask continueWithBlock:^id(BFTask *task) {
                     return [self _saveRequestResultAsync:response];
                 }];
             }];
         } break;
         
+        // Load from Cache then from Network
+        case kAGRestRequestCacheThenNetwork:
+            NSLog(@"kAGRestRequestCacheThenNetwork : Not implemented, loaded as kAGRestRequestCacheElseNetwork");
+            // Fall through
+            
         // Load from cache, if fails load from network
         case kAGRestRequestCacheElseNetwork: {
             return [[self _runRequestAsyncFromCache:request withCancellationToken:cancellationToken] continueWithBlock:^id(BFTask *task) {
                 AGRestResponse *response = task.result;
                 if (response.responseError || task.error) {
                     return [[super runRequestAsync:request withCancellationToken:cancellationToken] continueWithBlock:^id(BFTask *task) {
-                        return [self _saveRequestResultAsync:response];
+                        return [self _saveRequestResultAsync:task.result];
                     }];
                 }
                 return task;
             }];
         } break;
         
-        // Load from Cache then from Network
-        case kAGRestRequestCacheThenNetwork: {
-            NSLog(@"kAGRestRequestCacheThenNetwork : Not implemented");
-            return [self _runRequestAsyncFromCache:request withCancellationToken:cancellationToken];
-        } break;
-            
         // Unknown Cache Policy
         default: {
             return [BFTask taskWithError:[NSError errorWithDomain:AGRestErrorDomain
@@ -96,7 +100,12 @@
     // Load request from cache
     /// TODO: implement caching
     
-    return [BFTask taskWithResult:request];
+    // No cache is consulted yet, so every lookup misses and no hit or miss is recorded: `recordCacheHit` and
+    // `recordCacheMiss` belong with the lookup once it exists.
+    NSError *error = [AGRestErrorUtilities errorWithCode:kAGErrorObjectNotFound
+                                                 message:@"<AGRestCachedRequestController> No cached response."
+                                               shouldLog:NO];
+    return [BFTask taskWithResult:[AGRestResponse responseWithError:error]];
 }
 
 - (BFTask *)_saveRequestResultAsync:(AGRestResponse *)response {
@@ -15,15 +15,18 @@
 @protocol AGRestRequestRunnerProvider;
 @protocol AGRestResponseSerializerProvider;
 @protocol AGRestEventuallyQueueProvider;
+@protocol AGRestSessionControllerProvider;
 
-typedef id<AGRestRequestRunnerProvider,AGRestResponseSerializerProvider,AGRestEventuallyQueueProvider> AGRestRequestControllerDataSource;
+typedef id<AGRestRequestRunnerProvider,AGRestResponseSerializerProvider,AGRestEventuallyQueueProvider,AGRestSessionControllerProvider> AGRestRequestControllerDataSource;
 
 NS_ASSUME_NONNULL_BEGIN
 
 /*!
  @class AGRestRequestController
  
- @discussion 
+ @discussion Requests rejected with a 401 refresh the session through the session controller and are replayed once with
+ the new session token. Requests submitted while the session is being refreshed are parked until the refresh completes,
+ and fail with the refresh error, without being sent, if the session couldn't be refreshed.
  */
 @interface AGRestRequestController : NSObject
 
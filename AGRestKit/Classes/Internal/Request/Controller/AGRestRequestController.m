@@ -15,12 +15,20 @@
 #import "AGRestDataProvider.h"
 #import "AGRestRequestRunning.h"
 #import "AGRestRequest.h"
+#import "AGRestRequest_Private.h"
+#import "AGRestRequest+Format.h"
+#import "AGRestRequestTrace_Private.h"
 #import "AGRestResponse.h"
+#import "AGRestResponse_Private.h"
 #import "AGRestResponseSerializer.h"
 #import "AGRestRequestCache.h"
 #import "AGRest_Private.h"
 #import "AGRestLogger.h"
+#import "AGRestMetricsCollecting.h"
+#import "AGRestTrafficRecorder.h"
 #import "AGRestErrorUtilities.h"
+#import "AGRestSessionProtocol.h"
+#import "AGRestPipelineInstrumentation.h"
 
 @interface AGRestRequestController()
 
@@ -55,16 +63,40 @@
         return [BFTask cancelledTask];
     }
     
+    // Park the request while the session is refreshed, it would be rejected with the expired session token.
+    BFTask *sessionRefreshTask = [self _sessionRefreshTaskForRequest:request];
+    if (sessionRefreshTask) {
+        weakify(self);
+        return [sessionRefreshTask continueWithBlock:^id(BFTask *task) {
+            strongify(weakSelf);
+            if (task.faulted || task.cancelled) {
+                // Still the expired session token, sending the request would only be rejected again.
+                return [BFTask taskWithResult:[strongSelf _responseForRequest:request failedSessionRefreshTask:task]];
+            }
+            return [strongSelf _sendRequestAsync:request withCancellationToken:cancellationToken replay:NO];
+        } cancellationToken:cancellationToken];
+    }
+    return [self _sendRequestAsync:request withCancellationToken:cancellationToken replay:NO];
+}
+
+#pragma mark - Private
+#pragma mark -
+
+- (BFTask *)_sendRequestAsync:(nonnull AGRestRequest *)request
+        withCancellationToken:(nullable BFCancellationToken *)cancellationToken
+                       replay:(BOOL)replay
+{
+    // Session token the request is sent with, to tell whether a 401 has already been handled by a refresh.
+    NSString *sessionToken = (!replay && !request.sessionRefreshRequest) ? [self _currentSessionToken] : nil;
+    
+    AGRestRequestTrace *trace = [AGRestRequestTrace traceWithRequestIdentifier:request.requestIdentifier];
+    [trace beginStage:AGRestRequestTraceStageEnqueue];
+    request.trace = trace;
+    
+    // Execute the request whith request runner for class, which hops off the calling thread once.
+    // The continuation runs inline on the server completion queue.
     weakify(self);
-    return [[BFTask taskFromExecutor:[BFExecutor defaultPriorityBackgroundExecutor] withBlock:^id{
-        strongify(weakSelf)
-        if (cancellationToken.cancellationRequested) {
-            return [BFTask cancelledTask];
-        }
-        
-        // Execute the request whith request runner for class
-        return [strongSelf _runRequestAsync:request withCancellationToken:cancellationToken];
-    }] continueWithBlock:^id(BFTask *task) {
+    return [[self _runRequestAsync:request withCancellationToken:cancellationToken] continueWithBlock:^id(BFTask *task) {
         strongify(weakSelf)
         
         // Get the AGRestResponse from task result
@@ -82,6 +114,7 @@
             }
             // Attach the original request to the response
             response.request = request;
+            response.trace = trace;
             task = [strongSelf _handleRequest:request withResponse:response];
         }
         else
@@ -91,7 +124,29 @@
                                                                                  message:task.error.localizedDescription
                                                                                shouldLog:NO];
             AGRestResponse *errorResponse = [AGRestResponse responseWithError:error];
+            errorResponse.trace = trace;
             task = [BFTask taskWithResult:errorResponse];
+            response = errorResponse;
+        }
+        
+        [trace endStage:AGRestRequestTraceStageCompletion];
+        AGRestManager *manager = [AGRest _currentManager];
+        id<AGRestLogging> logger = manager.logger;
+        if ([logger respondsToSelector:@selector(logTrace:)]) {
+            [logger logTrace:trace];
+        }
+        [manager.metrics recordRequestWithMethod:[request httpMethodString]
+                                        endpoint:request.endPoint
+                                      statusCode:[response httpStatusCode]
+                                        duration:trace.totalDuration];
+        [manager.trafficRecorder recordRequest:request response:response];
+        
+        // Session expired, refresh it and replay the request once.
+        if (sessionToken && [response httpStatusCode] == 401) {
+            return [strongSelf _replayRequestAsync:request
+                       afterRefreshingSessionToken:sessionToken
+                                      originalTask:task
+                                 cancellationToken:cancellationToken];
         }
         return task;
     } cancellationToken:cancellationToken];
@@ -100,9 +155,72 @@
 - (BFTask *)_runRequestAsync:(nonnull AGRestRequest *)request
       withCancellationToken:(nullable BFCancellationToken *)cancellationToken
 {
-    return [self.dataSource.requestRunner runRequestAsync:request
-                                              withOptions:AGRestRequestRunningOptionRetryIfFailed
-                                        cancellationToken:cancellationToken];
+    // The only hop before the server operation queue: the runner, the server and their logs never run
+    // on the calling thread, which is often the main thread.
+    NSTimeInterval submissionTime = AGRestPipelineCurrentTime();
+    weakify(self);
+    return [BFTask taskFromExecutor:[BFExecutor defaultPriorityBackgroundExecutor] withBlock:^id{
+        strongify(weakSelf);
+        [AGRestPipelineInstrumentation recordHopForStage:AGRestPipelineStageSubmission
+                                           queueingDelay:AGRestPipelineCurrentTime() - submissionTime];
+        if (cancellationToken.cancellationRequested) {
+            return [BFTask cancelledTask];
+        }
+        return [strongSelf.dataSource.requestRunner runRequestAsync:request
+                                                        withOptions:AGRestRequestRunningOptionRetryIfFailed
+                                                  cancellationToken:cancellationToken];
+    }];
+}
+
+#pragma mark - Session Refresh
+#pragma mark -
+
+- (nullable NSString *)_currentSessionToken {
+    id<AGRestSessionProtocol> sessionController = self.dataSource.sessionController;
+    if ([sessionController respondsToSelector:@selector(refreshSessionAsyncWithExpiredSessionToken:)] &&
+        [sessionController respondsToSelector:@selector(currentSessionToken)]) {
+        return [sessionController currentSessionToken];
+    }
+    return nil;
+}
+
+- (nullable BFTask *)_sessionRefreshTaskForRequest:(nonnull AGRestRequest *)request {
+    // The refresh request must go through, it's what the others are waiting for.
+    if (request.sessionRefreshRequest) {
+        return nil;
+    }
+    id<AGRestSessionProtocol> sessionController = self.dataSource.sessionController;
+    if ([sessionController respondsToSelector:@selector(sessionRefreshTask)]) {
+        return [sessionController sessionRefreshTask];
+    }
+    return nil;
+}
+
+- (BFTask *)_replayRequestAsync:(nonnull AGRestRequest *)request
+    afterRefreshingSessionToken:(nonnull NSString *)expiredSessionToken
+                   originalTask:(nonnull BFTask *)originalTask
+              cancellationToken:(nullable BFCancellationToken *)cancellationToken
+{
+    // Concurrent failures join the same refresh, or replay right away if it already completed.
+    BFTask *sessionRefreshTask = [self.dataSource.sessionController refreshSessionAsyncWithExpiredSessionToken:expiredSessionToken];
+    weakify(self);
+    return [sessionRefreshTask continueWithBlock:^id(BFTask *task) {
+        strongify(weakSelf);
+        if (task.faulted || task.cancelled || !strongSelf) {
+            // Session couldn't be refreshed, return the 401 response.
+            return originalTask;
+        }
+        return [strongSelf _sendRequestAsync:request withCancellationToken:cancellationToken replay:YES];
+    } cancellationToken:cancellationToken];
+}
+
+- (nonnull AGRestResponse *)_responseForRequest:(nonnull AGRestRequest *)request failedSessionRefreshTask:(nonnull BFTask *)task {
+    NSError *error = (task.error)?:[AGRestErrorUtilities errorWithCode:kAGErrorInvalidSessionToken
+                                                               message:@"<AGRestRequestController> Session refresh cancelled."
+                                                             shouldLog:NO];
+    AGRestResponse *response = [AGRestResponse responseWithError:error];
+    response.request = request;
+    return response;
 }
 
 #pragma mark - Default Request Handling
@@ -166,11 +284,15 @@
 }
 
 - (void)_handleRequest:(AGRestRequest *)request succeedWithResponse:(AGRestResponse *)response {
-    // Deserialize response data from response if mapping enabled
+    // Deserialize response data from response if mapping enabled.
+    // Deferred until the caller reads `responseData` or the response status, the serializer may fail the response.
     if ([AGRest isObjectMappingEnabled] && [request isObjectMappingEnabled])
     {
         response.targetClass = request.targetClass;
-        response.responseData = [self.dataSource.responseSerializer objectResponseFromResponse:response];
+        id<AGRestResponseSerializerProtocol> responseSerializer = self.dataSource.responseSerializer;
+        [response _setResponseDataDecoder:^id(AGRestResponse *response) {
+            return [responseSerializer objectResponseFromResponse:response];
+        }];
     }
 }
 
@@ -0,0 +1,115 @@
+//
+//  AGRestCircuitBreaker.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 12/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class AGRestRequest;
+@class AGRestResponse;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @enum AGRestCircuitState
+ @discussion State of the circuit of an endpoint.
+ */
+typedef NS_ENUM(NSInteger, AGRestCircuitState) {
+    /*!
+     @abstract Requests are sent. Consecutive failures are counted.
+     */
+    AGRestCircuitStateClosed = 0,
+    /*!
+     @abstract Requests fail without being sent, until `openInterval` elapsed.
+     */
+    AGRestCircuitStateOpen,
+    /*!
+     @abstract Up to `halfOpenMaxRequests` trial requests are sent, the others fail without being sent.
+     */
+    AGRestCircuitStateHalfOpen
+};
+
+/*!
+ @class AGRestCircuitBreaker
+
+ @discussion Tracks the health of each endpoint of each host, so that the request runner stops sending requests to an
+ endpoint that keeps failing, and the operation slots and retries go to the healthy ones.
+
+ A circuit opens after `failureThreshold` consecutive failures less than `openInterval` apart: timeouts, connection
+ failures and 5xx responses.
+ Other responses, 4xx included, tell the server is up and count as successes. Offline and cancelled requests don't count.
+ Once `openInterval` elapsed, the circuit is half open and lets `halfOpenMaxRequests` trial requests through:
+ `successThreshold` successes close it, a failure opens it again.
+
+ Only unhealthy circuits are kept: a closed circuit is forgotten on success, or once its last failure is older than
+ `openInterval`.
+ */
+@interface AGRestCircuitBreaker : NSObject
+
+/*!
+ @abstract Whether requests go through the circuits. Disabled by default.
+ */
+@property (atomic, assign, getter=isEnabled) BOOL       enabled;
+
+/*!
+ @abstract Consecutive failures opening a circuit. 5 by default.
+ */
+@property (atomic, assign) NSUInteger                   failureThreshold;
+
+/*!
+ @abstract Time a circuit stays open before trial requests are sent, in seconds. 30 by default.
+ */
+@property (atomic, assign) NSTimeInterval               openInterval;
+
+/*!
+ @abstract Trial requests in flight at once while a circuit is half open. 1 by default.
+ */
+@property (atomic, assign) NSUInteger                   halfOpenMaxRequests;
+
+/*!
+ @abstract Successful trial requests closing a half open circuit. 1 by default.
+ */
+@property (atomic, assign) NSUInteger                   successThreshold;
+
+/*!
+ @return The circuit of the request: the host of its base url and its normalized endpoint, the one of the metrics.
+ */
++ (NSString *)circuitKeyForRequest:(AGRestRequest *)request;
+
+/*!
+ @abstract Whether a request may be sent through a circuit. Every allowed request must be recorded.
+ @param key     The circuit.
+ @param trial   Set to YES if the request is a trial of a half open circuit.
+ @return NO if the circuit is open, or half open with all its trial requests in flight.
+ */
+- (BOOL)allowRequestForKey:(NSString *)key trial:(BOOL *)trial;
+
+/*!
+ @abstract Record the outcome of a request allowed by `allowRequestForKey:trial:`.
+ @param response    The response, nil if the request was cancelled.
+ @param key         The circuit.
+ @param trial       Whether the request was a trial.
+ */
+- (void)recordResponse:(nullable AGRestResponse *)response forKey:(NSString *)key trial:(BOOL)trial;
+
+/*!
+ @return The state of a circuit. An open circuit whose `openInterval` elapsed is reported half open.
+ */
+- (AGRestCircuitState)stateForKey:(NSString *)key;
+
+/*!
+ @return The circuits which aren't closed, with their state as a NSNumber.
+ */
+- (NSDictionary<NSString *, NSNumber *> *)openCircuits;
+
+/*!
+ @abstract Close all the circuits.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
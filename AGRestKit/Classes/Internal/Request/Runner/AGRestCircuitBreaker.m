@@ -0,0 +1,275 @@
+//
+//  AGRestCircuitBreaker.m
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 12/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestCircuitBreaker.h"
+
+#import "AGRestConstants.h"
+#import "AGRestRequest.h"
+#import "AGRestRequest+Format.h"
+#import "AGRestResponse.h"
+#import "AGRestPipelineInstrumentation.h"
+#import "AGRestLogger.h"
+
+#define kDefaultFailureThreshold        5
+#define kDefaultOpenInterval            30.f
+#define kDefaultHalfOpenMaxRequests     1
+#define kDefaultSuccessThreshold        1
+
+typedef NS_ENUM(NSInteger, AGRestCircuitOutcome) {
+    AGRestCircuitOutcomeSuccess,
+    AGRestCircuitOutcomeFailure,
+    AGRestCircuitOutcomeIgnored
+};
+
+#pragma mark - AGRestCircuit
+#pragma mark -
+
+@interface AGRestCircuit : NSObject
+
+@property (nonatomic, assign) AGRestCircuitState    state;
+@property (nonatomic, assign) NSUInteger            failureCount;
+@property (nonatomic, assign) NSUInteger            successCount;
+@property (nonatomic, assign) NSUInteger            trialCount;
+@property (nonatomic, assign) NSTimeInterval        openTime;
+@property (nonatomic, assign) NSTimeInterval        lastFailureTime;
+
+@end
+
+@implementation AGRestCircuit
+@end
+
+#pragma mark - AGRestCircuitBreaker
+#pragma mark -
+
+@interface AGRestCircuitBreaker () {
+    // Unhealthy circuits only, guarded by @synchronized on itself.
+    NSMutableDictionary<NSString *, AGRestCircuit *> *_circuits;
+}
+
++ (AGRestCircuitOutcome)_outcomeForResponse:(nullable AGRestResponse *)response;
+
+// With the circuits locked.
+- (void)_updateStateOfCircuit:(AGRestCircuit *)circuit;
+- (BOOL)_isCircuitIdle:(AGRestCircuit *)circuit atTime:(NSTimeInterval)time;
+- (void)_removeIdleCircuitsAtTime:(NSTimeInterval)time;
+- (void)_openCircuit:(AGRestCircuit *)circuit forKey:(NSString *)key;
+- (void)_closeCircuitForKey:(NSString *)key;
+
+@end
+
+@implementation AGRestCircuitBreaker
+
+#pragma mark - Init
+#pragma mark -
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) return nil;
+
+    _circuits = [NSMutableDictionary dictionary];
+    _failureThreshold = kDefaultFailureThreshold;
+    _openInterval = kDefaultOpenInterval;
+    _halfOpenMaxRequests = kDefaultHalfOpenMaxRequests;
+    _successThreshold = kDefaultSuccessThreshold;
+
+    return self;
+}
+
++ (NSString *)circuitKeyForRequest:(AGRestRequest *)request {
+    NSString *host = (request.baseUrl.length) ? [NSURL URLWithString:request.baseUrl].host.lowercaseString : nil;
+    // Requests of the same resource share a circuit, whatever their identifiers
+    NSString *path = [AGRestRequest normalizedEndPoint:request.endPoint];
+    if ([path hasPrefix:@"/"]) {
+        path = [path substringFromIndex:1];
+    }
+    return [NSString stringWithFormat:@"%@/%@", host ?: @"", path];
+}
+
+#pragma mark - Circuits
+#pragma mark -
+
+- (BOOL)allowRequestForKey:(NSString *)key trial:(BOOL *)trial {
+    *trial = NO;
+    @synchronized (_circuits) {
+        AGRestCircuit *circuit = _circuits[key];
+        if (!circuit) {
+            return YES;
+        }
+        [self _updateStateOfCircuit:circuit];
+        switch (circuit.state) {
+            case AGRestCircuitStateClosed:
+                if ([self _isCircuitIdle:circuit atTime:AGRestPipelineCurrentTime()]) {
+                    [_circuits removeObjectForKey:key];
+                }
+                return YES;
+            case AGRestCircuitStateOpen:
+                return NO;
+            case AGRestCircuitStateHalfOpen:
+                if (circuit.trialCount >= MAX(self.halfOpenMaxRequests, 1)) {
+                    return NO;
+                }
+                circuit.trialCount++;
+                *trial = YES;
+                return YES;
+        }
+    }
+    return YES;
+}
+
+- (void)recordResponse:(nullable AGRestResponse *)response forKey:(NSString *)key trial:(BOOL)trial {
+    AGRestCircuitOutcome outcome = [[self class] _outcomeForResponse:response];
+    @synchronized (_circuits) {
+        AGRestCircuit *circuit = _circuits[key];
+        if (!circuit) {
+            if (outcome != AGRestCircuitOutcomeFailure) {
+                return;
+            }
+            // Endpoints failing once in a while would pile up otherwise
+            [self _removeIdleCircuitsAtTime:AGRestPipelineCurrentTime()];
+            circuit = [[AGRestCircuit alloc] init];
+            _circuits[key] = circuit;
+        }
+
+        if (trial) {
+            // A trial of a previous half open period may complete after the circuit opened again.
+            if (circuit.state != AGRestCircuitStateHalfOpen) {
+                return;
+            }
+            circuit.trialCount = (circuit.trialCount) ? circuit.trialCount - 1 : 0;
+            if (outcome == AGRestCircuitOutcomeFailure) {
+                [self _openCircuit:circuit forKey:key];
+            } else if (outcome == AGRestCircuitOutcomeSuccess && ++circuit.successCount >= MAX(self.successThreshold, 1)) {
+                [self _closeCircuitForKey:key];
+            }
+            return;
+        }
+
+        // Requests sent before the circuit opened don't change it anymore.
+        if (circuit.state != AGRestCircuitStateClosed) {
+            return;
+        }
+        if (outcome == AGRestCircuitOutcomeSuccess) {
+            [_circuits removeObjectForKey:key];
+        } else if (outcome == AGRestCircuitOutcomeFailure) {
+            NSTimeInterval now = AGRestPipelineCurrentTime();
+            // Failures too far apart don't add up
+            if ([self _isCircuitIdle:circuit atTime:now]) {
+                circuit.failureCount = 0;
+            }
+            circuit.lastFailureTime = now;
+            if (++circuit.failureCount >= MAX(self.failureThreshold, 1)) {
+                [self _openCircuit:circuit forKey:key];
+            }
+        }
+    }
+}
+
+- (AGRestCircuitState)stateForKey:(NSString *)key {
+    @synchronized (_circuits) {
+        AGRestCircuit *circuit = _circuits[key];
+        if (!circuit) {
+            return AGRestCircuitStateClosed;
+        }
+        [self _updateStateOfCircuit:circuit];
+        return circuit.state;
+    }
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)openCircuits {
+    NSMutableDictionary *openCircuits = [NSMutableDictionary dictionary];
+    @synchronized (_circuits) {
+        [_circuits enumerateKeysAndObjectsUsingBlock:^(NSString *key, AGRestCircuit *circuit, BOOL *stop) {
+            [self _updateStateOfCircuit:circuit];
+            if (circuit.state != AGRestCircuitStateClosed) {
+                openCircuits[key] = @(circuit.state);
+            }
+        }];
+    }
+    return openCircuits;
+}
+
+- (void)reset {
+    @synchronized (_circuits) {
+        [_circuits removeAllObjects];
+    }
+}
+
+#pragma mark - Private()
+#pragma mark -
+
++ (AGRestCircuitOutcome)_outcomeForResponse:(nullable AGRestResponse *)response {
+    if (!response) {
+        return AGRestCircuitOutcomeIgnored;
+    }
+    NSInteger statusCode = [response httpStatusCode];
+    if (statusCode >= 500) {
+        return AGRestCircuitOutcomeFailure;
+    }
+    NSError *error = response.responseError;
+    if (!error || statusCode > 0) {
+        return AGRestCircuitOutcomeSuccess;
+    }
+    if (![error.domain isEqualToString:NSURLErrorDomain]) {
+        return ([error.domain isEqualToString:AGRestErrorDomain] && error.code == kAGErrorCircuitOpen) ?
+            AGRestCircuitOutcomeIgnored : AGRestCircuitOutcomeSuccess;
+    }
+    switch (error.code) {
+        // The device, not the server, can't send the request.
+        case NSURLErrorCancelled:
+        case NSURLErrorNotConnectedToInternet:
+        case NSURLErrorInternationalRoamingOff:
+        case NSURLErrorCallIsActive:
+        case NSURLErrorDataNotAllowed:
+            return AGRestCircuitOutcomeIgnored;
+        default:
+            return AGRestCircuitOutcomeFailure;
+    }
+}
+
+- (void)_updateStateOfCircuit:(AGRestCircuit *)circuit {
+    if (circuit.state == AGRestCircuitStateOpen &&
+        AGRestPipelineCurrentTime() - circuit.openTime >= self.openInterval) {
+        circuit.state = AGRestCircuitStateHalfOpen;
+        circuit.trialCount = 0;
+        circuit.successCount = 0;
+    }
+}
+
+- (BOOL)_isCircuitIdle:(AGRestCircuit *)circuit atTime:(NSTimeInterval)time {
+    return (circuit.state == AGRestCircuitStateClosed && circuit.failureCount &&
+            time - circuit.lastFailureTime >= self.openInterval);
+}
+
+- (void)_removeIdleCircuitsAtTime:(NSTimeInterval)time {
+    NSMutableArray *idleKeys = nil;
+    for (NSString *key in _circuits) {
+        if ([self _isCircuitIdle:_circuits[key] atTime:time]) {
+            idleKeys = idleKeys ?: [NSMutableArray array];
+            [idleKeys addObject:key];
+        }
+    }
+    if (idleKeys) {
+        [_circuits removeObjectsForKeys:idleKeys];
+    }
+}
+
+- (void)_openCircuit:(AGRestCircuit *)circuit forKey:(NSString *)key {
+    AGRestLogWarn(@"<AGRestCircuitBreaker> Circuit %@ open for %.0f s after %lu failure(s).",
+                  key, self.openInterval, (unsigned long)MAX(circuit.failureCount, 1));
+    circuit.state = AGRestCircuitStateOpen;
+    circuit.openTime = AGRestPipelineCurrentTime();
+    circuit.trialCount = 0;
+    circuit.successCount = 0;
+}
+
+- (void)_closeCircuitForKey:(NSString *)key {
+    AGRestLogInfo(@"<AGRestCircuitBreaker> Circuit %@ closed.", key);
+    [_circuits removeObjectForKey:key];
+}
+
+@end
@@ -14,9 +14,14 @@
 #import "AGRestConstants.h"
 #import "AGRestResponse.h"
 #import "AGRestRequest.h"
+#import "AGRestRequest_Private.h"
+#import "AGRestRequestTrace_Private.h"
 #import "AGRestServer.h"
 #import "AGRestCore.h"
 #import "AGRestLogger.h"
+#import "AGRestMetricsCollecting.h"
+#import "AGRestCircuitBreaker.h"
+#import "AGRestErrorUtilities.h"
 
 #define kDefaultInitialRetryDelay   2.f
 
@@ -55,36 +60,70 @@
           cancellationToken:(BFCancellationToken *)token
 {
     // If same request already executing then return cancelled task
-    if ([[self.runningRequests allKeys] containsObject:request.requestIdentifier])
-        return [BFTask cancelledTask];
+    @synchronized (self.runningRequests) {
+        if (self.runningRequests[request.requestIdentifier]) {
+            return [BFTask cancelledTask];
+        }
+        // Register request as running request
+        [self.runningRequests setObject:request forKey:request.requestIdentifier];
+    }
+    
+    [request.trace endStage:AGRestRequestTraceStageEnqueue];
+    [request.trace beginStage:AGRestRequestTraceStageRunnerDispatch];
     
-    // Return a task that will executes on background
+    // Runs on the calling thread, already off the submitting one: the server does the next handoff.
+    // Each host may have its own server, so that a slow host doesn't hold the requests to the others.
+    id<AGRestServerProtocol> requestServer = [self.dataSource requestServerForBaseUrl:request.baseUrl];
+    id (^serverRequestBlock)() = ^{
+        return [requestServer runRequestAsync:request withOptions:options cancellationToken:token];
+    };
+    AGRestCircuitBreaker *circuitBreaker = self.dataSource.circuitBreaker;
+    if (circuitBreaker.enabled) {
+        serverRequestBlock = [self _requestBlock:serverRequestBlock throughCircuitBreaker:circuitBreaker forRequest:request];
+    }
     weakify(self)
-    return [BFTask taskFromExecutor:[BFExecutor defaultPriorityBackgroundExecutor] withBlock:^id{
+    
+    // Perform the request
+    return [[self _performRequestWithBlock:serverRequestBlock
+                               withOptions:(request.timeoutPolicy == kAGRestRequestTimeoutRetry)?AGRestRequestRunningOptionRetryIfFailed:-1
+                              withAttempts:request.retryCount
+                         cancellationToken:token] continueWithBlock:^id(BFTask *task) {
         strongify(weakSelf)
-        // Declare the server execution block
-        id (^serverRequestBlock)() = ^{
-            return [strongSelf.dataSource.requestServer runRequestAsync:request withOptions:options cancellationToken:token];
-        };
-        
-        // Register request as running request
-        [strongSelf.runningRequests setObject:request forKey:request.requestIdentifier];
-        
-        // Perform the request
-        return [[strongSelf _performRequestWithBlock:serverRequestBlock
-                                         withOptions:(request.timeoutPolicy == kAGRestRequestTimeoutRetry)?AGRestRequestRunningOptionRetryIfFailed:-1
-                                        withAttempts:request.retryCount
-                                   cancellationToken:token] continueWithBlock:^id(BFTask *task) {
-            strongify(weakSelf)
-            // Remove request from running requests
+        // Remove request from running requests
+        @synchronized (strongSelf.runningRequests) {
             [strongSelf.runningRequests removeObjectForKey:request.requestIdentifier];
-            return task;
-        }];
+        }
+        return task;
     }];
 }
 
 #pragma mark - Private
 
+// Each attempt goes through the circuit, so that once it opens the pending retries fail without taking an operation slot.
+- (id (^)())_requestBlock:(nonnull id (^)())block
+    throughCircuitBreaker:(AGRestCircuitBreaker *)circuitBreaker
+               forRequest:(AGRestRequest *)request
+{
+    NSString *circuitKey = [AGRestCircuitBreaker circuitKeyForRequest:request];
+    weakify(self)
+    return ^id{
+        strongify(weakSelf)
+        BOOL trial = NO;
+        if (![circuitBreaker allowRequestForKey:circuitKey trial:&trial]) {
+            [strongSelf.dataSource.metrics recordCircuitBreakerRejection];
+            [request.trace endStage:AGRestRequestTraceStageRunnerDispatch];
+            NSError *error = [AGRestErrorUtilities errorWithCode:kAGErrorCircuitOpen
+                                                         message:[NSString stringWithFormat:@"Circuit %@ is open.", circuitKey]
+                                                       shouldLog:NO];
+            return [BFTask taskWithResult:[AGRestResponse responseWithError:error]];
+        }
+        return [block() continueWithBlock:^id(BFTask *task) {
+            [circuitBreaker recordResponse:(task.cancelled) ? nil : task.result forKey:circuitKey trial:trial];
+            return task;
+        }];
+    };
+}
+
 - (BFTask *)_performRequestWithBlock:(nonnull id (^)())block
                          withOptions:(AGRestRequestRunningOptions)options
                         withAttempts:(NSUInteger)attemps
@@ -126,6 +165,7 @@
         
         AGRestResponse * response = task.result;
         if (response.responseError && response.responseError.code == NSURLErrorTimedOut && attempts > 1) {
+            [strongSelf.dataSource.metrics recordRetry];
             return [[BFTask taskWithDelay:(int)(delay * 1000)] continueWithBlock:^id(BFTask *task) {
                 return [strongSelf _performRequestRunningBlock:block
                                          withCancellationToken:cancellationToken
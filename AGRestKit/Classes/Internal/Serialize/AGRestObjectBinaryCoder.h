@@ -0,0 +1,61 @@
+//
+//  AGRestObjectBinaryCoder.h
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 06/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@protocol AGRestObjectMapping;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class AGRestObjectBinaryCoder
+
+ @discussion Encodes instances of AGRestObjectMapping classes to a compact binary form, and back.
+
+ The layout is derived once per class from its writable properties: the values are written in property order with a
+ one byte type tag, strings, numbers, dates and data natively, other NSCoding values keyed-archived.
+ The property names are written once in the header with a fingerprint of the layout, so that data written before the
+ class changed is still decoded by name, skipping the properties which no longer exist.
+
+ Classes conforming to NSCoding decide what they archive in `encodeWithCoder:`, they are refused and must be keyed
+ archived instead. Properties listed in `excludedPropertyKeys` are never written.
+ */
+@interface AGRestObjectBinaryCoder : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Returns YES if the data has been written by AGRestObjectBinaryCoder.
+ @param data    The data to check.
+ @return YES if the data can be decoded with `objectOfClass:withData:error:`.
+ */
++ (BOOL)isBinaryData:(nullable NSData *)data;
+
+/*!
+ @abstract Encodes an object.
+ @param object  The object to encode, its class must conform to AGRestObjectMapping and not to NSCoding.
+ @param error   The error, if the class or one of the values isn't supported.
+ @return The encoded object, nil with error otherwise.
+ */
++ (nullable NSData *)dataWithObject:(id<AGRestObjectMapping>)object
+                              error:(NSError * _Nullable __autoreleasing * _Nullable)error;
+
+/*!
+ @abstract Decodes an object encoded with `dataWithObject:error:`.
+ @param aClass  The class of the object, or a superclass of it.
+ @param data    The encoded object.
+ @param error   The error, if the data is malformed.
+ @return A new instance of `aClass`, nil with error otherwise.
+ */
++ (nullable id)objectOfClass:(Class)aClass
+                    withData:(NSData *)data
+                       error:(NSError * _Nullable __autoreleasing * _Nullable)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,506 @@
+//
+//  AGRestObjectBinaryCoder.m
+//  AGRestStack
+//
+//  Created by Adrien Greiner on 06/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestObjectBinaryCoder.h"
+
+#import <objc/runtime.h>
+#import <pthread.h>
+
+#import "AGRestObjectMapping.h"
+#import "AGRestErrorUtilities.h"
+#import "AGRestLogger.h"
+
+// Layout : magic | version | fingerprint | class name | field count | field names | tagged values, in field order.
+static const uint8_t _AGRestObjectBinaryMagic[4] = {'A', 'G', 'O', 'B'};
+static const uint8_t _AGRestObjectBinaryVersion = 1;
+
+typedef NS_ENUM(uint8_t, AGRestObjectBinaryTag) {
+    AGRestObjectBinaryTagNil = 0,
+    AGRestObjectBinaryTagString,
+    AGRestObjectBinaryTagInteger,
+    AGRestObjectBinaryTagDouble,
+    AGRestObjectBinaryTagBool,
+    AGRestObjectBinaryTagDate,
+    AGRestObjectBinaryTagData,
+    AGRestObjectBinaryTagArchive
+};
+
+typedef NS_ENUM(uint8_t, AGRestObjectBinaryFieldKind) {
+    AGRestObjectBinaryFieldKindObject,
+    AGRestObjectBinaryFieldKindNumber
+};
+
+#pragma mark - Buffer
+#pragma mark -
+
+typedef struct {
+    const uint8_t   *bytes;
+    NSUInteger      length;
+    NSUInteger      offset;
+    BOOL            failed;
+} AGRestObjectBinaryReader;
+
+static void _AGRestObjectBinaryWriteVarint(NSMutableData *data, uint64_t value) {
+    uint8_t buffer[10];
+    NSUInteger length = 0;
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        buffer[length++] = (value) ? (byte | 0x80) : byte;
+    } while (value);
+    [data appendBytes:buffer length:length];
+}
+
+static void _AGRestObjectBinaryWriteBytes(NSMutableData *data, const void *bytes, NSUInteger length) {
+    _AGRestObjectBinaryWriteVarint(data, length);
+    [data appendBytes:bytes length:length];
+}
+
+static void _AGRestObjectBinaryWriteString(NSMutableData *data, NSString *string) {
+    const char *UTF8String = string.UTF8String;
+    _AGRestObjectBinaryWriteBytes(data, UTF8String, strlen(UTF8String));
+}
+
+static void _AGRestObjectBinaryWriteDouble(NSMutableData *data, double value) {
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    bits = CFSwapInt64HostToLittle(bits);
+    [data appendBytes:&bits length:sizeof(bits)];
+}
+
+static uint64_t _AGRestObjectBinaryReadVarint(AGRestObjectBinaryReader *reader) {
+    uint64_t value = 0;
+    for (NSUInteger shift = 0; shift < 64; shift += 7) {
+        if (reader->offset >= reader->length) {
+            break;
+        }
+        uint8_t byte = reader->bytes[reader->offset++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    reader->failed = YES;
+    return 0;
+}
+
+static const uint8_t *_AGRestObjectBinaryReadBytes(AGRestObjectBinaryReader *reader, NSUInteger *length) {
+    uint64_t bytesLength = _AGRestObjectBinaryReadVarint(reader);
+    if (reader->failed || bytesLength > reader->length - reader->offset) {
+        reader->failed = YES;
+        return NULL;
+    }
+    const uint8_t *bytes = reader->bytes + reader->offset;
+    reader->offset += (NSUInteger)bytesLength;
+    *length = (NSUInteger)bytesLength;
+    return bytes;
+}
+
+static NSString *_AGRestObjectBinaryReadString(AGRestObjectBinaryReader *reader) {
+    NSUInteger length = 0;
+    const uint8_t *bytes = _AGRestObjectBinaryReadBytes(reader, &length);
+    if (!bytes) {
+        return nil;
+    }
+    return [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+}
+
+static double _AGRestObjectBinaryReadDouble(AGRestObjectBinaryReader *reader) {
+    uint64_t bits = 0;
+    if (reader->length - reader->offset < sizeof(bits)) {
+        reader->failed = YES;
+        return 0;
+    }
+    memcpy(&bits, reader->bytes + reader->offset, sizeof(bits));
+    reader->offset += sizeof(bits);
+    bits = CFSwapInt64LittleToHost(bits);
+    double value = 0;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+#pragma mark - AGRestObjectBinarySchema
+#pragma mark -
+
+/*!
+ @abstract Writable properties of a class, in a stable order, with the fingerprint of that layout.
+ */
+@interface AGRestObjectBinarySchema : NSObject
+
+@property (nonatomic, copy, readonly) NSArray<NSString *>   *keys;
+@property (nonatomic, copy, readonly) NSArray               *classes;   // Class, or NSNull if any object.
+@property (nonatomic, assign, readonly) const AGRestObjectBinaryFieldKind *kinds;
+@property (nonatomic, assign, readonly) uint32_t            fingerprint;
+
++ (instancetype)schemaForClass:(Class)aClass;
+
+@end
+
+@implementation AGRestObjectBinarySchema {
+    AGRestObjectBinaryFieldKind *_kinds;
+}
+
++ (instancetype)schemaForClass:(Class)aClass {
+    static NSMapTable       *schemas = nil;
+    static pthread_mutex_t  schemasMutex = PTHREAD_MUTEX_INITIALIZER;
+
+    pthread_mutex_lock(&schemasMutex);
+    if (!schemas) {
+        schemas = [NSMapTable strongToStrongObjectsMapTable];
+    }
+    AGRestObjectBinarySchema *schema = [schemas objectForKey:aClass];
+    if (!schema) {
+        schema = [[AGRestObjectBinarySchema alloc] _initWithClass:aClass];
+        [schemas setObject:schema forKey:aClass];
+    }
+    pthread_mutex_unlock(&schemasMutex);
+    return schema;
+}
+
+- (instancetype)_initWithClass:(Class)aClass {
+    self = [super init];
+    if (!self) return nil;
+
+    NSMutableSet *excludedKeys = [NSMutableSet setWithArray:@[@"hash", @"debugDescription", @"description", @"superclass"]];
+    if ([aClass instancesRespondToSelector:@selector(excludedPropertyKeys)]) {
+        id<AGRestObjectMapping> anInstance = [aClass respondsToSelector:@selector(newInstance)] ? [aClass newInstance] : [[aClass alloc] init];
+        [excludedKeys addObjectsFromArray:[anInstance excludedPropertyKeys]];
+    }
+
+    // Collect the properties of the class and its superclasses, keeping the type encoding of each
+    NSMutableDictionary<NSString *, NSString *> *types = [NSMutableDictionary dictionary];
+    for (Class currentClass = aClass; currentClass && currentClass != [NSObject class]; currentClass = class_getSuperclass(currentClass)) {
+        unsigned int propertyCount = 0;
+        objc_property_t *properties = class_copyPropertyList(currentClass, &propertyCount);
+        for (unsigned int i = 0; i < propertyCount; i++) {
+            NSString *key = [NSString stringWithUTF8String:property_getName(properties[i])];
+            if (types[key] || [excludedKeys containsObject:key]) {
+                continue;
+            }
+            char *readOnly = property_copyAttributeValue(properties[i], "R");
+            char *type = property_copyAttributeValue(properties[i], "T");
+            if (!readOnly && type) {
+                types[key] = [NSString stringWithUTF8String:type];
+            }
+            free(readOnly);
+            free(type);
+        }
+        free(properties);
+    }
+
+    NSMutableArray *keys = [NSMutableArray arrayWithCapacity:types.count];
+    NSMutableArray *classes = [NSMutableArray arrayWithCapacity:types.count];
+    _kinds = calloc(MAX(types.count, 1), sizeof(AGRestObjectBinaryFieldKind));
+
+    // FNV-1a of the class name and the fields, the same layout always has the same fingerprint
+    __block uint32_t fingerprint = 2166136261u;
+    void (^hashString)(NSString *) = ^(NSString *string) {
+        for (const char *c = string.UTF8String; *c; c++) {
+            fingerprint = (fingerprint ^ (uint8_t)*c) * 16777619u;
+        }
+    };
+    hashString(NSStringFromClass(aClass));
+
+    for (NSString *key in [[types allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        NSString *type = types[key];
+        unichar typeCode = [type characterAtIndex:0];
+        Class valueClass = Nil;
+        AGRestObjectBinaryFieldKind kind;
+
+        if (typeCode == '@') {
+            // Blocks can't be stored
+            if ([type isEqualToString:@"@?"]) {
+                continue;
+            }
+            if (type.length > 3) {
+                valueClass = NSClassFromString([type substringWithRange:NSMakeRange(2, type.length - 3)]);
+            }
+            kind = AGRestObjectBinaryFieldKindObject;
+        } else if (strchr("cCsSiIlLqQBfd", typeCode)) {
+            kind = AGRestObjectBinaryFieldKindNumber;
+        } else {
+            // Structures, pointers and selectors aren't supported by KVC or mapping
+            continue;
+        }
+
+        _kinds[keys.count] = kind;
+        [keys addObject:key];
+        [classes addObject:(valueClass) ?: [NSNull null]];
+        hashString(key);
+        hashString(type);
+    }
+
+    _keys = [keys copy];
+    _classes = [classes copy];
+    _fingerprint = fingerprint;
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_kinds);
+}
+
+- (const AGRestObjectBinaryFieldKind *)kinds {
+    return _kinds;
+}
+
+@end
+
+#pragma mark - AGRestObjectBinaryCoder
+#pragma mark -
+
+@implementation AGRestObjectBinaryCoder
+
++ (BOOL)isBinaryData:(nullable NSData *)data {
+    return (data.length > sizeof(_AGRestObjectBinaryMagic) &&
+            memcmp(data.bytes, _AGRestObjectBinaryMagic, sizeof(_AGRestObjectBinaryMagic)) == 0);
+}
+
++ (nullable NSData *)dataWithObject:(id<AGRestObjectMapping>)object
+                              error:(NSError * _Nullable __autoreleasing * _Nullable)error
+{
+    Class objectClass = [object class];
+    if (![objectClass conformsToProtocol:@protocol(AGRestObjectMapping)]) {
+        if (error) {
+            *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal
+                                                 message:[NSString stringWithFormat:@"<BinaryCoder> Class %@ not conforming to AGRestObjectMapping.", objectClass]];
+        }
+        return nil;
+    }
+    // Its properties may hold what `encodeWithCoder:` leaves out on purpose
+    if ([objectClass conformsToProtocol:@protocol(NSCoding)]) {
+        if (error) {
+            *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal
+                                                 message:[NSString stringWithFormat:@"<BinaryCoder> Class %@ conforming to NSCoding, archive it instead.", objectClass]
+                                               shouldLog:NO];
+        }
+        return nil;
+    }
+
+    AGRestObjectBinarySchema *schema = [AGRestObjectBinarySchema schemaForClass:objectClass];
+    NSArray<NSString *> *keys = schema.keys;
+
+    NSMutableData *data = [NSMutableData dataWithCapacity:64 + keys.count * 24];
+    [data appendBytes:_AGRestObjectBinaryMagic length:sizeof(_AGRestObjectBinaryMagic)];
+    [data appendBytes:&_AGRestObjectBinaryVersion length:sizeof(_AGRestObjectBinaryVersion)];
+    uint32_t fingerprint = CFSwapInt32HostToLittle(schema.fingerprint);
+    [data appendBytes:&fingerprint length:sizeof(fingerprint)];
+    _AGRestObjectBinaryWriteString(data, NSStringFromClass(objectClass));
+    _AGRestObjectBinaryWriteVarint(data, keys.count);
+    for (NSString *key in keys) {
+        _AGRestObjectBinaryWriteString(data, key);
+    }
+
+    for (NSString *key in keys) {
+        id value = [(NSObject *)object valueForKey:key];
+        if (![self _writeValue:value toData:data]) {
+            if (error) {
+                *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal
+                                                     message:[NSString stringWithFormat:@"<BinaryCoder> Value of %@.%@ can't be encoded.", objectClass, key]];
+            }
+            return nil;
+        }
+    }
+    return data;
+}
+
++ (nullable id)objectOfClass:(Class)aClass
+                    withData:(NSData *)data
+                       error:(NSError * _Nullable __autoreleasing * _Nullable)error
+{
+    AGRestObjectBinaryReader reader = {data.bytes, data.length, 0, NO};
+
+    if (![self isBinaryData:data] || data.length < sizeof(_AGRestObjectBinaryMagic) + sizeof(uint8_t) + sizeof(uint32_t) ||
+        ((const uint8_t *)data.bytes)[sizeof(_AGRestObjectBinaryMagic)] != _AGRestObjectBinaryVersion) {
+        return [self _failWithMessage:@"<BinaryCoder> Unknown data format." error:error];
+    }
+    reader.offset = sizeof(_AGRestObjectBinaryMagic) + sizeof(uint8_t);
+    uint32_t fingerprint = 0;
+    memcpy(&fingerprint, reader.bytes + reader.offset, sizeof(fingerprint));
+    fingerprint = CFSwapInt32LittleToHost(fingerprint);
+    reader.offset += sizeof(fingerprint);
+
+    // Instantiate the encoded class if it's still a kind of the expected one
+    NSString *className = _AGRestObjectBinaryReadString(&reader);
+    Class objectClass = NSClassFromString(className);
+    if (!objectClass || ![objectClass isSubclassOfClass:aClass]) {
+        objectClass = aClass;
+    }
+    AGRestObjectBinarySchema *schema = [AGRestObjectBinarySchema schemaForClass:objectClass];
+
+    // Same layout, fields are in schema order and their names can be skipped
+    uint64_t fieldCount = _AGRestObjectBinaryReadVarint(&reader);
+    BOOL sameLayout = (fingerprint == schema.fingerprint && fieldCount == schema.keys.count);
+    if (reader.failed || fieldCount > reader.length - reader.offset) {
+        return [self _failWithMessage:@"<BinaryCoder> Malformed data." error:error];
+    }
+    NSInteger *fieldIndexes = calloc(MAX((NSUInteger)fieldCount, 1), sizeof(NSInteger));
+    for (NSUInteger i = 0; i < fieldCount && !reader.failed; i++) {
+        if (sameLayout) {
+            NSUInteger length = 0;
+            _AGRestObjectBinaryReadBytes(&reader, &length);
+            fieldIndexes[i] = i;
+        } else {
+            NSUInteger index = [schema.keys indexOfObject:_AGRestObjectBinaryReadString(&reader) ?: @""];
+            fieldIndexes[i] = (index == NSNotFound) ? -1 : (NSInteger)index;
+        }
+    }
+
+    NSObject<AGRestObjectMapping> *object = [objectClass respondsToSelector:@selector(newInstance)] ? [objectClass newInstance] : [[objectClass alloc] init];
+    for (NSUInteger i = 0; i < fieldCount && !reader.failed && object; i++) {
+        id value = [self _readValueFromReader:&reader];
+        NSInteger index = fieldIndexes[i];
+        if (index < 0 || !value || reader.failed) {
+            continue;
+        }
+
+        // Skip values whose type no longer matches the property
+        id valueClass = schema.classes[index];
+        if (schema.kinds[index] == AGRestObjectBinaryFieldKindNumber) {
+            if (![value isKindOfClass:[NSNumber class]]) {
+                continue;
+            }
+        } else if (valueClass != [NSNull null] && ![value isKindOfClass:valueClass]) {
+            continue;
+        }
+        [object setValue:value forKey:schema.keys[index]];
+    }
+    free(fieldIndexes);
+
+    if (reader.failed || !object) {
+        return [self _failWithMessage:@"<BinaryCoder> Malformed data." error:error];
+    }
+    return object;
+}
+
+#pragma mark - Private
+#pragma mark -
+
++ (BOOL)_writeValue:(nullable id)value toData:(NSMutableData *)data {
+    AGRestObjectBinaryTag tag = AGRestObjectBinaryTagNil;
+    if (!value || value == [NSNull null]) {
+        [data appendBytes:&tag length:sizeof(tag)];
+    }
+    else if ([value isKindOfClass:[NSString class]]) {
+        tag = AGRestObjectBinaryTagString;
+        [data appendBytes:&tag length:sizeof(tag)];
+        _AGRestObjectBinaryWriteString(data, value);
+    }
+    else if ([value isKindOfClass:[NSNumber class]]) {
+        CFNumberRef number = (__bridge CFNumberRef)value;
+        if (CFGetTypeID(number) == CFBooleanGetTypeID()) {
+            tag = AGRestObjectBinaryTagBool;
+            uint8_t boolValue = [value boolValue];
+            [data appendBytes:&tag length:sizeof(tag)];
+            [data appendBytes:&boolValue length:sizeof(boolValue)];
+        } else if (CFNumberIsFloatType(number)) {
+            tag = AGRestObjectBinaryTagDouble;
+            [data appendBytes:&tag length:sizeof(tag)];
+            _AGRestObjectBinaryWriteDouble(data, [value doubleValue]);
+        } else {
+            // Zigzag, small negative values stay small
+            int64_t integerValue = [value longLongValue];
+            tag = AGRestObjectBinaryTagInteger;
+            [data appendBytes:&tag length:sizeof(tag)];
+            _AGRestObjectBinaryWriteVarint(data, ((uint64_t)integerValue << 1) ^ (uint64_t)(integerValue >> 63));
+        }
+    }
+    else if ([value isKindOfClass:[NSDate class]]) {
+        tag = AGRestObjectBinaryTagDate;
+        [data appendBytes:&tag length:sizeof(tag)];
+        _AGRestObjectBinaryWriteDouble(data, [value timeIntervalSince1970]);
+    }
+    else if ([value isKindOfClass:[NSData class]]) {
+        tag = AGRestObjectBinaryTagData;
+        [data appendBytes:&tag length:sizeof(tag)];
+        _AGRestObjectBinaryWriteBytes(data, [value bytes], [value length]);
+    }
+    else if ([value conformsToProtocol:@protocol(NSCoding)]) {
+        NSData *archive = nil;
+        @try {
+            archive = [NSKeyedArchiver archivedDataWithRootObject:value];
+        }
+        @catch (NSException *exception) {
+            AGRestLogError(@"<BinaryCoder> Failed to archive %@ : %@", [value class], exception.reason);
+        }
+        if (!archive) {
+            return NO;
+        }
+        tag = AGRestObjectBinaryTagArchive;
+        [data appendBytes:&tag length:sizeof(tag)];
+        _AGRestObjectBinaryWriteBytes(data, archive.bytes, archive.length);
+    }
+    else {
+        return NO;
+    }
+    return YES;
+}
+
++ (nullable id)_readValueFromReader:(AGRestObjectBinaryReader *)reader {
+    if (reader->offset >= reader->length) {
+        reader->failed = YES;
+        return nil;
+    }
+    AGRestObjectBinaryTag tag = reader->bytes[reader->offset++];
+    switch (tag) {
+        case AGRestObjectBinaryTagNil:
+            return nil;
+        case AGRestObjectBinaryTagString:
+            return _AGRestObjectBinaryReadString(reader);
+        case AGRestObjectBinaryTagInteger: {
+            uint64_t zigzag = _AGRestObjectBinaryReadVarint(reader);
+            return @((int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1));
+        }
+        case AGRestObjectBinaryTagDouble:
+            return @(_AGRestObjectBinaryReadDouble(reader));
+        case AGRestObjectBinaryTagBool: {
+            if (reader->offset >= reader->length) {
+                reader->failed = YES;
+                return nil;
+            }
+            return @((BOOL)(reader->bytes[reader->offset++] != 0));
+        }
+        case AGRestObjectBinaryTagDate: {
+            double timeInterval = _AGRestObjectBinaryReadDouble(reader);
+            return (reader->failed) ? nil : [NSDate dateWithTimeIntervalSince1970:timeInterval];
+        }
+        case AGRestObjectBinaryTagData: {
+            NSUInteger length = 0;
+            const uint8_t *bytes = _AGRestObjectBinaryReadBytes(reader, &length);
+            return (bytes) ? [NSData dataWithBytes:bytes length:length] : nil;
+        }
+        case AGRestObjectBinaryTagArchive: {
+            NSUInteger length = 0;
+            const uint8_t *bytes = _AGRestObjectBinaryReadBytes(reader, &length);
+            if (!bytes) {
+                return nil;
+            }
+            @try {
+                return [NSKeyedUnarchiver unarchiveObjectWithData:[NSData dataWithBytesNoCopy:(void *)bytes length:length freeWhenDone:NO]];
+            }
+            @catch (NSException *exception) {
+                AGRestLogError(@"<BinaryCoder> Failed to unarchive value : %@", exception.reason);
+                return nil;
+            }
+        }
+        default:
+            // Unknown tag, the size of the value is unknown too
+            reader->failed = YES;
+            return nil;
+    }
+}
+
++ (nullable id)_failWithMessage:(NSString *)message error:(NSError * _Nullable __autoreleasing * _Nullable)error {
+    if (error) {
+        *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal message:message shouldLog:NO];
+    }
+    return nil;
+}
+
+@end
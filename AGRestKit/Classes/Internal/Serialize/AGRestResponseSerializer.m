@@ -9,6 +9,7 @@
 #import "AGRestResponseSerializer.h"
 
 #import "AGRestResponse.h"
+#import "AGRestRequestTrace_Private.h"
 #import "AGRestObjectMapper.h"
 #import "AGRestErrorUtilities.h"
 #import "AGRestLogger.h"
@@ -39,12 +40,20 @@
 #pragma mark -
 
 - (id)objectResponseFromResponse:(AGRestResponse *)response {
+    AGRestRequestTrace *trace = response.trace;
+    [trace beginStage:AGRestRequestTraceStageMapping];
+    
+    id object = nil;
     // If custom response serialize block is defined then use it instead.
     if (self.objectFromResponseSerializeBlock) {
-        return self.objectFromResponseSerializeBlock(response);
+        object = self.objectFromResponseSerializeBlock(response);
+    } else {
+        // or use the built-in parseResponse
+        object = [self _parseResponse:response];
     }
-    // or use the built-in parseResponse
-    return [self _parseResponse:response];
+    
+    [trace endStage:AGRestRequestTraceStageMapping];
+    return object;
 }
 
 - (NSError *)errorResponseFromResponse:(nonnull AGRestResponse *)response {
@@ -62,22 +71,28 @@
 - (id)_parseResponse:(AGRestResponse *)response {
     id result = nil;
     @autoreleasepool {
+        // Decode the raw JSON body kept by the response
+        id responseData = response.responseData;
+        if ([responseData isKindOfClass:[NSData class]] && [(NSData *)responseData length]) {
+            responseData = [NSJSONSerialization JSONObjectWithData:responseData options:0 error:nil] ?: responseData;
+        }
+        
         // If data and no error
-        if (response.responseData && !response.responseError)
+        if (responseData && !response.responseError)
         {
-            if ([response.responseData isKindOfClass:[NSDictionary class]]) {
+            if ([responseData isKindOfClass:[NSDictionary class]]) {
                 NSError *error = nil;
-                if (!(result = [self _objectFromResponse:response error:&error])) {
+                if (!(result = [self _objectFromData:responseData response:response error:&error])) {
                     response.responseError = error;
                 }
             } else {
-                AGRestLogWarn(@"<ResponseSerializer> Response data is not processed : %@", response.responseData);
+                AGRestLogWarn(@"<ResponseSerializer> Response data is not processed : %@", responseData);
             }
         }
         // If data and error
-        else if (response.responseData && response.responseError)
+        else if (responseData && response.responseError)
         {
-            if ([response.responseData isKindOfClass:[NSDictionary class]]) {
+            if ([responseData isKindOfClass:[NSDictionary class]]) {
                 result = [self _errorFromResponse:response];
             } else {
                 result = response.responseError;
@@ -91,15 +106,12 @@
     return result;
 }
 
-- (id)_objectFromResponse:(AGRestResponse *)response error:(NSError * __autoreleasing *)error {
-    if (response.responseData && response.responseHeader)
+- (id)_objectFromData:(NSDictionary *)data response:(AGRestResponse *)response error:(NSError * __autoreleasing *)error {
+    if (data && response.responseHeader)
     {
         // The object to return
         id object = nil;
         
-        // Get the dictionary from the response data
-        NSDictionary    *data = [response responseData];
-        
         Class targetClass = nil;
         if (response.targetClass)
         {
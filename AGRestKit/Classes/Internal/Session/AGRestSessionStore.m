@@ -15,7 +15,14 @@
 
 #define kAGRestSessionStoreTokenUnion @"||"
 
-@interface AGRestSessionStore()
+@interface AGRestSessionStore() {
+    // Write-through copies of the keychain items, guarded by self.
+    // Keychain reads are IPC round-trips, and the session token is read on every request.
+    BOOL                                    _sessionTokenLoaded;
+    NSString                                *_cachedSessionToken;
+    NSString                                *_cachedSessionIdentifier;
+    NSMutableDictionary<NSString *, id>     *_cachedData;
+}
 
 @property (strong) VALValet                 *valet;
 
@@ -38,12 +45,32 @@
             self.valet = [[VALValet alloc] initWithIdentifier:@"TheSocialSuperstore"
                                                 accessibility:VALAccessibilityAfterFirstUnlock];
         }
+        _cachedData = [NSMutableDictionary dictionary];
     }
     return self;
 }
 
 - (nullable NSString *)sessionTokenWithIdentifier:(NSString * _Nullable __autoreleasing * _Nullable)identifier {
-    return [self _extractSessionTokenWithIdentifier:identifier];
+    @synchronized(self) {
+        if (!_sessionTokenLoaded) {
+            NSString *sessionIdentifier = nil;
+            NSString *sessionToken = [self _extractSessionTokenWithIdentifier:&sessionIdentifier];
+            // A miss is only final if the keychain could be read, it is locked until the first unlock.
+            if (sessionToken || [self.valet canAccessKeychain]) {
+                _cachedSessionToken = sessionToken;
+                _cachedSessionIdentifier = sessionIdentifier;
+                _sessionTokenLoaded = YES;
+            }
+            if (identifier) {
+                *identifier = sessionIdentifier;
+            }
+            return sessionToken;
+        }
+        if (identifier) {
+            *identifier = _cachedSessionIdentifier;
+        }
+        return _cachedSessionToken;
+    }
 }
 
 - (BOOL)storeSessionToken:(nonnull NSString *)token
@@ -59,7 +86,16 @@
             
             // Use valet to store the session token
             BOOL isValueStored = [self.valet setString:tokenString forKey:AGRestSessionStoreSessionTokenKey];
-                        
+            
+            // Keep the cache in line with the keychain, reload it if the keychain state is unknown
+            if (isValueStored) {
+                _cachedSessionToken = [token copy];
+                _cachedSessionIdentifier = [identifier copy];
+                _sessionTokenLoaded = YES;
+            } else {
+                [self _invalidateSessionTokenCache];
+            }
+            
             // Check if the operation succeed
             if (!isValueStored && error) {
                 *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal message:@"<SessionStore> Valet failed to store the session token string !\
@@ -87,7 +123,15 @@
     if (data && data.length &&
         identifier && identifier.length
         && self.valet) {
-        return [self.valet setObject:data forKey:identifier];
+        @synchronized(self) {
+            BOOL isValueStored = [self.valet setObject:data forKey:identifier];
+            if (isValueStored) {
+                _cachedData[identifier] = [data copy];
+            } else {
+                [_cachedData removeObjectForKey:identifier];
+            }
+            return isValueStored;
+        }
     } else if (error) {
         if (!data || !data.length) {
             *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal message:@"<SessionStore> Data is nil or empty"];
@@ -107,7 +151,18 @@
 
 - (nullable NSData *)dataForIdentifier:(nonnull NSString *)identifier {
     if (identifier && identifier.length) {
-        return [self.valet objectForKey:identifier];
+        @synchronized(self) {
+            id data = _cachedData[identifier];
+            if (!data) {
+                data = [self.valet objectForKey:identifier];
+                if (data) {
+                    _cachedData[identifier] = data;
+                } else if ([self.valet canAccessKeychain]) {
+                    _cachedData[identifier] = [NSNull null];
+                }
+            }
+            return (data == [NSNull null]) ? nil : data;
+        }
     }
     return nil;
 }
@@ -116,23 +171,29 @@
     
     BOOL isValueDeleted = NO;
     
-    // Extract and get current session token
-    NSString *sessionIdentifier = nil;
-    NSString *currentSessionToken = [self _extractSessionTokenWithIdentifier:&sessionIdentifier];
-    
-    if (sessionIdentifier && currentSessionToken &&
-        sessionIdentifier.length && currentSessionToken.length) {
-        
-        // Remove current token from Valet
-        isValueDeleted = [self.valet removeObjectForKey:AGRestSessionStoreSessionTokenKey];
-        // Remove current user data
-        isValueDeleted = [self.valet removeObjectForKey:sessionIdentifier];
+    @synchronized(self) {
+        // Extract and get current session token
+        NSString *sessionIdentifier = nil;
+        NSString *currentSessionToken = [self sessionTokenWithIdentifier:&sessionIdentifier];
         
-        if (!isValueDeleted && error) {
-            *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal
-                                                 message:@"Valet failed to delete the session token string / data !\
-                      Keychain may not be available!"];
+        if (sessionIdentifier && currentSessionToken &&
+            sessionIdentifier.length && currentSessionToken.length) {
+            
+            // Remove current token from Valet
+            isValueDeleted = [self.valet removeObjectForKey:AGRestSessionStoreSessionTokenKey];
+            // Remove current user data
+            isValueDeleted = [self.valet removeObjectForKey:sessionIdentifier];
+            
+            if (!isValueDeleted && error) {
+                *error = [AGRestErrorUtilities errorWithCode:kAGErrorInternalLocal
+                                                     message:@"Valet failed to delete the session token string / data !\
+                          Keychain may not be available!"];
+            }
         }
+        
+        // Read the keychain again on next access, whatever the outcome of the removal
+        [self _invalidateSessionTokenCache];
+        [_cachedData removeAllObjects];
     }
     return isValueDeleted;
 }
@@ -158,6 +219,12 @@
     return nil;
 }
 
+- (void)_invalidateSessionTokenCache {
+    _sessionTokenLoaded = NO;
+    _cachedSessionToken = nil;
+    _cachedSessionIdentifier = nil;
+}
+
 - (nullable NSString *)_tokenStringWithToken:(nonnull NSString *)token identifier:(nonnull NSString *)identifier {
     if (token && token.length &&
         identifier && identifier.length) {
@@ -0,0 +1,73 @@
+//
+//  AGRestBenchmark.h
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 03/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class BFTask;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class AGRestBenchmarkResult
+
+ @discussion Figures measured by a benchmark run. Latencies are per iteration, rates are per request.
+ */
+@interface AGRestBenchmarkResult : NSObject
+
+@property (nonatomic, copy) NSString        *name;
+@property (nonatomic, assign) NSUInteger    iterations;
+@property (nonatomic, assign) NSUInteger    requestsPerIteration;
+@property (nonatomic, assign) NSUInteger    failures;
+@property (nonatomic, assign) NSTimeInterval duration;
+@property (nonatomic, assign) double        requestsPerSecond;
+@property (nonatomic, assign) NSTimeInterval p50Latency;
+@property (nonatomic, assign) NSTimeInterval p99Latency;
+@property (nonatomic, assign) double        allocationsPerRequest;
+@property (nonatomic, assign) NSTimeInterval cpuTimePerRequest;
+@property (nonatomic, assign) unsigned long long peakResidentSize;
+
+/*!
+ @return The figures keyed by name, durations in milliseconds, CPU time in microseconds and sizes in bytes.
+ */
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation;
+
+@end
+
+/*!
+ @class AGRestBenchmark
+
+ @discussion Runs a block returning a BFTask a fixed number of times, keeping at most `concurrency` tasks in flight,
+ and measures throughput, latency percentiles, CPU time, allocations and peak resident memory.
+
+ Results are logged. When the AGREST_BENCHMARK_OUTPUT environment variable is set, they are also written there
+ as JSON, so that runs of two releases can be compared.
+ */
+@interface AGRestBenchmark : NSObject
+
+/*!
+ @abstract Runs the benchmark. Blocks the calling thread, which must not be the main thread.
+ @param name                    Name of the benchmark in the report.
+ @param iterations              Number of measured iterations, run after a short warm-up.
+ @param concurrency             Maximum number of iterations in flight.
+ @param requestsPerIteration    Number of requests sent by each iteration, to report per-request figures.
+ @param block                   Starts iteration `index`. An iteration fails when its task faults.
+ */
++ (AGRestBenchmarkResult *)runBenchmarkNamed:(NSString *)name
+                                  iterations:(NSUInteger)iterations
+                                 concurrency:(NSUInteger)concurrency
+                        requestsPerIteration:(NSUInteger)requestsPerIteration
+                                       block:(BFTask * (^)(NSUInteger index))block;
+
+/*!
+ @abstract Writes all the results collected so far to AGREST_BENCHMARK_OUTPUT, if set.
+ */
++ (void)writeResults;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,219 @@
+//
+//  AGRestBenchmark.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 03/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestBenchmark.h"
+
+#import <Bolts/Bolts.h>
+#import <libkern/OSAtomic.h>
+#import <mach/mach_time.h>
+#import <sys/resource.h>
+
+static NSUInteger const _AGRestBenchmarkWarmupIterations = 20;
+
+#pragma mark - Allocation Counting
+
+// Counts the allocations of the whole process through the malloc logger hook. libmalloc calls it for every zone,
+// including the nano zone serving most small allocations, which patching `malloc_default_zone()` misses.
+typedef void (_AGRestBenchmarkMallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip);
+extern _AGRestBenchmarkMallocLogger *malloc_logger;
+
+// From libmalloc's stack_logging.h, reallocations are logged as an allocation and a deallocation.
+#define _AGRestBenchmarkMallocLogTypeAllocate   2
+
+static volatile int64_t _AGRestBenchmarkAllocationCount = 0;
+static volatile int32_t _AGRestBenchmarkCountingAllocations = 0;
+static _AGRestBenchmarkMallocLogger *_AGRestBenchmarkPreviousMallocLogger = NULL;
+
+static void _AGRestBenchmarkCountingMallocLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip) {
+    if (_AGRestBenchmarkCountingAllocations && (type & _AGRestBenchmarkMallocLogTypeAllocate)) {
+        OSAtomicIncrement64(&_AGRestBenchmarkAllocationCount);
+    }
+    if (_AGRestBenchmarkPreviousMallocLogger) {
+        _AGRestBenchmarkPreviousMallocLogger(type, arg1, arg2, arg3, result, numHotFramesToSkip + 1);
+    }
+}
+
+static void _AGRestBenchmarkInstallAllocationCounter(void) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _AGRestBenchmarkPreviousMallocLogger = malloc_logger;
+        malloc_logger = _AGRestBenchmarkCountingMallocLogger;
+    });
+}
+
+static NSTimeInterval _AGRestBenchmarkCurrentTime(void) {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+    return (NSTimeInterval)(mach_absolute_time() * timebase.numer / timebase.denom) / NSEC_PER_SEC;
+}
+
+static unsigned long long _AGRestBenchmarkPeakResidentSize(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return (unsigned long long)usage.ru_maxrss; // Bytes on Darwin.
+}
+
+// User and system time of the whole process, the stub server included.
+static NSTimeInterval _AGRestBenchmarkCPUTime(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / (NSTimeInterval)USEC_PER_SEC;
+}
+
+static int _AGRestBenchmarkCompareLatencies(const void *a, const void *b) {
+    NSTimeInterval lhs = *(const NSTimeInterval *)a;
+    NSTimeInterval rhs = *(const NSTimeInterval *)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+#pragma mark - AGRestBenchmarkResult
+
+@implementation AGRestBenchmarkResult
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation {
+    return @{@"name":                   self.name,
+             @"iterations":             @(self.iterations),
+             @"requestsPerIteration":   @(self.requestsPerIteration),
+             @"failures":               @(self.failures),
+             @"duration":               @(self.duration * 1000.0),
+             @"requestsPerSecond":      @(self.requestsPerSecond),
+             @"p50":                    @(self.p50Latency * 1000.0),
+             @"p99":                    @(self.p99Latency * 1000.0),
+             @"allocationsPerRequest":  @(self.allocationsPerRequest),
+             @"cpuTimePerRequest":      @(self.cpuTimePerRequest * 1000000.0),
+             @"peakResidentSize":       @(self.peakResidentSize)};
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"%-32@ %8.0f req/s  p50 %7.2f ms  p99 %7.2f ms  %7.0f us CPU/req  %8.0f allocs/req  peak RSS %6.1f MB  (%lu failures)",
+            self.name, self.requestsPerSecond, self.p50Latency * 1000.0, self.p99Latency * 1000.0, self.cpuTimePerRequest * 1000000.0,
+            self.allocationsPerRequest, self.peakResidentSize / (1024.0 * 1024.0), (unsigned long)self.failures];
+}
+
+@end
+
+#pragma mark - AGRestBenchmark
+
+@implementation AGRestBenchmark
+
++ (NSMutableArray<AGRestBenchmarkResult *> *)_results {
+    static NSMutableArray *results = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        results = [NSMutableArray array];
+    });
+    return results;
+}
+
++ (AGRestBenchmarkResult *)runBenchmarkNamed:(NSString *)name
+                                  iterations:(NSUInteger)iterations
+                                 concurrency:(NSUInteger)concurrency
+                        requestsPerIteration:(NSUInteger)requestsPerIteration
+                                       block:(BFTask * (^)(NSUInteger index))block
+{
+    NSParameterAssert(![NSThread isMainThread]);
+    _AGRestBenchmarkInstallAllocationCounter();
+
+    // Warm up caches, connections and lazily loaded modules first.
+    [self _runIterations:MIN(_AGRestBenchmarkWarmupIterations, iterations) concurrency:concurrency latencies:NULL block:block];
+
+    NSTimeInterval *latencies = calloc(iterations, sizeof(NSTimeInterval));
+
+    _AGRestBenchmarkAllocationCount = 0;
+    OSAtomicIncrement32Barrier(&_AGRestBenchmarkCountingAllocations);
+    NSTimeInterval startTime = _AGRestBenchmarkCurrentTime();
+    NSTimeInterval startCPUTime = _AGRestBenchmarkCPUTime();
+
+    NSUInteger failures = [self _runIterations:iterations concurrency:concurrency latencies:latencies block:block];
+
+    NSTimeInterval duration = _AGRestBenchmarkCurrentTime() - startTime;
+    NSTimeInterval cpuTime = _AGRestBenchmarkCPUTime() - startCPUTime;
+    OSAtomicDecrement32Barrier(&_AGRestBenchmarkCountingAllocations);
+    int64_t allocations = _AGRestBenchmarkAllocationCount;
+
+    qsort(latencies, iterations, sizeof(NSTimeInterval), _AGRestBenchmarkCompareLatencies);
+
+    NSUInteger requestCount = MAX(iterations * requestsPerIteration, 1);
+    AGRestBenchmarkResult *result = [[AGRestBenchmarkResult alloc] init];
+    result.name = name;
+    result.iterations = iterations;
+    result.requestsPerIteration = requestsPerIteration;
+    result.failures = failures;
+    result.duration = duration;
+    result.requestsPerSecond = (duration > 0) ? requestCount / duration : 0;
+    result.p50Latency = latencies[MIN((NSUInteger)ceil(iterations * 0.50), iterations) - 1];
+    result.p99Latency = latencies[MIN((NSUInteger)ceil(iterations * 0.99), iterations) - 1];
+    result.allocationsPerRequest = (double)allocations / requestCount;
+    result.cpuTimePerRequest = cpuTime / requestCount;
+    result.peakResidentSize = _AGRestBenchmarkPeakResidentSize();
+    free(latencies);
+
+    NSLog(@"[Benchmark] %@", result);
+    @synchronized ([self _results]) {
+        [[self _results] addObject:result];
+    }
+    return result;
+}
+
++ (void)writeResults {
+    NSString *outputPath = [NSProcessInfo processInfo].environment[@"AGREST_BENCHMARK_OUTPUT"];
+    if (!outputPath.length) {
+        return;
+    }
+
+    NSMutableArray *results = [NSMutableArray array];
+    @synchronized ([self _results]) {
+        for (AGRestBenchmarkResult *result in [self _results]) {
+            [results addObject:[result dictionaryRepresentation]];
+        }
+    }
+    NSData *data = [NSJSONSerialization dataWithJSONObject:results options:NSJSONWritingPrettyPrinted error:nil];
+    [data writeToFile:outputPath atomically:YES];
+}
+
+#pragma mark - Private
+
++ (NSUInteger)_runIterations:(NSUInteger)iterations
+                 concurrency:(NSUInteger)concurrency
+                   latencies:(NSTimeInterval *)latencies
+                       block:(BFTask * (^)(NSUInteger index))block
+{
+    dispatch_semaphore_t inFlight = dispatch_semaphore_create((long)MAX(concurrency, 1));
+    dispatch_group_t group = dispatch_group_create();
+    __block volatile int32_t failures = 0;
+
+    for (NSUInteger i = 0; i < iterations; i++) {
+        dispatch_semaphore_wait(inFlight, DISPATCH_TIME_FOREVER);
+        dispatch_group_enter(group);
+
+        NSTimeInterval iterationStartTime = _AGRestBenchmarkCurrentTime();
+        [block(i) continueWithBlock:^id(BFTask *task) {
+            if (latencies) {
+                latencies[i] = _AGRestBenchmarkCurrentTime() - iterationStartTime;
+            }
+            if (task.faulted || task.cancelled) {
+                OSAtomicIncrement32(&failures);
+            }
+            dispatch_semaphore_signal(inFlight);
+            dispatch_group_leave(group);
+            return nil;
+        }];
+    }
+
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    return (NSUInteger)failures;
+}
+
+@end
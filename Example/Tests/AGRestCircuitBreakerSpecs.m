@@ -0,0 +1,126 @@
+//
+//  AGRestCircuitBreakerSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <AGRestKit/AGRestCircuitBreaker.h>
+#import <AGRestKit/AGRestRequest.h>
+#import <AGRestKit/AGRestResponse.h>
+
+static AGRestResponse *AGRestCircuitBreakerSpecsFailure(void) {
+    return [AGRestResponse responseWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil]
+                                  statusCode:0];
+}
+
+static AGRestResponse *AGRestCircuitBreakerSpecsSuccess(void) {
+    return [AGRestResponse responseWithData:nil header:@{} statusCode:200];
+}
+
+SpecBegin(AGRestCircuitBreaker)
+
+describe(@"circuit breaker", ^{
+
+    __block AGRestCircuitBreaker *breaker = nil;
+    NSString *key = @"api.example.com/users/:id";
+
+    // Sends a request through the circuit, returns NO if it wasn't allowed.
+    BOOL (^send)(AGRestResponse *) = ^BOOL(AGRestResponse *response) {
+        BOOL trial = NO;
+        if (![breaker allowRequestForKey:key trial:&trial]) {
+            return NO;
+        }
+        [breaker recordResponse:response forKey:key trial:trial];
+        return YES;
+    };
+
+    beforeEach(^{
+        breaker = [[AGRestCircuitBreaker alloc] init];
+        breaker.failureThreshold = 3;
+        breaker.openInterval = 0.05;
+    });
+
+    it(@"keys the circuits on the normalized endpoint", ^{
+        AGRestRequest *request = [AGRestRequest GETRequestWithUrl:@"https://API.example.com" endPoint:@"/users/123?fields=name" body:nil];
+        AGRestRequest *otherRequest = [AGRestRequest GETRequestWithUrl:@"https://api.example.com" endPoint:@"users/456" body:nil];
+        expect([AGRestCircuitBreaker circuitKeyForRequest:request]).to.equal(key);
+        expect([AGRestCircuitBreaker circuitKeyForRequest:otherRequest]).to.equal(key);
+    });
+
+    it(@"opens after consecutive failures", ^{
+        expect(send(AGRestCircuitBreakerSpecsFailure())).to.beTruthy();
+        expect(send(AGRestCircuitBreakerSpecsFailure())).to.beTruthy();
+        expect([breaker stateForKey:key]).to.equal(AGRestCircuitStateClosed);
+        expect(send(AGRestCircuitBreakerSpecsFailure())).to.beTruthy();
+        expect([breaker stateForKey:key]).to.equal(AGRestCircuitStateOpen);
+        expect(send(AGRestCircuitBreakerSpecsSuccess())).to.beFalsy();
+        expect([breaker openCircuits]).to.equal(@{key: @(AGRestCircuitStateOpen)});
+    });
+
+    it(@"doesn't count the failures before a success", ^{
+        send(AGRestCircuitBreakerSpecsFailure());
+        send(AGRestCircuitBreakerSpecsFailure());
+        send(AGRestCircuitBreakerSpecsSuccess());
+        send(AGRestCircuitBreakerSpecsFailure());
+        expect([breaker stateForKey:key]).to.equal(AGRestCircuitStateClosed);
+    });
+
+    it(@"doesn't count the failures older than the open interval", ^{
+        send(AGRestCircuitBreakerSpecsFailure());
+        send(AGRestCircuitBreakerSpecsFailure());
+        [NSThread sleepForTimeInterval:0.1];
+        send(AGRestCircuitBreakerSpecsFailure());
+        expect([breaker stateForKey:key]).to.equal(AGRestCircuitStateClosed);
+    });
+
+    it(@"closes once a trial succeeds", ^{
+        for (NSUInteger i = 0; i < 3; i++) {
+            send(AGRestCircuitBreakerSpecsFailure());
+        }
+        [NSThread sleepForTimeInterval:0.1];
+        expect([breaker stateForKey:key]).to.equal(AGRestCircuitStateHalfOpen);
+
+        BOOL trial = NO;
+        expect([breaker allowRequestForKey:key trial:&trial]).to.beTruthy();
+        expect(trial).to.beTruthy();
+        // A single trial in flight
+        BOOL otherTrial = NO;
+        expect([breaker allowRequestForKey:key trial:&otherTrial]).to.beFalsy();
+
+        [breaker recordResponse:AGRestCircuitBreakerSpecsSuccess() forKey:key trial:YES];
+        expect([breaker stateForKey:key]).to.equal(AGRestCircuitStateClosed);
+        expect([breaker openCircuits]).to.equal(@{});
+        expect(send(AGRestCircuitBreakerSpecsSuccess())).to.beTruthy();
+    });
+
+    it(@"opens again when a trial fails", ^{
+        for (NSUInteger i = 0; i < 3; i++) {
+            send(AGRestCircuitBreakerSpecsFailure());
+        }
+        [NSThread sleepForTimeInterval:0.1];
+        expect(send(AGRestCircuitBreakerSpecsFailure())).to.beTruthy();
+        expect([breaker stateForKey:key]).to.equal(AGRestCircuitStateOpen);
+        expect(send(AGRestCircuitBreakerSpecsSuccess())).to.beFalsy();
+    });
+
+    it(@"ignores cancelled requests", ^{
+        for (NSUInteger i = 0; i < 5; i++) {
+            send(nil);
+        }
+        expect([breaker stateForKey:key]).to.equal(AGRestCircuitStateClosed);
+    });
+
+    it(@"forgets the idle circuits", ^{
+        for (NSUInteger i = 0; i < 100; i++) {
+            [breaker recordResponse:AGRestCircuitBreakerSpecsFailure() forKey:[NSString stringWithFormat:@"host/%lu", (unsigned long)i] trial:NO];
+        }
+        expect([[breaker valueForKey:@"circuits"] count]).to.equal(100);
+        [NSThread sleepForTimeInterval:0.1];
+        [breaker recordResponse:AGRestCircuitBreakerSpecsFailure() forKey:key trial:NO];
+        expect([[breaker valueForKey:@"circuits"] count]).to.equal(1);
+    });
+});
+
+SpecEnd
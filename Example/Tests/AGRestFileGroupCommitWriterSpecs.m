@@ -0,0 +1,91 @@
+//
+//  AGRestFileGroupCommitWriterSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Bolts/Bolts.h>
+
+#import <AGRestKit/AGRestFileGroupCommitWriter.h>
+
+SpecBegin(AGRestFileGroupCommitWriter)
+
+describe(@"group commit", ^{
+
+    __block NSString *directoryPath = nil;
+    __block AGRestFileGroupCommitWriter *writer = nil;
+
+    beforeEach(^{
+        directoryPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+        [[NSFileManager defaultManager] createDirectoryAtPath:directoryPath withIntermediateDirectories:YES attributes:nil error:nil];
+        writer = [[AGRestFileGroupCommitWriter alloc] init];
+    });
+
+    afterEach(^{
+        [[NSFileManager defaultManager] removeItemAtPath:directoryPath error:nil];
+    });
+
+    it(@"writes a batch of files in place", ^{
+        NSMutableArray *tasks = [NSMutableArray array];
+        for (NSUInteger i = 0; i < 10; i++) {
+            NSData *data = [[NSString stringWithFormat:@"file %lu", (unsigned long)i] dataUsingEncoding:NSUTF8StringEncoding];
+            NSString *filePath = [directoryPath stringByAppendingPathComponent:[NSString stringWithFormat:@"file-%lu", (unsigned long)i]];
+            [tasks addObject:[writer writeDataAsync:data toFileAtPath:filePath]];
+        }
+        __block BFTask *result = nil;
+        waitUntil(^(DoneCallback done) {
+            [[BFTask taskForCompletionOfAllTasks:tasks] continueWithBlock:^id(BFTask *task) {
+                result = task;
+                done();
+                return nil;
+            }];
+        });
+        expect(result.faulted).to.beFalsy();
+
+        NSArray *contents = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:directoryPath error:nil];
+        // No temporary file left.
+        expect(contents.count).to.equal(10);
+        NSString *content = [NSString stringWithContentsOfFile:[directoryPath stringByAppendingPathComponent:@"file-3"]
+                                                      encoding:NSUTF8StringEncoding
+                                                         error:nil];
+        expect(content).to.equal(@"file 3");
+    });
+
+    it(@"commits a full batch without waiting", ^{
+        writer.commitInterval = 60;
+        writer.maxBatchSize = 2;
+        NSData *data = [@"data" dataUsingEncoding:NSUTF8StringEncoding];
+        __block BFTask *result = nil;
+        waitUntilTimeout(5, ^(DoneCallback done) {
+            NSArray *tasks = @[[writer writeDataAsync:data toFileAtPath:[directoryPath stringByAppendingPathComponent:@"a"]],
+                               [writer writeDataAsync:data toFileAtPath:[directoryPath stringByAppendingPathComponent:@"b"]]];
+            [[BFTask taskForCompletionOfAllTasks:tasks] continueWithBlock:^id(BFTask *task) {
+                result = task;
+                done();
+                return nil;
+            }];
+        });
+        expect(result.completed).to.beTruthy();
+        expect(result.faulted).to.beFalsy();
+    });
+
+    it(@"fails the writes that can't be made durable only", ^{
+        NSData *data = [@"data" dataUsingEncoding:NSUTF8StringEncoding];
+        __block BFTask *failedTask = nil;
+        __block BFTask *succeededTask = nil;
+        waitUntil(^(DoneCallback done) {
+            failedTask = [writer writeDataAsync:data toFileAtPath:[directoryPath stringByAppendingPathComponent:@"missing/file"]];
+            succeededTask = [writer writeDataAsync:data toFileAtPath:[directoryPath stringByAppendingPathComponent:@"file"]];
+            [[BFTask taskForCompletionOfAllTasks:@[failedTask, succeededTask]] continueWithBlock:^id(BFTask *task) {
+                done();
+                return nil;
+            }];
+        });
+        expect(failedTask.error.domain).to.equal(NSPOSIXErrorDomain);
+        expect(succeededTask.faulted).to.beFalsy();
+    });
+});
+
+SpecEnd
@@ -0,0 +1,179 @@
+//
+//  AGRestFileLockSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <AGRestKit/AGRestFileLock.h>
+#import <AGRestKit/AGRestFileLockController.h>
+
+static NSString *AGRestFileLockSpecsPath(void) {
+    return [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+}
+
+SpecBegin(AGRestFileLock)
+
+describe(@"AGRestFileLock", ^{
+
+    __block AGRestFileLock *fileLock = nil;
+
+    beforeEach(^{
+        fileLock = [AGRestFileLock fileLockForFileAtPath:AGRestFileLockSpecsPath()];
+    });
+
+    afterEach(^{
+        [[NSFileManager defaultManager] removeItemAtPath:fileLock.lockFilePath error:nil];
+    });
+
+    it(@"lets readers in together", ^{
+        id owner = [fileLock lockWithMode:AGRestFileLockModeShared];
+        __block BOOL otherReaderLocked = NO;
+        waitUntil(^(DoneCallback done) {
+            dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                id otherOwner = [fileLock lockWithMode:AGRestFileLockModeShared];
+                otherReaderLocked = YES;
+                [fileLock unlockWithOwner:otherOwner];
+                done();
+            });
+        });
+        [fileLock unlockWithOwner:owner];
+        expect(otherReaderLocked).to.beTruthy();
+    });
+
+    it(@"keeps readers out while writing", ^{
+        id owner = [fileLock lockWithMode:AGRestFileLockModeExclusive];
+        __block BOOL readerLocked = NO;
+        dispatch_semaphore_t readerDone = dispatch_semaphore_create(0);
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            id readerOwner = [fileLock lockWithMode:AGRestFileLockModeShared];
+            readerLocked = YES;
+            [fileLock unlockWithOwner:readerOwner];
+            dispatch_semaphore_signal(readerDone);
+        });
+        expect(dispatch_semaphore_wait(readerDone, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)))).toNot.equal(0);
+        expect(readerLocked).to.beFalsy();
+
+        [fileLock unlockWithOwner:owner];
+        expect(dispatch_semaphore_wait(readerDone, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(2 * NSEC_PER_SEC)))).to.equal(0);
+        expect(readerLocked).to.beTruthy();
+    });
+
+    it(@"is unlocked from another thread than the one which locked it", ^{
+        __block id owner = nil;
+        waitUntil(^(DoneCallback done) {
+            dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                owner = [fileLock lock];
+                done();
+            });
+        });
+        // The lock and its file descriptor are released, another writer gets them.
+        [fileLock unlockWithOwner:owner];
+        dispatch_semaphore_t otherDone = dispatch_semaphore_create(0);
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [fileLock unlockWithOwner:[fileLock lock]];
+            dispatch_semaphore_signal(otherDone);
+        });
+        expect(dispatch_semaphore_wait(otherDone, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(2 * NSEC_PER_SEC)))).to.equal(0);
+    });
+
+    it(@"ignores unlocks by other owners", ^{
+        id owner = [fileLock lock];
+        dispatch_semaphore_t otherDone = dispatch_semaphore_create(0);
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [fileLock unlockWithOwner:[fileLock lock]];
+            dispatch_semaphore_signal(otherDone);
+        });
+        [fileLock unlockWithOwner:[[NSObject alloc] init]];
+        expect(dispatch_semaphore_wait(otherDone, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)))).toNot.equal(0);
+
+        [fileLock unlockWithOwner:owner];
+        expect(dispatch_semaphore_wait(otherDone, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(2 * NSEC_PER_SEC)))).to.equal(0);
+    });
+
+    it(@"is reentrant for the writer", ^{
+        id owner = [fileLock lockWithMode:AGRestFileLockModeExclusive];
+        expect([fileLock lockWithMode:AGRestFileLockModeExclusive owner:owner]).to.beIdenticalTo(owner);
+        [fileLock lockWithMode:AGRestFileLockModeShared owner:owner];
+        [fileLock unlockWithOwner:owner];
+        [fileLock unlockWithOwner:owner];
+
+        // Still held until the last unlock.
+        __block BOOL otherLocked = NO;
+        dispatch_semaphore_t otherDone = dispatch_semaphore_create(0);
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            id otherOwner = [fileLock lock];
+            otherLocked = YES;
+            [fileLock unlockWithOwner:otherOwner];
+            dispatch_semaphore_signal(otherDone);
+        });
+        expect(dispatch_semaphore_wait(otherDone, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)))).toNot.equal(0);
+
+        [fileLock unlockWithOwner:owner];
+        expect(dispatch_semaphore_wait(otherDone, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(2 * NSEC_PER_SEC)))).to.equal(0);
+        expect(otherLocked).to.beTruthy();
+    });
+
+    it(@"is reentrant for a reader while a writer waits", ^{
+        id owner = [fileLock lockWithMode:AGRestFileLockModeShared];
+        dispatch_semaphore_t writerDone = dispatch_semaphore_create(0);
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [fileLock unlockWithOwner:[fileLock lock]];
+            dispatch_semaphore_signal(writerDone);
+        });
+        [NSThread sleepForTimeInterval:0.05];
+
+        // A new reader would wait for the writer, a nested one doesn't.
+        [fileLock lockWithMode:AGRestFileLockModeShared owner:owner];
+        [fileLock unlockWithOwner:owner];
+        [fileLock unlockWithOwner:owner];
+        expect(dispatch_semaphore_wait(writerDone, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(2 * NSEC_PER_SEC)))).to.equal(0);
+    });
+
+    it(@"refuses to upgrade a shared lock", ^{
+        id owner = [fileLock lockWithMode:AGRestFileLockModeShared];
+        expect(^{
+            [fileLock lockWithMode:AGRestFileLockModeExclusive owner:owner];
+        }).to.raise(NSInternalInconsistencyException);
+        [fileLock unlockWithOwner:owner];
+    });
+});
+
+describe(@"AGRestFileLockController", ^{
+
+    it(@"nests locks on the same path", ^{
+        NSString *filePath = AGRestFileLockSpecsPath();
+        AGRestFileLockController *controller = [AGRestFileLockController sharedController];
+        id owner = [controller beginLockContentOfFileAtPath:filePath];
+        [controller beginLockContentOfFileAtPath:filePath mode:AGRestFileLockModeShared owner:owner];
+        expect([controller lockedContentAccessCountForFileAtPath:filePath]).to.equal(2);
+        [controller endLockContentOfFileAtPath:filePath owner:owner];
+        [controller endLockContentOfFileAtPath:filePath owner:owner];
+        expect([controller lockedContentAccessCountForFileAtPath:filePath]).to.equal(0);
+        [[NSFileManager defaultManager] removeItemAtPath:[filePath stringByAppendingPathExtension:@"lock"] error:nil];
+    });
+
+    it(@"ends a lock from another thread than the one which began it", ^{
+        NSString *filePath = AGRestFileLockSpecsPath();
+        AGRestFileLockController *controller = [AGRestFileLockController sharedController];
+        __block id owner = nil;
+        waitUntil(^(DoneCallback done) {
+            dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                owner = [controller beginLockContentOfFileAtPath:filePath];
+                done();
+            });
+        });
+        [controller endLockContentOfFileAtPath:filePath owner:owner];
+
+        dispatch_semaphore_t otherDone = dispatch_semaphore_create(0);
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [controller endLockContentOfFileAtPath:filePath owner:[controller beginLockContentOfFileAtPath:filePath]];
+            dispatch_semaphore_signal(otherDone);
+        });
+        expect(dispatch_semaphore_wait(otherDone, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(2 * NSEC_PER_SEC)))).to.equal(0);
+        [[NSFileManager defaultManager] removeItemAtPath:[filePath stringByAppendingPathExtension:@"lock"] error:nil];
+    });
+});
+
+SpecEnd
@@ -0,0 +1,74 @@
+//
+//  AGRestFileManagerSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Bolts/Bolts.h>
+
+#import <AGRestKit/AGRestFileManager.h>
+
+SpecBegin(AGRestFileManager)
+
+describe(@"file reads", ^{
+
+    __block NSString *filePath = nil;
+    __block NSData *content = nil;
+
+    beforeEach(^{
+        filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+        content = [@"{\"mapped\":true}" dataUsingEncoding:NSUTF8StringEncoding];
+        [content writeToFile:filePath atomically:YES];
+    });
+
+    afterEach(^{
+        [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+    });
+
+    it(@"maps the content of a file", ^{
+        NSError *error = nil;
+        NSData *data = [AGRestFileManager mappedContentDataOfFile:filePath error:&error];
+        expect(error).to.beNil();
+        expect(data).to.equal(content);
+    });
+
+    it(@"maps an empty file", ^{
+        [[NSData data] writeToFile:filePath atomically:YES];
+        NSError *error = nil;
+        NSData *data = [AGRestFileManager mappedContentDataOfFile:filePath error:&error];
+        expect(error).to.beNil();
+        expect(data.length).to.equal(0);
+    });
+
+    it(@"keeps a mapping valid after the file is replaced", ^{
+        NSData *data = [AGRestFileManager mappedContentDataOfFile:filePath error:nil];
+        [[@"replaced" dataUsingEncoding:NSUTF8StringEncoding] writeToFile:filePath atomically:YES];
+        expect(data).to.equal(content);
+    });
+
+    it(@"fails with the POSIX error of a missing file", ^{
+        NSError *error = nil;
+        NSData *data = [AGRestFileManager mappedContentDataOfFile:[filePath stringByAppendingPathExtension:@"missing"]
+                                                            error:&error];
+        expect(data).to.beNil();
+        expect(error.domain).to.equal(NSPOSIXErrorDomain);
+        expect(error.code).to.equal(ENOENT);
+    });
+
+    it(@"reads asynchronously", ^{
+        __block BFTask *result = nil;
+        waitUntil(^(DoneCallback done) {
+            [[AGRestFileManager contentDataAsyncFromFile:filePath] continueWithBlock:^id(BFTask *task) {
+                result = task;
+                done();
+                return nil;
+            }];
+        });
+        expect(result.faulted).to.beFalsy();
+        expect(result.result).to.equal(content);
+    });
+});
+
+SpecEnd
@@ -0,0 +1,127 @@
+//
+//  AGRestLoopbackServer.h
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 10/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import <AGRestKit/AGRestServerProtocol.h>
+
+@class AGRestRequest;
+@class AGRestResponse;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  @typedef AGRestLoopbackLatencyDistribution
+ *  Distribution of the latency added to each response.
+ */
+typedef NS_ENUM(NSUInteger, AGRestLoopbackLatencyDistribution) {
+    /*!
+     Always `latency`.
+     */
+    AGRestLoopbackLatencyConstant = 0,
+    /*!
+     Uniform within `latency` ± `latencyDeviation`.
+     */
+    AGRestLoopbackLatencyUniform,
+    /*!
+     Exponential of mean `latency`, for arrival-like delays.
+     */
+    AGRestLoopbackLatencyExponential,
+    /*!
+     Log-normal of median `latency` and log deviation `latencyDeviation`, with the long tail of real networks.
+     */
+    AGRestLoopbackLatencyLogNormal
+};
+
+/*!
+ @abstract Scripts the response to a request.
+ @param request The request run.
+ @param index   The number of requests run before this one.
+ @return The response, or nil to answer with the canned payload of the request end point.
+ */
+typedef AGRestResponse * _Nullable (^AGRestLoopbackResponseBlock)(AGRestRequest *request, NSUInteger index);
+
+/*!
+ @class AGRestLoopbackServer
+
+ @discussion Server answering requests in-process, without any network, with canned or scripted responses.
+
+ Each request draws its latency and faults on a serial event queue from a pseudo random generator seeded with `seed`,
+ so that two runs sending the requests in the same order see the same responses, delays and faults. Responses are
+ delivered on a background queue after their delay, faults come back as responses with an NSURLErrorDomain error like
+ the ones of AGRestServer, so that the runner retries, the eventually queue and the cache handle them as usual.
+
+ Install it with `[AGRest setServerInstance:]`.
+ */
+@interface AGRestLoopbackServer : NSObject <AGRestServerProtocol>
+
+/*!
+ @abstract Seed of the generator drawing the latencies and faults. Setting it restarts the sequence.
+ */
+@property (nonatomic, assign) uint64_t                              seed;
+
+/*!
+ @abstract Scripted responses, tried before the canned payloads.
+ */
+@property (nonatomic, copy, nullable) AGRestLoopbackResponseBlock   responseBlock;
+
+///------------------
+/// @name Latency
+///------------------
+@property (nonatomic, assign) AGRestLoopbackLatencyDistribution     latencyDistribution;
+/*!
+ @abstract Mean, or median for the log-normal distribution, in seconds. 0 by default.
+ */
+@property (nonatomic, assign) NSTimeInterval                        latency;
+@property (nonatomic, assign) NSTimeInterval                        latencyDeviation;
+/*!
+ @abstract Bytes per second the request and response bodies are sent at, 0 for no limit.
+ */
+@property (nonatomic, assign) double                                bandwidth;
+
+///------------------
+/// @name Faults
+///------------------
+/*!
+ @abstract Share of the requests failing with a lost connection, between 0 and 1.
+ */
+@property (nonatomic, assign) double                                errorRate;
+/*!
+ @abstract Share of the requests answered with a 503 status, between 0 and 1.
+ */
+@property (nonatomic, assign) double                                serverErrorRate;
+/*!
+ @abstract Share of the requests timing out after `timeoutInterval`, between 0 and 1.
+ */
+@property (nonatomic, assign) double                                timeoutRate;
+@property (nonatomic, assign) NSTimeInterval                        timeoutInterval;
+
+///------------------
+/// @name Counters
+///------------------
+@property (atomic, assign, readonly) NSUInteger                     requestCount;
+@property (atomic, assign, readonly) NSUInteger                     faultCount;
+/*!
+ @abstract Headers set with `setValue:forHTTPHeaderField:`.
+ */
+@property (atomic, copy, readonly) NSDictionary<NSString *, NSString *> *HTTPHeaders;
+
+/*!
+ @abstract Creates a server answering requests to each path with its payload, and 404 to any other path.
+ @param payloads    Response bodies keyed by path (e.g. "/payload/small"), query strings are ignored.
+ */
+- (instancetype)initWithPayloads:(NSDictionary<NSString *, NSData *> *)payloads;
+
+/*!
+ @abstract Resets the counters and headers, and restarts the generator sequence. Requests in flight still complete.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
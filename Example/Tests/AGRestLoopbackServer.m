@@ -0,0 +1,229 @@
+//
+//  AGRestLoopbackServer.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 10/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestLoopbackServer.h"
+
+#import <Bolts/Bolts.h>
+
+#import <AGRestKit/AGRestRequest.h>
+#import <AGRestKit/AGRestRequest_Private.h>
+#import <AGRestKit/AGRestResponse.h>
+#import <AGRestKit/AGRestRequestTrace_Private.h>
+
+static uint64_t const AGRestLoopbackDefaultSeed = 0x9E3779B97F4A7C15ULL;
+
+// splitmix64, spreads any seed over the whole state so that close seeds give unrelated sequences.
+static uint64_t _AGRestLoopbackMixSeed(uint64_t seed) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    return z ?: AGRestLoopbackDefaultSeed;
+}
+
+@interface AGRestLoopbackServer () {
+    dispatch_queue_t    _eventQueue;
+    NSDictionary        *_payloads;
+    NSMutableDictionary *_headers;
+    // xorshift64* state, only used on the event queue.
+    uint64_t            _randomState;
+}
+
+@property (atomic, assign, readwrite) NSUInteger requestCount;
+@property (atomic, assign, readwrite) NSUInteger faultCount;
+
+@end
+
+@implementation AGRestLoopbackServer
+
+- (instancetype)initWithPayloads:(NSDictionary<NSString *, NSData *> *)payloads {
+    self = [super init];
+    if (!self) return nil;
+
+    _payloads = [payloads copy];
+    _headers = [NSMutableDictionary dictionary];
+    _eventQueue = dispatch_queue_create("com.AGRest.tests.loopbackServer", DISPATCH_QUEUE_SERIAL);
+    _timeoutInterval = 1.0;
+    self.seed = AGRestLoopbackDefaultSeed;
+
+    return self;
+}
+
+- (void)setSeed:(uint64_t)seed {
+    _seed = seed;
+    dispatch_sync(_eventQueue, ^{
+        _randomState = _AGRestLoopbackMixSeed(seed);
+    });
+}
+
+- (NSDictionary<NSString *, NSString *> *)HTTPHeaders {
+    @synchronized(_headers) {
+        return [_headers copy];
+    }
+}
+
+#pragma mark - AGRestServerProtocol
+#pragma mark -
+
+- (void)reset {
+    @synchronized(_headers) {
+        [_headers removeAllObjects];
+    }
+    self.requestCount = 0;
+    self.faultCount = 0;
+    self.seed = _seed;
+}
+
+- (void)setValue:(nullable NSString *)value forHTTPHeaderField:(nonnull NSString *)key {
+    @synchronized(_headers) {
+        _headers[key] = value;
+    }
+}
+
+- (BFTask *)runRequestAsync:(AGRestRequest *)request withOptions:(AGRestRequestRunningOptions)options {
+    return [self runRequestAsync:request withOptions:options cancellationToken:nil];
+}
+
+- (BFTask *)runRequestAsync:(AGRestRequest *)request
+                withOptions:(AGRestRequestRunningOptions)options
+          cancellationToken:(BFCancellationToken *)token
+{
+    if (token.cancellationRequested) {
+        return [BFTask cancelledTask];
+    }
+
+    AGRestRequestTrace *trace = request.trace;
+    [trace endStage:AGRestRequestTraceStageRunnerDispatch];
+
+    BFTaskCompletionSource *completionSource = [BFTaskCompletionSource taskCompletionSource];
+    [token registerCancellationObserverWithBlock:^{
+        NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+        [completionSource trySetResult:[AGRestResponse responseWithError:error statusCode:0]];
+    }];
+
+    dispatch_async(_eventQueue, ^{
+        [trace beginStage:AGRestRequestTraceStageTimeToFirstByte];
+
+        NSTimeInterval delay = 0;
+        AGRestResponse *response = [self _responseForRequest:request delay:&delay];
+
+        dispatch_block_t complete = ^{
+            [trace endStage:AGRestRequestTraceStageTimeToFirstByte];
+            [trace beginStage:AGRestRequestTraceStageCompletion];
+            [completionSource trySetResult:response];
+        };
+        dispatch_queue_t completionQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+        if (delay > 0) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), completionQueue, complete);
+        } else {
+            dispatch_async(completionQueue, complete);
+        }
+    });
+    return completionSource.task;
+}
+
+#pragma mark - Private()
+#pragma mark -
+
+// On the event queue : draws the fault, then the response and its delay, always in that order.
+- (AGRestResponse *)_responseForRequest:(AGRestRequest *)request delay:(NSTimeInterval *)delay {
+    NSUInteger index = self.requestCount;
+    self.requestCount = index + 1;
+
+    double fault = [self _nextRandom];
+    *delay = [self _nextLatency];
+
+    if (fault < self.errorRate) {
+        self.faultCount++;
+        return [self _responseWithErrorCode:NSURLErrorNetworkConnectionLost statusCode:0];
+    }
+    fault -= self.errorRate;
+    if (fault < self.timeoutRate) {
+        self.faultCount++;
+        *delay = MAX(*delay, self.timeoutInterval);
+        return [self _responseWithErrorCode:NSURLErrorTimedOut statusCode:0];
+    }
+    fault -= self.timeoutRate;
+    if (fault < self.serverErrorRate) {
+        self.faultCount++;
+        return [self _responseWithErrorCode:NSURLErrorBadServerResponse statusCode:503];
+    }
+
+    AGRestResponse *response = (self.responseBlock) ? self.responseBlock(request, index) : nil;
+    NSData *payload = nil;
+    if (!response) {
+        payload = _payloads[[self _pathForRequest:request]];
+        response = (payload) ?
+            [AGRestResponse responseWithData:payload
+                                      header:@{@"Content-Type": @"application/json",
+                                               @"Content-Length": [@(payload.length) stringValue]}
+                                  statusCode:200] :
+            [self _responseWithErrorCode:NSURLErrorBadServerResponse statusCode:404];
+    }
+
+    if (self.bandwidth > 0) {
+        NSUInteger bytes = payload.length;
+        if (request.body) {
+            bytes += [NSJSONSerialization dataWithJSONObject:request.body options:0 error:nil].length;
+        }
+        *delay += bytes / self.bandwidth;
+    }
+    return response;
+}
+
+- (NSString *)_pathForRequest:(AGRestRequest *)request {
+    NSString *path = [request.endPoint componentsSeparatedByString:@"?"].firstObject ?: @"";
+    return ([path hasPrefix:@"/"]) ? path : [@"/" stringByAppendingString:path];
+}
+
+- (AGRestResponse *)_responseWithErrorCode:(NSInteger)code statusCode:(NSInteger)statusCode {
+    NSString *description = (statusCode) ?
+        [NSString stringWithFormat:@"Request failed: %@ (%ld)", [NSHTTPURLResponse localizedStringForStatusCode:statusCode], (long)statusCode] :
+        @"Injected fault";
+    NSError *error = [NSError errorWithDomain:NSURLErrorDomain
+                                         code:code
+                                     userInfo:@{NSLocalizedDescriptionKey: description}];
+    return [AGRestResponse responseWithError:error statusCode:statusCode];
+}
+
+#pragma mark - Random
+#pragma mark -
+
+// Uniform in [0, 1).
+- (double)_nextRandom {
+    _randomState ^= _randomState >> 12;
+    _randomState ^= _randomState << 25;
+    _randomState ^= _randomState >> 27;
+    return ((_randomState * 0x2545F4914F6CDD1DULL) >> 11) * 0x1.0p-53;
+}
+
+// Standard normal, Box-Muller.
+- (double)_nextGaussian {
+    double u1 = 1.0 - [self _nextRandom];
+    double u2 = [self _nextRandom];
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+- (NSTimeInterval)_nextLatency {
+    if (self.latency <= 0) {
+        return 0;
+    }
+    switch (self.latencyDistribution) {
+        case AGRestLoopbackLatencyConstant:
+            return self.latency;
+        case AGRestLoopbackLatencyUniform:
+            return MAX(self.latency + self.latencyDeviation * (2.0 * [self _nextRandom] - 1.0), 0);
+        case AGRestLoopbackLatencyExponential:
+            return -self.latency * log(1.0 - [self _nextRandom]);
+        case AGRestLoopbackLatencyLogNormal:
+            return self.latency * exp(self.latencyDeviation * [self _nextGaussian]);
+    }
+    return self.latency;
+}
+
+@end
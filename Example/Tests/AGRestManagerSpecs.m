@@ -0,0 +1,54 @@
+//
+//  AGRestManagerSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <libkern/OSAtomic.h>
+
+#import <Bolts/Bolts.h>
+
+#import <AGRestKit/AGRestManager.h>
+#import <AGRestKit/AGRestMetrics.h>
+
+SpecBegin(AGRestManager)
+
+describe(@"preload", ^{
+
+    it(@"raises on the calling thread when the server can't be initialized", ^{
+        AGRestManager *manager = [[AGRestManager alloc] initWithBaseUrl:@""];
+        expect(^{
+            [manager preload];
+        }).to.raise(NSInternalInconsistencyException);
+        expect(manager.preloadTask).to.beNil();
+    });
+
+    it(@"starts over after a reset", ^{
+        AGRestManager *manager = [[AGRestManager alloc] initWithBaseUrl:@"https://api.example.com"];
+        BFTask *preloadTask = [manager preload];
+        [preloadTask waitUntilFinished];
+        [manager reset];
+        expect(manager.preloadTask).to.beNil();
+        expect([manager preload]).notTo.beIdenticalTo(preloadTask);
+    });
+});
+
+describe(@"modules", ^{
+
+    it(@"hands out live modules while they are replaced", ^{
+        AGRestManager *manager = [[AGRestManager alloc] initWithBaseUrl:@"https://api.example.com"];
+        __block int32_t unexpectedModules = 0;
+        dispatch_apply(2000, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t index) {
+            if (index % 2) {
+                manager.metrics = [[AGRestMetrics alloc] init];
+            } else if (![(id)manager.metrics isKindOfClass:[AGRestMetrics class]]) {
+                OSAtomicIncrement32(&unexpectedModules);
+            }
+        });
+        expect(unexpectedModules).to.equal(0);
+    });
+});
+
+SpecEnd
@@ -0,0 +1,63 @@
+//
+//  AGRestMetricsSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <AGRestKit/AGRestMetrics.h>
+#import <AGRestKit/AGRestRequest+Format.h>
+
+SpecBegin(AGRestMetrics)
+
+describe(@"endpoint normalization", ^{
+
+    it(@"drops the query and fragment", ^{
+        expect([AGRestRequest normalizedEndPoint:@"users?page=2#top"]).to.equal(@"users");
+    });
+
+    it(@"collapses identifier segments", ^{
+        expect([AGRestRequest normalizedEndPoint:@"/users/42/posts"]).to.equal(@"/users/:id/posts");
+        expect([AGRestRequest normalizedEndPoint:@"users/E621E1F8-C36C-495A-93FC-0C247A3E6E5F"]).to.equal(@"users/:id");
+        expect([AGRestRequest normalizedEndPoint:@"users/507f1f77bcf86cd799439011/avatar"]).to.equal(@"users/:id/avatar");
+    });
+
+    it(@"keeps named segments", ^{
+        expect([AGRestRequest normalizedEndPoint:@"v2/users/me"]).to.equal(@"v2/users/me");
+        expect([AGRestRequest normalizedEndPoint:@"feed"]).to.equal(@"feed");
+    });
+});
+
+describe(@"snapshot", ^{
+
+    __block AGRestMetrics *metrics = nil;
+
+    beforeEach(^{
+        metrics = [[AGRestMetrics alloc] init];
+    });
+
+    it(@"aggregates the requests to the same endpoint template", ^{
+        for (NSUInteger i = 0; i < 300; i++) {
+            [metrics recordRequestWithMethod:@"GET"
+                                    endpoint:[NSString stringWithFormat:@"users/%lu?fields=name", (unsigned long)i]
+                                  statusCode:200
+                                    duration:0.01];
+        }
+        NSDictionary *latency = [metrics snapshot][AGRestMetricsLatencyKey];
+        expect(latency.count).to.equal(1);
+        expect(latency[@"GET users/:id 2xx"][AGRestMetricsLatencyCountKey]).to.equal(300);
+    });
+
+    it(@"reports the cache hit ratio only once a cache was consulted", ^{
+        expect([metrics snapshot][AGRestMetricsCacheHitRatioKey]).to.beNil();
+
+        [metrics recordCacheHit];
+        [metrics recordCacheMiss];
+        [metrics recordCacheMiss];
+        [metrics recordCacheMiss];
+        expect([[metrics snapshot][AGRestMetricsCacheHitRatioKey] doubleValue]).to.beCloseTo(0.25);
+    });
+});
+
+SpecEnd
@@ -0,0 +1,163 @@
+//
+//  AGRestObjectBinaryCoderSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <AGRestKit/AGRestObjectMapping.h>
+#import <AGRestKit/AGRestObjectBinaryCoder.h>
+
+#pragma mark - Models
+#pragma mark -
+
+@interface AGRestObjectBinaryCoderSpecsUser : NSObject <AGRestObjectMapping>
+
+@property (nonatomic, copy) NSString        *name;
+@property (nonatomic, assign) NSInteger     age;
+@property (nonatomic, assign) double        score;
+@property (nonatomic, assign) BOOL          verified;
+@property (nonatomic, strong) NSDate        *birthDate;
+@property (nonatomic, strong) NSData        *avatar;
+@property (nonatomic, copy) NSArray         *tags;
+@property (nonatomic, copy) NSString        *password;
+
+@end
+
+@implementation AGRestObjectBinaryCoderSpecsUser
+
++ (NSString *)classURI {
+    return @"specs.user";
+}
+
+- (NSArray *)excludedPropertyKeys {
+    return @[@"password"];
+}
+
+@end
+
+// The same user after a schema change : `age` changed type, `email` was added, the others were removed.
+@interface AGRestObjectBinaryCoderSpecsUserV2 : NSObject <AGRestObjectMapping>
+
+@property (nonatomic, copy) NSString        *name;
+@property (nonatomic, copy) NSString        *age;
+@property (nonatomic, copy) NSString        *email;
+
+@end
+
+@implementation AGRestObjectBinaryCoderSpecsUserV2
+
++ (NSString *)classURI {
+    return @"specs.user";
+}
+
+@end
+
+@interface AGRestObjectBinaryCoderSpecsCodingUser : NSObject <AGRestObjectMapping, NSCoding>
+
+@property (nonatomic, copy) NSString        *name;
+
+@end
+
+@implementation AGRestObjectBinaryCoderSpecsCodingUser
+
++ (NSString *)classURI {
+    return @"specs.codingUser";
+}
+
+- (instancetype)initWithCoder:(NSCoder *)aDecoder {
+    return [super init];
+}
+
+- (void)encodeWithCoder:(NSCoder *)aCoder {
+}
+
+@end
+
+#pragma mark - Specs
+#pragma mark -
+
+SpecBegin(AGRestObjectBinaryCoder)
+
+describe(@"binary coder", ^{
+
+    __block AGRestObjectBinaryCoderSpecsUser *user = nil;
+
+    beforeEach(^{
+        user = [[AGRestObjectBinaryCoderSpecsUser alloc] init];
+        user.name = @"Adrien";
+        user.age = -42;
+        user.score = 3.5;
+        user.verified = YES;
+        user.birthDate = [NSDate dateWithTimeIntervalSince1970:1447372800];
+        user.avatar = [@"avatar" dataUsingEncoding:NSUTF8StringEncoding];
+        user.tags = @[@"a", @"b"];
+        user.password = @"secret";
+    });
+
+    it(@"round-trips every supported value", ^{
+        NSError *error = nil;
+        NSData *data = [AGRestObjectBinaryCoder dataWithObject:user error:&error];
+        expect(error).to.beNil();
+        expect([AGRestObjectBinaryCoder isBinaryData:data]).to.beTruthy();
+
+        AGRestObjectBinaryCoderSpecsUser *decodedUser = [AGRestObjectBinaryCoder objectOfClass:[AGRestObjectBinaryCoderSpecsUser class]
+                                                                                      withData:data
+                                                                                         error:&error];
+        expect(error).to.beNil();
+        expect(decodedUser.name).to.equal(@"Adrien");
+        expect(decodedUser.age).to.equal(-42);
+        expect(decodedUser.score).to.equal(3.5);
+        expect(decodedUser.verified).to.beTruthy();
+        expect(decodedUser.birthDate).to.equal(user.birthDate);
+        expect(decodedUser.avatar).to.equal(user.avatar);
+        expect(decodedUser.tags).to.equal(@[@"a", @"b"]);
+    });
+
+    it(@"never writes the excluded properties", ^{
+        NSData *data = [AGRestObjectBinaryCoder dataWithObject:user error:nil];
+        NSData *secret = [@"secret" dataUsingEncoding:NSUTF8StringEncoding];
+        expect([data rangeOfData:secret options:0 range:NSMakeRange(0, data.length)].location).to.equal(NSNotFound);
+        AGRestObjectBinaryCoderSpecsUser *decodedUser = [AGRestObjectBinaryCoder objectOfClass:[AGRestObjectBinaryCoderSpecsUser class]
+                                                                                      withData:data
+                                                                                         error:nil];
+        expect(decodedUser.password).to.beNil();
+    });
+
+    it(@"decodes by name after a schema change", ^{
+        NSData *data = [AGRestObjectBinaryCoder dataWithObject:user error:nil];
+        NSError *error = nil;
+        AGRestObjectBinaryCoderSpecsUserV2 *decodedUser = [AGRestObjectBinaryCoder objectOfClass:[AGRestObjectBinaryCoderSpecsUserV2 class]
+                                                                                        withData:data
+                                                                                           error:&error];
+        expect(error).to.beNil();
+        expect(decodedUser).to.beKindOf([AGRestObjectBinaryCoderSpecsUserV2 class]);
+        expect(decodedUser.name).to.equal(@"Adrien");
+        // A number is no longer a valid value
+        expect(decodedUser.age).to.beNil();
+        expect(decodedUser.email).to.beNil();
+    });
+
+    it(@"fails on truncated data", ^{
+        NSData *data = [AGRestObjectBinaryCoder dataWithObject:user error:nil];
+        for (NSUInteger length = 0; length < data.length; length++) {
+            NSError *error = nil;
+            id object = [AGRestObjectBinaryCoder objectOfClass:[AGRestObjectBinaryCoderSpecsUser class]
+                                                      withData:[data subdataWithRange:NSMakeRange(0, length)]
+                                                         error:&error];
+            expect(object).to.beNil();
+            expect(error).toNot.beNil();
+        }
+    });
+
+    it(@"refuses NSCoding classes", ^{
+        AGRestObjectBinaryCoderSpecsCodingUser *codingUser = [[AGRestObjectBinaryCoderSpecsCodingUser alloc] init];
+        codingUser.name = @"Adrien";
+        NSError *error = nil;
+        expect([AGRestObjectBinaryCoder dataWithObject:codingUser error:&error]).to.beNil();
+        expect(error).toNot.beNil();
+    });
+});
+
+SpecEnd
@@ -0,0 +1,51 @@
+//
+//  AGRestRequestCacheSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <AGRestKit/AGRestRequestCache.h>
+#import <AGRestKit/AGRestEventuallyQueue_Private.h>
+#import <AGRestKit/AGRestRequestRunner.h>
+
+SpecBegin(AGRestRequestCache)
+
+describe(@"disk cache index", ^{
+
+    __block NSString *cacheDirectory = nil;
+
+    beforeEach(^{
+        cacheDirectory = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+        NSFileManager *fileManager = [NSFileManager defaultManager];
+        [fileManager createDirectoryAtPath:cacheDirectory withIntermediateDirectories:YES attributes:nil error:nil];
+
+        NSData *data = [@"{\"r\":1}" dataUsingEncoding:NSUTF8StringEncoding];
+        [data writeToFile:[cacheDirectory stringByAppendingPathComponent:@"Request-0000000000000002-00000000-B"] atomically:NO];
+        [data writeToFile:[cacheDirectory stringByAppendingPathComponent:@"Request-0000000000000001-00000000-A"] atomically:NO];
+        // Left behind by a crashed group commit.
+        [data writeToFile:[cacheDirectory stringByAppendingPathComponent:@".Request-0000000000000003-00000000-C.0000.tmp"] atomically:NO];
+        // Not ours, and not descended into.
+        NSString *subdirectory = [cacheDirectory stringByAppendingPathComponent:@"Request-directory"];
+        [fileManager createDirectoryAtPath:subdirectory withIntermediateDirectories:YES attributes:nil error:nil];
+        [data writeToFile:[subdirectory stringByAppendingPathComponent:@"Request-0000000000000004-00000000-D"] atomically:NO];
+    });
+
+    afterEach(^{
+        [[NSFileManager defaultManager] removeItemAtPath:cacheDirectory error:nil];
+    });
+
+    it(@"indexes only the request files at the top level", ^{
+        AGRestRequestRunner *runner = [[AGRestRequestRunner alloc] initWithDataSource:nil];
+        AGRestRequestCache *cache = [[AGRestRequestCache alloc] initWithRequestRunner:runner
+                                                                       cacheDirectory:cacheDirectory
+                                                                         maxCacheSize:1024];
+        // Indexed in background, the count never blocks.
+        expect(cache.requestsCount).will.equal(2);
+        expect([cache _pendingRequestIdentifiers]).to.equal(@[@"Request-0000000000000001-00000000-A",
+                                                              @"Request-0000000000000002-00000000-B"]);
+    });
+});
+
+SpecEnd
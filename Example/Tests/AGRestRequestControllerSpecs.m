@@ -0,0 +1,109 @@
+//
+//  AGRestRequestControllerSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Bolts/Bolts.h>
+
+#import <AGRestKit/AGRestRequestController.h>
+#import <AGRestKit/AGRestRequest.h>
+#import <AGRestKit/AGRestResponse.h>
+
+#pragma mark - Data source
+#pragma mark -
+
+// Stands for the session controller with a refresh in progress, and for the runner counting the requests sent.
+@interface AGRestRequestControllerSpecsDataSource : NSObject
+
+@property (nonatomic, strong) BFTaskCompletionSource *refreshCompletionSource;
+@property (nonatomic, assign) NSUInteger runCount;
+
+@end
+
+@implementation AGRestRequestControllerSpecsDataSource
+
+- (id)sessionController {
+    return self;
+}
+
+- (id)requestRunner {
+    return self;
+}
+
+- (BFTask *)sessionRefreshTask {
+    return self.refreshCompletionSource.task;
+}
+
+- (BFTask *)runRequestAsync:(AGRestRequest *)request
+                withOptions:(NSUInteger)options
+          cancellationToken:(BFCancellationToken *)cancellationToken {
+    @synchronized (self) {
+        self.runCount++;
+    }
+    return [BFTask taskWithResult:[AGRestResponse responseWithData:nil header:nil statusCode:200]];
+}
+
+@end
+
+#pragma mark - Specs
+#pragma mark -
+
+SpecBegin(AGRestRequestController)
+
+describe(@"requests parked during a session refresh", ^{
+
+    __block AGRestRequestControllerSpecsDataSource *dataSource = nil;
+    __block AGRestRequestController *controller = nil;
+    __block AGRestRequest *request = nil;
+
+    beforeEach(^{
+        dataSource = [[AGRestRequestControllerSpecsDataSource alloc] init];
+        dataSource.refreshCompletionSource = [BFTaskCompletionSource taskCompletionSource];
+        controller = [AGRestRequestController controllerWithDataSource:(id)dataSource];
+        request = [AGRestRequest requestWithMethod:AGRestRequestMethodHttpGET
+                                               url:@"http://127.0.0.1"
+                                          endPoint:@"users"
+                                           headers:nil
+                                              body:nil];
+    });
+
+    it(@"are sent once the session is refreshed", ^{
+        BFTask *task = [controller runRequestAsync:request withCancellationToken:nil];
+        expect(dataSource.runCount).to.equal(0);
+        [dataSource.refreshCompletionSource setResult:@"fresh"];
+        waitUntil(^(DoneCallback done) {
+            [task continueWithBlock:^id(BFTask *task) {
+                done();
+                return nil;
+            }];
+        });
+        expect(dataSource.runCount).to.equal(1);
+        expect([task.result succeeded]).to.beTruthy();
+    });
+
+    it(@"fail with the refresh error, without being sent, when the refresh fails", ^{
+        NSMutableArray *tasks = [NSMutableArray array];
+        for (NSUInteger i = 0; i < 3; i++) {
+            [tasks addObject:[controller runRequestAsync:request withCancellationToken:nil]];
+        }
+        NSError *refreshError = [NSError errorWithDomain:@"AGRestRequestControllerSpecs" code:206 userInfo:nil];
+        [dataSource.refreshCompletionSource setError:refreshError];
+        waitUntil(^(DoneCallback done) {
+            [[BFTask taskForCompletionOfAllTasks:tasks] continueWithBlock:^id(BFTask *task) {
+                done();
+                return nil;
+            }];
+        });
+        expect(dataSource.runCount).to.equal(0);
+        for (BFTask *task in tasks) {
+            AGRestResponse *response = task.result;
+            expect(response.succeeded).to.beFalsy();
+            expect(response.responseError).to.equal(refreshError);
+        }
+    });
+});
+
+SpecEnd
@@ -0,0 +1,91 @@
+//
+//  AGRestRequestSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Bolts/Bolts.h>
+
+#import <AGRestKit/AGRestRequest.h>
+#import <AGRestKit/AGRestRequest_Private.h>
+#import <AGRestKit/AGRestConstants.h>
+
+// Specs run on the main thread, where the synchronous API refuses to wait.
+static BFTask *AGRestRequestSpecsSendInBackground(BFTask *(^send)(void)) {
+    __block BFTask *result = nil;
+    waitUntilTimeout(5, ^(DoneCallback done) {
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            result = send();
+            dispatch_async(dispatch_get_main_queue(), ^{
+                done();
+            });
+        });
+    });
+    return result;
+}
+
+SpecBegin(AGRestRequest)
+
+describe(@"synchronous send", ^{
+
+    it(@"returns the result of the requests", ^{
+        BFTask *task = AGRestRequestSpecsSendInBackground(^BFTask *{
+            return [AGRestRequest _sendSynchronouslyWithTimeout:1 taskBlock:^BFTask *{
+                return [BFTask taskWithResult:@"response"];
+            } cancellationBlock:^{}];
+        });
+        expect(task.result).to.equal(@"response");
+    });
+
+    it(@"times out and cancels the requests", ^{
+        BFTaskCompletionSource *source = [BFTaskCompletionSource taskCompletionSource];
+        __block BOOL cancelled = NO;
+        BFTask *task = AGRestRequestSpecsSendInBackground(^BFTask *{
+            return [AGRestRequest _sendSynchronouslyWithTimeout:0.1 taskBlock:^BFTask *{
+                return source.task;
+            } cancellationBlock:^{
+                cancelled = YES;
+            }];
+        });
+        expect(task.error.domain).to.equal(AGRestErrorDomain);
+        expect(task.error.code).to.equal(kAGErrorTimeout);
+        expect(cancelled).to.beTruthy();
+        [source trySetCancelled];
+    });
+
+    it(@"returns a cancelled task for cancelled requests", ^{
+        BFTaskCompletionSource *source = [BFTaskCompletionSource taskCompletionSource];
+        __block BOOL cancelled = NO;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.05 * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [source trySetCancelled];
+        });
+        BFTask *task = AGRestRequestSpecsSendInBackground(^BFTask *{
+            return [AGRestRequest _sendSynchronouslyWithTimeout:2 taskBlock:^BFTask *{
+                return source.task;
+            } cancellationBlock:^{
+                cancelled = YES;
+            }];
+        });
+        expect(task.cancelled).to.beTruthy();
+        expect(task.error).to.beNil();
+        expect(cancelled).to.beFalsy();
+    });
+
+    it(@"refuses to send from the main thread", ^{
+        __block BOOL sent = NO;
+        BFTask *task = [AGRestRequest _sendSynchronouslyWithTimeout:1 taskBlock:^BFTask *{
+            sent = YES;
+            return [BFTask taskWithResult:nil];
+        } cancellationBlock:^{}];
+        expect(sent).to.beFalsy();
+        expect(task.error.code).to.equal(kAGErrorOperationForbidden);
+
+        AGRestRequest *request = [AGRestRequest GETRequestWithUrl:@"http://127.0.0.1" endPoint:@"/users" body:nil];
+        expect([request sendRequestWithTimeout:1].error.code).to.equal(kAGErrorOperationForbidden);
+        expect([AGRestRequest sendBatchedRequests:@[request] withTimeout:1].error.code).to.equal(kAGErrorOperationForbidden);
+    });
+});
+
+SpecEnd
@@ -0,0 +1,113 @@
+//
+//  AGRestRequestTemplateSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <AFNetworking/AFURLRequestSerialization.h>
+
+#import <AGRestKit/AGRestRequestTemplate.h>
+#import <AGRestKit/AGRestRequestTemplate_Private.h>
+#import <AGRestKit/AGRestRequest+Format.h>
+
+SpecBegin(AGRestRequestTemplate)
+
+describe(@"template url request", ^{
+
+    __block NSURL *baseURL = nil;
+    __block AFJSONRequestSerializer *serializer = nil;
+
+    // The url request of the regular path, as built by the servers.
+    NSURLRequest *(^regularRequest)(AGRestRequestHTTPMethod, NSString *, NSDictionary *, NSDictionary *) =
+    ^NSURLRequest *(AGRestRequestHTTPMethod method, NSString *endPoint, NSDictionary *headers, NSDictionary *body) {
+        AGRestRequest *request = [AGRestRequest requestWithMethod:method url:baseURL.absoluteString endPoint:endPoint headers:headers body:body];
+        NSString *URLString = [[NSURL URLWithString:endPoint relativeToURL:baseURL] absoluteString];
+        NSMutableURLRequest *urlRequest = [serializer requestWithMethod:request.httpMethodString URLString:URLString parameters:body error:nil];
+        for (NSString *httpHeaderKey in headers) {
+            [urlRequest addValue:headers[httpHeaderKey] forHTTPHeaderField:httpHeaderKey];
+        }
+        return urlRequest;
+    };
+
+    void (^expectSameRequests)(NSURLRequest *, NSURLRequest *) = ^(NSURLRequest *templateRequest, NSURLRequest *request) {
+        expect(templateRequest.HTTPMethod).to.equal(request.HTTPMethod);
+        expect(templateRequest.allHTTPHeaderFields).to.equal(request.allHTTPHeaderFields);
+        if (request.URL.query) {
+            // Same parameters, whatever their order.
+            NSSet *templateItems = [NSSet setWithArray:[NSURLComponents componentsWithURL:templateRequest.URL resolvingAgainstBaseURL:NO].queryItems];
+            NSSet *items = [NSSet setWithArray:[NSURLComponents componentsWithURL:request.URL resolvingAgainstBaseURL:NO].queryItems];
+            expect(templateItems).to.equal(items);
+            expect([templateRequest.URL.absoluteString componentsSeparatedByString:@"?"].firstObject).to.equal([request.URL.absoluteString componentsSeparatedByString:@"?"].firstObject);
+        } else {
+            expect(templateRequest.URL).to.equal(request.URL);
+        }
+        if (request.HTTPBody) {
+            // The servers pretty print, compare the decoded bodies.
+            id templateBody = [NSJSONSerialization JSONObjectWithData:templateRequest.HTTPBody options:0 error:nil];
+            id body = [NSJSONSerialization JSONObjectWithData:request.HTTPBody options:0 error:nil];
+            expect(templateBody).to.equal(body);
+        } else {
+            expect(templateRequest.HTTPBody.length).to.equal(0);
+        }
+    };
+
+    beforeEach(^{
+        baseURL = [NSURL URLWithString:@"https://api.example.com/v1/"];
+        serializer = [AFJSONRequestSerializer serializerWithWritingOptions:NSJSONWritingPrettyPrinted];
+        [serializer setValue:@"token" forHTTPHeaderField:@"X-Session-Token"];
+    });
+
+    it(@"matches the regular request when the template body is spliced", ^{
+        AGRestRequestTemplate *template = [AGRestRequestTemplate templateWithMethod:AGRestRequestMethodHttpPOST
+                                                                           endPoint:@"events"
+                                                                            headers:@{@"X-Client": @"ios"}
+                                                                               body:@{@"platform": @"ios"}];
+        NSURLRequest *templateRequest = [template _URLRequestWithParameters:@{@"name": @"open"} baseURL:baseURL requestSerializer:serializer headersVersion:0 error:nil];
+        expect([templateRequest valueForHTTPHeaderField:@"Content-Type"]).to.equal(@"application/json");
+        expectSameRequests(templateRequest, regularRequest(AGRestRequestMethodHttpPOST, @"events", @{@"X-Client": @"ios"},
+                                                           @{@"platform": @"ios", @"name": @"open"}));
+    });
+
+    it(@"matches the regular request without parameters", ^{
+        AGRestRequestTemplate *template = [AGRestRequestTemplate templateWithMethod:AGRestRequestMethodHttpPOST
+                                                                           endPoint:@"events"
+                                                                            headers:nil
+                                                                               body:@{@"platform": @"ios"}];
+        NSURLRequest *templateRequest = [template _URLRequestWithParameters:nil baseURL:baseURL requestSerializer:serializer headersVersion:0 error:nil];
+        expectSameRequests(templateRequest, regularRequest(AGRestRequestMethodHttpPOST, @"events", nil, @{@"platform": @"ios"}));
+    });
+
+    it(@"matches the regular request when the parameters override the template body", ^{
+        AGRestRequestTemplate *template = [AGRestRequestTemplate templateWithMethod:AGRestRequestMethodHttpPUT
+                                                                           endPoint:@"users/me"
+                                                                            headers:nil
+                                                                               body:@{@"platform": @"ios", @"name": @"none"}];
+        NSURLRequest *templateRequest = [template _URLRequestWithParameters:@{@"name": @"john"} baseURL:baseURL requestSerializer:serializer headersVersion:0 error:nil];
+        expectSameRequests(templateRequest, regularRequest(AGRestRequestMethodHttpPUT, @"users/me", nil,
+                                                           @{@"platform": @"ios", @"name": @"john"}));
+    });
+
+    it(@"matches the regular request when only the parameters make a body", ^{
+        AGRestRequestTemplate *template = [AGRestRequestTemplate templateWithMethod:AGRestRequestMethodHttpPOST
+                                                                           endPoint:@"events"
+                                                                            headers:nil
+                                                                               body:nil];
+        NSURLRequest *templateRequest = [template _URLRequestWithParameters:@{@"name": @"open"} baseURL:baseURL requestSerializer:serializer headersVersion:0 error:nil];
+        expectSameRequests(templateRequest, regularRequest(AGRestRequestMethodHttpPOST, @"events", nil, @{@"name": @"open"}));
+    });
+
+    it(@"matches the regular request with the parameters in the query", ^{
+        AGRestRequestTemplate *template = [AGRestRequestTemplate templateWithMethod:AGRestRequestMethodHttpGET
+                                                                           endPoint:@"users"
+                                                                            headers:@{@"X-Client": @"ios"}
+                                                                               body:@{@"limit": @20}];
+        NSURLRequest *templateRequest = [template _URLRequestWithParameters:@{@"page": @2} baseURL:baseURL requestSerializer:serializer headersVersion:0 error:nil];
+        expect([templateRequest valueForHTTPHeaderField:@"Content-Type"]).to.beNil();
+        expectSameRequests(templateRequest, regularRequest(AGRestRequestMethodHttpGET, @"users", @{@"X-Client": @"ios"},
+                                                           @{@"limit": @20, @"page": @2}));
+    });
+});
+
+SpecEnd
@@ -0,0 +1,108 @@
+//
+//  AGRestResponseSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <libkern/OSAtomic.h>
+
+#import <AGRestKit/AGRestResponse.h>
+#import <AGRestKit/AGRestResponse_Private.h>
+
+SpecBegin(AGRestResponse)
+
+describe(@"lazy decoding", ^{
+
+    __block AGRestResponse *response = nil;
+    __block NSData *body = nil;
+
+    beforeEach(^{
+        body = [@"{\"name\":\"adrien\"}" dataUsingEncoding:NSUTF8StringEncoding];
+        response = [AGRestResponse responseWithData:body
+                                             header:@{@"Content-Type": @"application/json"}
+                                         statusCode:200];
+    });
+
+    it(@"decodes once, when the data is first read", ^{
+        __block NSUInteger decodeCount = 0;
+        [response _setResponseDataDecoder:^id(AGRestResponse *response) {
+            decodeCount++;
+            return @"decoded";
+        }];
+        expect(decodeCount).to.equal(0);
+        expect(response.responseData).to.equal(@"decoded");
+        expect(response.responseData).to.equal(@"decoded");
+        expect(decodeCount).to.equal(1);
+    });
+
+    it(@"gives the raw body to the decoder", ^{
+        __block id rawData = nil;
+        [response _setResponseDataDecoder:^id(AGRestResponse *response) {
+            rawData = response.responseData;
+            return @"decoded";
+        }];
+        expect(response.responseData).to.equal(@"decoded");
+        expect(rawData).to.equal(body);
+    });
+
+    it(@"doesn't hold the response lock while decoding", ^{
+        [response _setResponseDataDecoder:^id(AGRestResponse *response) {
+            __block NSString *contentString = nil;
+            // Would deadlock if the decoder ran with the lock held.
+            dispatch_sync(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                contentString = [response contentString];
+            });
+            return contentString;
+        }];
+        expect(response.responseData).to.equal(@"{\"name\":\"adrien\"}");
+    });
+
+    it(@"makes concurrent readers wait for the decoded data", ^{
+        __block int32_t decodeCount = 0;
+        [response _setResponseDataDecoder:^id(AGRestResponse *response) {
+            OSAtomicIncrement32(&decodeCount);
+            [NSThread sleepForTimeInterval:0.05];
+            return @"decoded";
+        }];
+        NSMutableArray *results = [NSMutableArray array];
+        dispatch_group_t group = dispatch_group_create();
+        for (NSUInteger i = 0; i < 8; i++) {
+            dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                id responseData = response.responseData;
+                @synchronized (results) {
+                    [results addObject:responseData ?: [NSNull null]];
+                }
+            });
+        }
+        expect(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(2 * NSEC_PER_SEC)))).to.equal(0);
+        expect(decodeCount).to.equal(1);
+        expect(results).to.equal(@[@"decoded", @"decoded", @"decoded", @"decoded",
+                                   @"decoded", @"decoded", @"decoded", @"decoded"]);
+    });
+
+    it(@"drops the pending decoder when the data is set", ^{
+        __block BOOL decoded = NO;
+        [response _setResponseDataDecoder:^id(AGRestResponse *response) {
+            decoded = YES;
+            return @"decoded";
+        }];
+        response.responseData = @"set";
+        expect(response.responseData).to.equal(@"set");
+        expect(decoded).to.beFalsy();
+    });
+
+    it(@"decodes before reporting the status", ^{
+        [response _setResponseDataDecoder:^id(AGRestResponse *response) {
+            expect(response.responseError).to.beNil();
+            response.responseError = [NSError errorWithDomain:@"AGRestResponseSpecs" code:1 userInfo:nil];
+            return nil;
+        }];
+        expect(response.succeeded).to.beFalsy();
+        expect(response.responseError.code).to.equal(1);
+        expect(response.responseData).to.beNil();
+    });
+});
+
+SpecEnd
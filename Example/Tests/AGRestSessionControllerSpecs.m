@@ -0,0 +1,166 @@
+//
+//  AGRestSessionControllerSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 13/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Bolts/Bolts.h>
+
+#import <AGRestKit/AGRestSessionController.h>
+#import <AGRestKit/AGRestRequest.h>
+#import <AGRestKit/AGRestResponse.h>
+
+#pragma mark - Refresh request
+#pragma mark -
+
+// Answered by the spec instead of being sent.
+@interface AGRestSessionControllerSpecsRequest : AGRestRequest
+
+@property (nonatomic, strong) BFTaskCompletionSource *completionSource;
+@property (nonatomic, assign) NSUInteger sendCount;
+
+@end
+
+@implementation AGRestSessionControllerSpecsRequest
+
+- (BFTask *)sendRequestInBackground {
+    self.sendCount++;
+    return self.completionSource.task;
+}
+
+@end
+
+#pragma mark - Data source
+#pragma mark -
+
+// Stands for the session store, the server and the manager providing them.
+@interface AGRestSessionControllerSpecsDataSource : NSObject
+
+@property (nonatomic, copy) NSString *sessionToken;
+@property (nonatomic, copy) NSString *headerValue;
+
+@end
+
+@implementation AGRestSessionControllerSpecsDataSource
+
+- (id)sessionStore {
+    return self;
+}
+
+- (id)requestServer {
+    return self;
+}
+
+- (NSString *)sessionTokenWithIdentifier:(NSString * __autoreleasing *)identifier {
+    if (identifier) {
+        *identifier = @"user";
+    }
+    return self.sessionToken;
+}
+
+- (BOOL)storeSessionToken:(NSString *)token forIdentifier:(NSString *)identifier error:(NSError * __autoreleasing *)error {
+    self.sessionToken = token;
+    return YES;
+}
+
+- (void)setValue:(NSString *)value forHTTPHeaderField:(NSString *)field {
+    self.headerValue = value;
+}
+
+@end
+
+#pragma mark - Specs
+#pragma mark -
+
+SpecBegin(AGRestSessionController)
+
+describe(@"session refresh", ^{
+
+    __block AGRestSessionControllerSpecsDataSource *dataSource = nil;
+    __block AGRestSessionControllerSpecsRequest *refreshRequest = nil;
+    __block AGRestSessionController *controller = nil;
+
+    beforeEach(^{
+        dataSource = [[AGRestSessionControllerSpecsDataSource alloc] init];
+        dataSource.sessionToken = @"expired";
+        refreshRequest = [[AGRestSessionControllerSpecsRequest alloc] init];
+        refreshRequest.completionSource = [BFTaskCompletionSource taskCompletionSource];
+        controller = [[AGRestSessionController alloc] initWithDataSource:(id)dataSource withBaseUrl:@"http://127.0.0.1"];
+        controller.sessionRefreshRequestBlock = ^AGRestRequest *(NSString *expiredSessionToken) {
+            return refreshRequest;
+        };
+    });
+
+    it(@"sends a single refresh for concurrent callers", ^{
+        NSMutableArray *tasks = [NSMutableArray array];
+        for (NSUInteger i = 0; i < 5; i++) {
+            [tasks addObject:[controller refreshSessionAsyncWithExpiredSessionToken:@"expired"]];
+        }
+        expect(refreshRequest.sendCount).to.equal(1);
+        expect(controller.sessionRefreshTask).toNot.beNil();
+
+        NSData *body = [@"{\"authorization\":\"fresh\"}" dataUsingEncoding:NSUTF8StringEncoding];
+        [refreshRequest.completionSource setResult:[AGRestResponse responseWithData:body
+                                                                              header:@{@"Content-Type": @"application/json"}
+                                                                          statusCode:200]];
+        __block BFTask *result = nil;
+        waitUntil(^(DoneCallback done) {
+            [[BFTask taskForCompletionOfAllTasksWithResults:tasks] continueWithBlock:^id(BFTask *task) {
+                result = task;
+                done();
+                return nil;
+            }];
+        });
+        expect(result.result).to.equal(@[@"fresh", @"fresh", @"fresh", @"fresh", @"fresh"]);
+        expect(dataSource.sessionToken).to.equal(@"fresh");
+        expect(dataSource.headerValue).to.equal(@"fresh");
+        expect(controller.sessionRefreshTask).to.beNil();
+    });
+
+    it(@"takes the token from the response header first", ^{
+        BFTask *task = [controller refreshSessionAsyncWithExpiredSessionToken:@"expired"];
+        [refreshRequest.completionSource setResult:[AGRestResponse responseWithData:nil
+                                                                              header:@{@"Authorization": @"fresh"}
+                                                                          statusCode:200]];
+        waitUntil(^(DoneCallback done) {
+            [task continueWithBlock:^id(BFTask *task) {
+                done();
+                return nil;
+            }];
+        });
+        expect(task.result).to.equal(@"fresh");
+    });
+
+    it(@"doesn't refresh a session already refreshed", ^{
+        dataSource.sessionToken = @"fresh";
+        BFTask *task = [controller refreshSessionAsyncWithExpiredSessionToken:@"expired"];
+        expect(task.result).to.equal(@"fresh");
+        expect(refreshRequest.sendCount).to.equal(0);
+    });
+
+    it(@"fails every caller when no token comes back, and allows a new refresh", ^{
+        BFTask *firstTask = [controller refreshSessionAsyncWithExpiredSessionToken:@"expired"];
+        BFTask *secondTask = [controller refreshSessionAsyncWithExpiredSessionToken:@"expired"];
+        [refreshRequest.completionSource setResult:[AGRestResponse responseWithData:[@"{}" dataUsingEncoding:NSUTF8StringEncoding]
+                                                                              header:@{@"Content-Type": @"application/json"}
+                                                                          statusCode:200]];
+        waitUntil(^(DoneCallback done) {
+            [[BFTask taskForCompletionOfAllTasks:@[firstTask, secondTask]] continueWithBlock:^id(BFTask *task) {
+                done();
+                return nil;
+            }];
+        });
+        expect(firstTask.error).toNot.beNil();
+        expect(secondTask.error).toNot.beNil();
+        expect(dataSource.sessionToken).to.equal(@"expired");
+
+        refreshRequest.completionSource = [BFTaskCompletionSource taskCompletionSource];
+        [controller refreshSessionAsyncWithExpiredSessionToken:@"expired"];
+        expect(refreshRequest.sendCount).to.equal(2);
+        [refreshRequest.completionSource trySetCancelled];
+    });
+});
+
+SpecEnd
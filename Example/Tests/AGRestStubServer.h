@@ -0,0 +1,50 @@
+//
+//  AGRestStubServer.h
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 03/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class AGRestStubServer
+
+ @discussion Minimal HTTP/1.1 server bound to the loopback interface, answering every request with a canned
+ JSON payload chosen by path. Connections are kept alive, so it measures the client and not the handshakes.
+ */
+@interface AGRestStubServer : NSObject
+
+/*!
+ @abstract Port the server listens to, once started.
+ */
+@property (nonatomic, assign, readonly) uint16_t port;
+/*!
+ @abstract "http://127.0.0.1:<port>", once started.
+ */
+@property (nonatomic, copy, readonly, nullable) NSString *baseUrl;
+/*!
+ @abstract Number of requests answered since the server started.
+ */
+@property (atomic, assign, readonly) NSUInteger requestCount;
+
+/*!
+ @abstract Creates a server answering requests to each path with its payload, and 404 to any other path.
+ @param payloads    Response bodies keyed by path (e.g. "/payload/small"), query strings are ignored.
+ */
+- (instancetype)initWithPayloads:(NSDictionary<NSString *, NSData *> *)payloads;
+
+- (BOOL)start:(NSError * _Nullable __autoreleasing * _Nullable)error;
+- (void)stop;
+
+/*!
+ @return A JSON object with `count` items, used as canned payload.
+ */
++ (NSData *)JSONPayloadWithItemCount:(NSUInteger)count;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,277 @@
+//
+//  AGRestStubServer.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 03/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+#import "AGRestStubServer.h"
+
+#import <arpa/inet.h>
+#import <netinet/in.h>
+#import <netinet/tcp.h>
+#import <sys/socket.h>
+
+static NSData *_AGRestStubServerHeaderTerminator = nil;
+
+@interface _AGRestStubConnection : NSObject
+
+@property (nonatomic, strong) dispatch_source_t readSource;
+@property (nonatomic, strong) NSMutableData     *buffer;
+
+@end
+
+@implementation _AGRestStubConnection
+@end
+
+@interface AGRestStubServer() {
+    int                 _listenSocket;
+    dispatch_queue_t    _queue;
+    dispatch_source_t   _acceptSource;
+    NSMutableSet        *_connections;
+    NSDictionary        *_payloads;
+}
+
+@property (nonatomic, assign, readwrite) uint16_t port;
+@property (nonatomic, copy, readwrite) NSString *baseUrl;
+@property (atomic, assign, readwrite) NSUInteger requestCount;
+
+@end
+
+@implementation AGRestStubServer
+
++ (void)initialize {
+    if (self == [AGRestStubServer class]) {
+        _AGRestStubServerHeaderTerminator = [@"\r\n\r\n" dataUsingEncoding:NSASCIIStringEncoding];
+    }
+}
+
+- (instancetype)initWithPayloads:(NSDictionary<NSString *, NSData *> *)payloads {
+    self = [super init];
+    if (!self) return nil;
+
+    _listenSocket = -1;
+    _payloads = [payloads copy];
+    _connections = [NSMutableSet set];
+    _queue = dispatch_queue_create("com.AGRest.tests.stubServer", DISPATCH_QUEUE_SERIAL);
+
+    return self;
+}
+
+- (void)dealloc {
+    [self stop];
+}
+
+#pragma mark - Lifecycle
+#pragma mark -
+
+- (BOOL)start:(NSError * _Nullable __autoreleasing *)error {
+    int listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listenSocket < 0) {
+        return [self _failWithErrno:error];
+    }
+
+    int yes = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_len = sizeof(address);
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0; // Any free port.
+
+    socklen_t addressLength = sizeof(address);
+    if (bind(listenSocket, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+        listen(listenSocket, 128) != 0 ||
+        getsockname(listenSocket, (struct sockaddr *)&address, &addressLength) != 0) {
+        close(listenSocket);
+        return [self _failWithErrno:error];
+    }
+
+    _listenSocket = listenSocket;
+    self.port = ntohs(address.sin_port);
+    self.baseUrl = [NSString stringWithFormat:@"http://127.0.0.1:%u", self.port];
+
+    _acceptSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, (uintptr_t)listenSocket, 0, _queue);
+    __weak typeof(self) weakSelf = self;
+    dispatch_source_set_event_handler(_acceptSource, ^{
+        [weakSelf _acceptConnection];
+    });
+    dispatch_source_set_cancel_handler(_acceptSource, ^{
+        close(listenSocket);
+    });
+    dispatch_resume(_acceptSource);
+
+    return YES;
+}
+
+- (void)stop {
+    dispatch_sync(_queue, ^{
+        if (_acceptSource) {
+            dispatch_source_cancel(_acceptSource);
+            _acceptSource = nil;
+        }
+        for (_AGRestStubConnection *connection in _connections) {
+            dispatch_source_cancel(connection.readSource);
+        }
+        [_connections removeAllObjects];
+        _listenSocket = -1;
+    });
+}
+
+#pragma mark - Connections
+#pragma mark -
+
+- (void)_acceptConnection {
+    int clientSocket = accept(_listenSocket, NULL, NULL);
+    if (clientSocket < 0) {
+        return;
+    }
+
+    int yes = 1;
+    setsockopt(clientSocket, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes));
+    setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+    // Each connection gets its own queue so that a large response doesn't hold the other ones.
+    dispatch_queue_t connectionQueue = dispatch_queue_create("com.AGRest.tests.stubServer.connection", DISPATCH_QUEUE_SERIAL);
+    _AGRestStubConnection *connection = [[_AGRestStubConnection alloc] init];
+    connection.buffer = [NSMutableData data];
+    connection.readSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, (uintptr_t)clientSocket, 0, connectionQueue);
+
+    __weak typeof(self) weakSelf = self;
+    __weak _AGRestStubConnection *weakConnection = connection;
+    dispatch_source_set_event_handler(connection.readSource, ^{
+        [weakSelf _readFromConnection:weakConnection socket:clientSocket];
+    });
+    dispatch_source_set_cancel_handler(connection.readSource, ^{
+        close(clientSocket);
+    });
+
+    [_connections addObject:connection];
+    dispatch_resume(connection.readSource);
+}
+
+- (void)_readFromConnection:(_AGRestStubConnection *)connection socket:(int)clientSocket {
+    if (!connection) {
+        return;
+    }
+
+    uint8_t bytes[16 * 1024];
+    ssize_t length = read(clientSocket, bytes, sizeof(bytes));
+    if (length <= 0) {
+        [self _closeConnection:connection];
+        return;
+    }
+    [connection.buffer appendBytes:bytes length:(NSUInteger)length];
+
+    // Answer every complete request of the buffer, the client may pipeline them.
+    NSData *response = nil;
+    while ((response = [self _responseForNextRequestInBuffer:connection.buffer])) {
+        if (![self _writeData:response toSocket:clientSocket]) {
+            [self _closeConnection:connection];
+            return;
+        }
+        self.requestCount++;
+    }
+}
+
+- (void)_closeConnection:(_AGRestStubConnection *)connection {
+    dispatch_source_cancel(connection.readSource);
+    dispatch_async(_queue, ^{
+        [_connections removeObject:connection];
+    });
+}
+
+- (BOOL)_writeData:(NSData *)data toSocket:(int)clientSocket {
+    const uint8_t *bytes = data.bytes;
+    NSUInteger remaining = data.length;
+    while (remaining > 0) {
+        ssize_t written = write(clientSocket, bytes, remaining);
+        if (written < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            return NO;
+        }
+        bytes += written;
+        remaining -= (NSUInteger)written;
+    }
+    return YES;
+}
+
+#pragma mark - HTTP
+#pragma mark -
+
+- (NSData *)_responseForNextRequestInBuffer:(NSMutableData *)buffer {
+    NSRange terminator = [buffer rangeOfData:_AGRestStubServerHeaderTerminator options:0 range:NSMakeRange(0, buffer.length)];
+    if (terminator.location == NSNotFound) {
+        return nil;
+    }
+
+    NSUInteger headerLength = NSMaxRange(terminator);
+    NSString *header = [[NSString alloc] initWithBytes:buffer.bytes length:terminator.location encoding:NSASCIIStringEncoding];
+    NSArray *lines = [header componentsSeparatedByString:@"\r\n"];
+
+    NSUInteger contentLength = 0;
+    for (NSString *line in lines) {
+        if ([line.lowercaseString hasPrefix:@"content-length:"]) {
+            contentLength = (NSUInteger)[[line substringFromIndex:15] integerValue];
+        }
+    }
+    if (buffer.length < headerLength + contentLength) {
+        return nil; // Wait for the rest of the body.
+    }
+    [buffer replaceBytesInRange:NSMakeRange(0, headerLength + contentLength) withBytes:NULL length:0];
+
+    // Request line : "<METHOD> <path>[?query] HTTP/1.1"
+    NSArray *requestLine = [lines.firstObject componentsSeparatedByString:@" "];
+    NSString *path = (requestLine.count > 1) ? [requestLine[1] componentsSeparatedByString:@"?"].firstObject : @"/";
+
+    NSData *payload = _payloads[path];
+    NSString *status = payload ? @"200 OK" : @"404 Not Found";
+    if (!payload) {
+        payload = [@"{}" dataUsingEncoding:NSUTF8StringEncoding];
+    }
+
+    NSString *responseHeader = [NSString stringWithFormat:@"HTTP/1.1 %@\r\n"
+                                                          @"Content-Type: application/json\r\n"
+                                                          @"Content-Length: %lu\r\n"
+                                                          @"Connection: keep-alive\r\n"
+                                                          @"\r\n", status, (unsigned long)payload.length];
+    NSMutableData *response = [[responseHeader dataUsingEncoding:NSASCIIStringEncoding] mutableCopy];
+    [response appendData:payload];
+    return response;
+}
+
+#pragma mark - Payloads
+#pragma mark -
+
++ (NSData *)JSONPayloadWithItemCount:(NSUInteger)count {
+    NSMutableArray *items = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [items addObject:@{@"identifier": @(i),
+                           @"name": [NSString stringWithFormat:@"Item %lu", (unsigned long)i],
+                           @"price": @(i * 1.25),
+                           @"available": @(i % 2 == 0),
+                           @"tags": @[@"benchmark", @"stub", @"json"]}];
+    }
+    NSDictionary *object = @{@"identifier": @(count),
+                             @"name": @"Benchmark payload",
+                             @"itemCount": @(count),
+                             @"items": items};
+    return [NSJSONSerialization dataWithJSONObject:object options:0 error:nil];
+}
+
+#pragma mark - Private
+#pragma mark -
+
+- (BOOL)_failWithErrno:(NSError * _Nullable __autoreleasing *)error {
+    if (error) {
+        *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+    }
+    return NO;
+}
+
+@end
@@ -0,0 +1,508 @@
+//
+//  BenchmarkSpecs.m
+//  AGRestKit
+//
+//  Created by Adrien Greiner on 03/11/2015.
+//  Copyright © 2015 The Social Superstore Ltd. All rights reserved.
+//
+
+// Benchmarks of the request pipeline against a loopback stub server.
+// They only run when the AGREST_BENCHMARK environment variable is set on the test scheme,
+// and write their results to AGREST_BENCHMARK_OUTPUT when it is set too.
+
+#import <Bolts/Bolts.h>
+#import <libkern/OSAtomic.h>
+
+#import <AGRestKit/AGRest.h>
+#import <AGRestKit/AGRest_Private.h>
+#import <AGRestKit/AGRestManager.h>
+#import <AGRestKit/AGRestEventuallyQueue.h>
+#import <AGRestKit/AGRestRequestTemplate.h>
+#import <AGRestKit/AGRestObjectMapping.h>
+#import <AGRestKit/AGRestObjectMapperProtocol.h>
+#import <AGRestKit/AGRestResponseSerializer.h>
+#import <AGRestKit/AGRestServerProtocol.h>
+#import <AGRestKit/AGRestMetricsCollecting.h>
+#import <AGRestKit/AGRestCircuitBreaker.h>
+
+#import "AGRestStubServer.h"
+#import "AGRestLoopbackServer.h"
+#import "AGRestBenchmark.h"
+
+static NSUInteger const AGRestBenchmarkIterations = 500;
+static NSUInteger const AGRestBenchmarkBatchSize = 10;
+static NSUInteger const AGRestBenchmarkModuleReads = 1000;
+static NSUInteger const AGRestBenchmarkLoopbackIterations = 20000;
+
+@interface AGRestBenchmarkPayload : NSObject <AGRestObjectMapping>
+
+@property (nonatomic, strong) NSNumber  *identifier;
+@property (nonatomic, copy) NSString    *name;
+@property (nonatomic, strong) NSNumber  *itemCount;
+@property (nonatomic, strong) NSArray   *items;
+
+@end
+
+@implementation AGRestBenchmarkPayload
+
++ (NSString *)classURI {
+    return @"benchmark.payload";
+}
+
+@end
+
+// Turns responses with an error into faulted tasks, so that the benchmark counts them as failures.
+static BFTask *AGRestBenchmarkCheckResponse(BFTask *task) {
+    return [task continueWithSuccessBlock:^id(BFTask *task) {
+        NSArray *responses = [task.result isKindOfClass:[NSArray class]] ? task.result : (task.result ? @[task.result] : @[]);
+        for (AGRestResponse *response in responses) {
+            if (response.responseError) {
+                return [BFTask taskWithError:response.responseError];
+            }
+        }
+        return task;
+    }];
+}
+
+// Responses are decoded when their data is first read, like a caller using the mapped object would.
+static BFTask *AGRestBenchmarkReadResponseData(BFTask *task) {
+    return [task continueWithSuccessBlock:^id(BFTask *task) {
+        AGRestResponse *response = task.result;
+        if (![response.responseData isKindOfClass:[AGRestBenchmarkPayload class]]) {
+            return [BFTask taskWithError:[NSError errorWithDomain:AGRestErrorDomain code:kAGErrorInternalLocal userInfo:nil]];
+        }
+        return task;
+    }];
+}
+
+// Body of a typical event, the same for every request but its sequence number.
+static NSDictionary *AGRestBenchmarkEventBody(void) {
+    return @{@"platform": @"ios",
+             @"osVersion": @"9.1",
+             @"appVersion": @"2.4.0",
+             @"build": @"2410",
+             @"locale": @"en_GB",
+             @"timezone": @"Europe/London",
+             @"device": @{@"model": @"iPhone8,1", @"screen": @[@750, @1334]},
+             @"tags": @[@"benchmark", @"stub", @"template"]};
+}
+
+static AGRestRequest *AGRestBenchmarkRequest(NSString *baseUrl, NSString *endPoint, BOOL objectMapping) {
+    AGRestRequest *request = [AGRestRequest GETRequestWithUrl:baseUrl endPoint:endPoint body:nil];
+    request.cachePolicy = kAGRestRequestIgnoreCache;
+    request.objectMappingEnabled = objectMapping;
+    return request;
+}
+
+// Specs run on the main thread, which the benchmark must not block.
+static AGRestBenchmarkResult *AGRestBenchmarkRunInBackground(AGRestBenchmarkResult *(^benchmark)(void)) {
+    __block AGRestBenchmarkResult *result = nil;
+    waitUntilTimeout(600, ^(DoneCallback done) {
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            result = benchmark();
+            dispatch_async(dispatch_get_main_queue(), ^{
+                done();
+            });
+        });
+    });
+    return result;
+}
+
+SpecBegin(Benchmarks)
+
+if ([NSProcessInfo processInfo].environment[@"AGREST_BENCHMARK"]) {
+
+describe(@"request pipeline", ^{
+
+    __block AGRestStubServer *server = nil;
+    __block NSString *baseUrl = nil;
+
+    beforeAll(^{
+        server = [[AGRestStubServer alloc] initWithPayloads:@{@"/payload/empty": [NSData dataWithBytes:"{}" length:2],
+                                                              @"/payload/small": [AGRestStubServer JSONPayloadWithItemCount:10],
+                                                              @"/payload/large": [AGRestStubServer JSONPayloadWithItemCount:1000]}];
+        NSError *error = nil;
+        expect([server start:&error]).to.beTruthy();
+        baseUrl = server.baseUrl;
+
+        [AGRest initializeRestWithBaseUrl:baseUrl];
+        [AGRest setLoggingEnable:NO level:AGRestLoggingLevelNone];
+        [AGRest registerSubclass:[AGRestBenchmarkPayload class]];
+    });
+
+    afterAll(^{
+        [AGRestBenchmark writeResults];
+        [server stop];
+    });
+
+    it(@"sends single requests one at a time", ^{
+        AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+            return [AGRestBenchmark runBenchmarkNamed:@"single, sequential"
+                                           iterations:AGRestBenchmarkIterations
+                                          concurrency:1
+                                 requestsPerIteration:1
+                                                block:^BFTask *(NSUInteger index) {
+                return AGRestBenchmarkCheckResponse([AGRestBenchmarkRequest(baseUrl, @"payload/empty", NO) sendRequestInBackground]);
+            }];
+        });
+        expect(result.failures).to.equal(0);
+    });
+
+    it(@"sends single requests concurrently", ^{
+        AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+            return [AGRestBenchmark runBenchmarkNamed:@"single, 16 in flight"
+                                           iterations:AGRestBenchmarkIterations
+                                          concurrency:16
+                                 requestsPerIteration:1
+                                                block:^BFTask *(NSUInteger index) {
+                return AGRestBenchmarkCheckResponse([AGRestBenchmarkRequest(baseUrl, @"payload/empty", NO) sendRequestInBackground]);
+            }];
+        });
+        expect(result.failures).to.equal(0);
+    });
+
+    it(@"sends regular POST requests", ^{
+        AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+            return [AGRestBenchmark runBenchmarkNamed:@"POST, regular"
+                                           iterations:AGRestBenchmarkIterations
+                                          concurrency:1
+                                 requestsPerIteration:1
+                                                block:^BFTask *(NSUInteger index) {
+                NSMutableDictionary *body = [AGRestBenchmarkEventBody() mutableCopy];
+                body[@"sequence"] = @(index);
+                AGRestRequest *request = [AGRestRequest POSTRequestWithUrl:baseUrl endPoint:@"payload/empty" body:body];
+                request.cachePolicy = kAGRestRequestIgnoreCache;
+                request.objectMappingEnabled = NO;
+                return AGRestBenchmarkCheckResponse([request sendRequestInBackground]);
+            }];
+        });
+        expect(result.failures).to.equal(0);
+    });
+
+    it(@"sends templated POST requests", ^{
+        AGRestRequestTemplate *template = [AGRestRequestTemplate templateWithMethod:AGRestRequestMethodHttpPOST
+                                                                           endPoint:@"payload/empty"
+                                                                            headers:nil
+                                                                               body:AGRestBenchmarkEventBody()];
+        AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+            return [AGRestBenchmark runBenchmarkNamed:@"POST, template"
+                                           iterations:AGRestBenchmarkIterations
+                                          concurrency:1
+                                 requestsPerIteration:1
+                                                block:^BFTask *(NSUInteger index) {
+                AGRestRequest *request = [template requestWithParameters:@{@"sequence": @(index)}];
+                request.cachePolicy = kAGRestRequestIgnoreCache;
+                request.objectMappingEnabled = NO;
+                return AGRestBenchmarkCheckResponse([request sendRequestInBackground]);
+            }];
+        });
+        expect(result.failures).to.equal(0);
+    });
+
+    it(@"sends batched requests", ^{
+        AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+            return [AGRestBenchmark runBenchmarkNamed:@"batched, 10 per batch"
+                                           iterations:AGRestBenchmarkIterations / AGRestBenchmarkBatchSize
+                                          concurrency:1
+                                 requestsPerIteration:AGRestBenchmarkBatchSize
+                                                block:^BFTask *(NSUInteger index) {
+                NSMutableArray *requests = [NSMutableArray arrayWithCapacity:AGRestBenchmarkBatchSize];
+                for (NSUInteger i = 0; i < AGRestBenchmarkBatchSize; i++) {
+                    [requests addObject:AGRestBenchmarkRequest(baseUrl, @"payload/empty", NO)];
+                }
+                return AGRestBenchmarkCheckResponse([AGRestRequest sendBatchedRequestsInBackground:requests]);
+            }];
+        });
+        expect(result.failures).to.equal(0);
+    });
+
+    it(@"sends cached requests", ^{
+        AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+            return [AGRestBenchmark runBenchmarkNamed:@"cached, network else cache"
+                                           iterations:AGRestBenchmarkIterations
+                                          concurrency:1
+                                 requestsPerIteration:1
+                                                block:^BFTask *(NSUInteger index) {
+                AGRestRequest *request = AGRestBenchmarkRequest(baseUrl, @"payload/small", NO);
+                request.cachePolicy = kAGRestRequestNetworkElseCache;
+                return AGRestBenchmarkCheckResponse([request sendRequestInBackground]);
+            }];
+        });
+        expect(result.failures).to.equal(0);
+    });
+
+    it(@"sends eventually queued requests", ^{
+        AGRestEventuallyQueue *eventuallyQueue = [AGRest _currentManager].eventuallyQueue;
+        // Reachability of the loopback interface isn't reported, run the queue right away.
+        [eventuallyQueue setValue:@YES forKey:@"connected"];
+
+        AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+            return [AGRestBenchmark runBenchmarkNamed:@"eventually queued"
+                                           iterations:AGRestBenchmarkIterations / 5
+                                          concurrency:1
+                                 requestsPerIteration:1
+                                                block:^BFTask *(NSUInteger index) {
+                AGRestRequest *request = AGRestBenchmarkRequest(baseUrl, @"payload/empty", NO);
+                return AGRestBenchmarkCheckResponse([eventuallyQueue enqueueRequestInBackground:request]);
+            }];
+        });
+        expect(result.failures).to.equal(0);
+    });
+
+    describe(@"module access", ^{
+
+        // The modules read by every request : runner, server, serializer, object mapper, logger and metrics.
+        __block AGRestManager *manager = nil;
+        __block id module = nil;
+
+        beforeAll(^{
+            manager = [AGRest _currentManager];
+        });
+
+        it(@"reads modules without locking", ^{
+            AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+                return [AGRestBenchmark runBenchmarkNamed:@"module access, lock-free"
+                                               iterations:AGRestBenchmarkIterations
+                                              concurrency:1
+                                     requestsPerIteration:AGRestBenchmarkModuleReads * 6
+                                                    block:^BFTask *(NSUInteger index) {
+                    for (NSUInteger i = 0; i < AGRestBenchmarkModuleReads; i++) {
+                        module = manager.requestRunner;
+                        module = manager.requestServer;
+                        module = manager.responseSerializer;
+                        module = manager.objectMapper;
+                        module = manager.logger;
+                        module = manager.metrics;
+                    }
+                    return [BFTask taskWithResult:module];
+                }];
+            });
+            expect(result.failures).to.equal(0);
+        });
+
+        // Cost of the serial access queues the accessors synchronized on before, for comparison.
+        it(@"reads modules through serial queues", ^{
+            NSMutableArray *accessQueues = [NSMutableArray arrayWithCapacity:6];
+            for (NSUInteger i = 0; i < 6; i++) {
+                [accessQueues addObject:dispatch_queue_create("com.AGRest.tests.benchmark.accessQueue", DISPATCH_QUEUE_SERIAL)];
+            }
+            AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+                return [AGRestBenchmark runBenchmarkNamed:@"module access, dispatch_sync"
+                                               iterations:AGRestBenchmarkIterations
+                                              concurrency:1
+                                     requestsPerIteration:AGRestBenchmarkModuleReads * 6
+                                                    block:^BFTask *(NSUInteger index) {
+                    for (NSUInteger i = 0; i < AGRestBenchmarkModuleReads; i++) {
+                        dispatch_sync(accessQueues[0], ^{ module = manager.requestRunner; });
+                        dispatch_sync(accessQueues[1], ^{ module = manager.requestServer; });
+                        dispatch_sync(accessQueues[2], ^{ module = manager.responseSerializer; });
+                        dispatch_sync(accessQueues[3], ^{ module = manager.objectMapper; });
+                        dispatch_sync(accessQueues[4], ^{ module = manager.logger; });
+                        dispatch_sync(accessQueues[5], ^{ module = manager.metrics; });
+                    }
+                    return [BFTask taskWithResult:module];
+                }];
+            });
+            expect(result.failures).to.equal(0);
+        });
+    });
+
+    describe(@"object mapping", ^{
+
+        beforeAll(^{
+            AGRestResponseSerializer *responseSerializer = (AGRestResponseSerializer *)[AGRest responseSerializer];
+            responseSerializer.objectFromResponseSerializeBlock = ^id<AGRestObjectMapping>(AGRestResponse *response) {
+                NSDictionary *source = [NSJSONSerialization JSONObjectWithData:response.responseData options:0 error:nil];
+                return [[AGRest _currentManager].objectMapper objectFromSource:source
+                                                             toInstanceOfClass:response.targetClass
+                                                                         error:nil];
+            };
+        });
+
+        afterAll(^{
+            ((AGRestResponseSerializer *)[AGRest responseSerializer]).objectFromResponseSerializeBlock = nil;
+        });
+
+        it(@"maps small payloads", ^{
+            AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+                return [AGRestBenchmark runBenchmarkNamed:@"mapping, 10 items"
+                                               iterations:AGRestBenchmarkIterations
+                                              concurrency:1
+                                     requestsPerIteration:1
+                                                    block:^BFTask *(NSUInteger index) {
+                    AGRestRequest *request = AGRestBenchmarkRequest(baseUrl, @"payload/small", YES);
+                    request.targetClass = [AGRestBenchmarkPayload class];
+                    return AGRestBenchmarkReadResponseData(AGRestBenchmarkCheckResponse([request sendRequestInBackground]));
+                }];
+            });
+            expect(result.failures).to.equal(0);
+        });
+
+        it(@"maps large payloads", ^{
+            AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+                return [AGRestBenchmark runBenchmarkNamed:@"mapping, 1000 items"
+                                               iterations:AGRestBenchmarkIterations / 5
+                                              concurrency:1
+                                     requestsPerIteration:1
+                                                    block:^BFTask *(NSUInteger index) {
+                    AGRestRequest *request = AGRestBenchmarkRequest(baseUrl, @"payload/large", YES);
+                    request.targetClass = [AGRestBenchmarkPayload class];
+                    return AGRestBenchmarkReadResponseData(AGRestBenchmarkCheckResponse([request sendRequestInBackground]));
+                }];
+            });
+            expect(result.failures).to.equal(0);
+        });
+    });
+
+    describe(@"loopback transport", ^{
+
+        // The same payloads answered in-process, so that only the pipeline is measured, faults included.
+        __block AGRestLoopbackServer *loopbackServer = nil;
+        __block id<AGRestServerProtocol> networkServer = nil;
+
+        beforeAll(^{
+            loopbackServer = [[AGRestLoopbackServer alloc] initWithPayloads:@{@"/payload/empty": [NSData dataWithBytes:"{}" length:2],
+                                                                              @"/payload/small": [AGRestStubServer JSONPayloadWithItemCount:10]}];
+            networkServer = [AGRest serverInstance];
+            [AGRest setServerInstance:loopbackServer];
+            // Retry right away, the delay would only measure the timer.
+            [(NSObject *)[AGRest _currentManager].requestRunner setValue:@0 forKey:@"initialRetryDelay"];
+        });
+
+        afterAll(^{
+            [(NSObject *)[AGRest _currentManager].requestRunner setValue:@2 forKey:@"initialRetryDelay"];
+            [AGRest setServerInstance:networkServer];
+        });
+
+        beforeEach(^{
+            [loopbackServer reset];
+            loopbackServer.latencyDistribution = AGRestLoopbackLatencyConstant;
+            loopbackServer.latency = 0;
+            loopbackServer.errorRate = 0;
+            loopbackServer.timeoutRate = 0;
+        });
+
+        it(@"sends requests without network", ^{
+            AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+                return [AGRestBenchmark runBenchmarkNamed:@"loopback, 64 in flight"
+                                               iterations:AGRestBenchmarkLoopbackIterations
+                                              concurrency:64
+                                     requestsPerIteration:1
+                                                    block:^BFTask *(NSUInteger index) {
+                    return AGRestBenchmarkCheckResponse([AGRestBenchmarkRequest(baseUrl, @"payload/empty", NO) sendRequestInBackground]);
+                }];
+            });
+            expect(result.failures).to.equal(0);
+        });
+
+        it(@"retries timed out requests", ^{
+            loopbackServer.timeoutRate = 0.2;
+            loopbackServer.timeoutInterval = 0.001;
+            AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+                return [AGRestBenchmark runBenchmarkNamed:@"loopback, 20% timeouts retried"
+                                               iterations:AGRestBenchmarkLoopbackIterations / 10
+                                              concurrency:64
+                                     requestsPerIteration:1
+                                                    block:^BFTask *(NSUInteger index) {
+                    AGRestRequest *request = AGRestBenchmarkRequest(baseUrl, @"payload/empty", NO);
+                    request.timeoutPolicy = kAGRestRequestTimeoutRetry;
+                    request.retryCount = 4;
+                    return AGRestBenchmarkCheckResponse([request sendRequestInBackground]);
+                }];
+            });
+            // Only requests timing out on each of their attempts fail.
+            expect(result.failures).to.beLessThan(AGRestBenchmarkLoopbackIterations / 100);
+        });
+
+        it(@"drains the eventually queue", ^{
+            AGRestEventuallyQueue *eventuallyQueue = [AGRest _currentManager].eventuallyQueue;
+            [eventuallyQueue setValue:@YES forKey:@"connected"];
+            loopbackServer.latencyDistribution = AGRestLoopbackLatencyLogNormal;
+            loopbackServer.latency = 0.002;
+            loopbackServer.latencyDeviation = 0.5;
+
+            AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+                return [AGRestBenchmark runBenchmarkNamed:@"loopback, eventually queued"
+                                               iterations:AGRestBenchmarkIterations
+                                              concurrency:32
+                                     requestsPerIteration:1
+                                                    block:^BFTask *(NSUInteger index) {
+                    AGRestRequest *request = AGRestBenchmarkRequest(baseUrl, @"payload/empty", NO);
+                    return AGRestBenchmarkCheckResponse([eventuallyQueue enqueueRequestInBackground:request]);
+                }];
+            });
+            expect(result.failures).to.equal(0);
+        });
+
+        it(@"falls back to the cache", ^{
+            // Cache the response before the faults start.
+            AGRestRequest *request = AGRestBenchmarkRequest(baseUrl, @"payload/small", NO);
+            request.cachePolicy = kAGRestRequestNetworkElseCache;
+            waitUntil(^(DoneCallback done) {
+                [[request sendRequestInBackground] continueWithBlock:^id(BFTask *task) {
+                    done();
+                    return nil;
+                }];
+            });
+            loopbackServer.errorRate = 0.5;
+
+            AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+                return [AGRestBenchmark runBenchmarkNamed:@"loopback, 50% errors, network else cache"
+                                               iterations:AGRestBenchmarkLoopbackIterations / 10
+                                              concurrency:16
+                                     requestsPerIteration:1
+                                                    block:^BFTask *(NSUInteger index) {
+                    AGRestRequest *request = AGRestBenchmarkRequest(baseUrl, @"payload/small", NO);
+                    request.cachePolicy = kAGRestRequestNetworkElseCache;
+                    return AGRestBenchmarkCheckResponse([request sendRequestInBackground]);
+                }];
+            });
+            expect(result.failures).to.equal(0);
+            expect(loopbackServer.faultCount).to.beGreaterThan(0);
+        });
+
+        it(@"sheds a failing endpoint", ^{
+            // One endpoint down, the other healthy, sharing the same operation slots.
+            // Incremented from the loopback delivery queues.
+            __block int32_t failingRequestCount = 0;
+            loopbackServer.latency = 0.005;
+            loopbackServer.responseBlock = ^AGRestResponse *(AGRestRequest *request, NSUInteger index) {
+                if (![request.endPoint isEqualToString:@"payload/down"]) {
+                    return nil;
+                }
+                OSAtomicIncrement32(&failingRequestCount);
+                NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorBadServerResponse userInfo:nil];
+                return [AGRestResponse responseWithError:error statusCode:503];
+            };
+            [AGRest setCircuitBreakerEnabled:YES failureThreshold:5 openInterval:60];
+            [[AGRest metrics] reset];
+
+            AGRestBenchmarkResult *result = AGRestBenchmarkRunInBackground(^{
+                return [AGRestBenchmark runBenchmarkNamed:@"loopback, 1 of 2 endpoints down, circuit breaker"
+                                               iterations:AGRestBenchmarkLoopbackIterations / 10
+                                              concurrency:64
+                                     requestsPerIteration:1
+                                                    block:^BFTask *(NSUInteger index) {
+                    if (index % 2) {
+                        return [AGRestBenchmarkRequest(baseUrl, @"payload/down", NO) sendRequestInBackground];
+                    }
+                    return AGRestBenchmarkCheckResponse([AGRestBenchmarkRequest(baseUrl, @"payload/empty", NO) sendRequestInBackground]);
+                }];
+            });
+            NSDictionary *snapshot = [AGRest metricsSnapshot];
+
+            [AGRest setCircuitBreakerEnabled:NO failureThreshold:0 openInterval:0];
+            [[AGRest circuitBreaker] reset];
+            loopbackServer.responseBlock = nil;
+
+            expect(result.failures).to.equal(0);
+            // Only the requests in flight when the circuit opened reached the failing endpoint.
+            expect(failingRequestCount).to.beLessThan(128);
+            expect([snapshot[AGRestMetricsCircuitBreakerRejectionCountKey] unsignedIntegerValue]).to.beGreaterThan(0);
+        });
+    });
+});
+
+}
+
+SpecEnd